@@ -0,0 +1,516 @@
+/**
+ * @file      DataGen.cpp
+ * @brief     规模测试用的合成数据生成器
+ * @details   按种子确定性地生成商品、用户、订单与历史订单（密码盐也由
+ *            种子派生，相同参数的输出逐字节相同），写成与
+ *            Database::initialize_tables 中表结构对应的制表符分隔文件，
+ *            并生成一份 LOAD DATA 脚本用 mysql 客户端批量导入。
+ *
+ *            用户下单次数与商品被购买次数都服从 Zipf 分布（少数用户和商品
+ *            占大部分订单）；商品名由中英文品牌、修饰词、品类与型号组成。
+ *
+ *            用法: data_gen [--out 目录] [--seed 种子] [--products 商品数]
+ *                           [--users 用户数] [--order-rows 订单行数]
+ *                           [--iterations 密码哈希迭代次数]
+ */
+
+#include "SecurityUtils.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+using clock_type = std::chrono::steady_clock;
+
+// --- 与表结构及业务约定保持一致的常量 ---
+
+static constexpr int STATUS_NORMAL = 0;       // users / products 正常
+static constexpr int STATUS_DELETED = -1;     // products 已删除
+static constexpr int ORDER_NOT_COMPLETED = 0; // 运输中
+static constexpr int ORDER_COMPLETED = 1;     // 已完成
+static constexpr int ORDER_CANCEL = -1;       // 已取消
+static const int DELIVERY_DAYS[] = {5, 3, 1}; // 与 OrderManager 相同
+
+// 生成的订单号从此值开始递增，远大于程序以 时间戳 + 用户 ID 生成的订单号，
+// 两者不会冲突；订单按时间顺序生成，订单号大小与下单时间一致
+static constexpr long long ORDER_ID_BASE = 1000000000000LL;
+
+// 订单时间分布在参考时间之前的一年内；参考时间固定，保证输出可复现
+static constexpr time_t REFERENCE_TIME = 1767225600; // 2026-01-01 00:00:00 UTC
+static constexpr time_t ORDER_WINDOW = 365 * 24 * 3600;
+
+// --- 名称素材 ---
+
+static const std::vector<std::string> BRANDS = {
+    "小米", "华为", "联想", "海尔", "美的", "格力", "李宁", "安踏", "得力",
+    "晨光", "百雀羚", "三只松鼠", "Apple", "Sony", "Nike", "Adidas",
+    "Logitech", "Philips", "Dell", "Canon", "Uniqlo", "Muji"};
+static const std::vector<std::string> ADJECTIVES = {
+    "经典", "轻薄", "无线", "智能", "便携", "复古", "加厚", "迷你", "旗舰",
+    "静音", "防水", "折叠", "Pro", "Max", "Lite", "Plus", "Ultra", "Air"};
+static const std::vector<std::string> CATEGORIES = {
+    "耳机", "键盘", "鼠标", "保温杯", "双肩包", "台灯", "雨伞", "T恤",
+    "运动鞋", "笔记本", "中性笔", "坚果礼盒", "面霜", "电饭煲", "空调扇",
+    "Phone", "Laptop", "Camera", "Watch", "Speaker", "Monitor"};
+static const std::vector<std::string> AREAS = {
+    "北京市朝阳区", "北京市海淀区", "上海市浦东新区", "上海市徐汇区",
+    "广州市天河区", "深圳市南山区", "杭州市西湖区", "成都市武侯区",
+    "武汉市江汉区", "西安市雁塔区", "南京市鼓楼区", "重庆市渝中区",
+    "长沙市岳麓区", "厦门市思明区"};
+static const std::vector<std::string> ROADS = {
+    "人民路", "建设路", "中山路", "解放路", "和平街", "学院路", "科技园路",
+    "滨江大道"};
+
+// 每个订单包含的商品种数 1~5 的权重（多数订单只有一两种商品）
+static const int ITEM_COUNT_WEIGHTS[] = {50, 25, 13, 8, 4};
+
+/**
+ * @brief 确定性随机数源
+ *
+ * 只使用 mt19937_64 的原始输出（其序列由标准规定），不使用实现相关的
+ * 分布类，保证相同种子在任何标准库实现下生成相同的数据。
+ */
+class Random {
+  private:
+    std::mt19937_64 engine;
+
+  public:
+    explicit Random(const uint64_t seed) : engine(seed) {}
+
+    // [0, n) 内的整数
+    uint64_t below(const uint64_t n) { return engine() % n; }
+
+    // [0, 1) 内的浮点数
+    double unit() { return (engine() >> 11) * 0x1.0p-53; }
+
+    template <typename T> const T &pick(const std::vector<T> &items) {
+        return items[below(items.size())];
+    }
+};
+
+/**
+ * @brief Zipf 分布采样：排名 k（从 1 开始）被选中的概率与 1/k^s 成正比
+ *
+ */
+class ZipfSampler {
+  private:
+    std::vector<double> cdf;
+
+  public:
+    ZipfSampler(const size_t n, const double s) : cdf(n) {
+        double sum = 0;
+        for (size_t k = 0; k < n; k++) {
+            sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+            cdf[k] = sum;
+        }
+        for (auto &c : cdf)
+            c /= sum;
+    }
+
+    // 返回排名（从 1 开始）
+    size_t sample(Random &rng) const {
+        auto it = std::upper_bound(cdf.begin(), cdf.end(), rng.unit());
+        return std::min<size_t>(it - cdf.begin(), cdf.size() - 1) + 1;
+    }
+};
+
+/**
+ * @brief 带缓冲的制表符分隔文件写入器
+ *
+ * 字段按 LOAD DATA 默认格式写出（制表符分隔、换行结尾），
+ * 生成的文本不含制表符、换行与反斜杠，无需转义。
+ */
+class TsvWriter {
+  private:
+    static constexpr size_t FLUSH_SIZE = 1 << 20;
+
+    std::FILE *file;
+    std::string buffer;
+    bool line_start = true;
+    size_t rows = 0;
+
+    void separator() {
+        if (!line_start)
+            buffer.push_back('\t');
+        line_start = false;
+    }
+
+  public:
+    explicit TsvWriter(const fs::path &path)
+        : file(std::fopen(path.c_str(), "wb")) {
+        buffer.reserve(FLUSH_SIZE + 4096);
+    }
+
+    ~TsvWriter() { close(); }
+
+    TsvWriter(const TsvWriter &) = delete;
+    TsvWriter &operator=(const TsvWriter &) = delete;
+
+    bool is_open() const { return file != nullptr; }
+
+    size_t row_count() const { return rows; }
+
+    TsvWriter &field(const std::string_view text) {
+        separator();
+        buffer.append(text);
+        return *this;
+    }
+
+    TsvWriter &field(const long long value) {
+        separator();
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return *this;
+    }
+
+    // 以分为单位的价格，写成两位小数
+    TsvWriter &price(const long long cents) {
+        field(cents / 100);
+        char fraction[4] = {'.', static_cast<char>('0' + cents % 100 / 10),
+                            static_cast<char>('0' + cents % 10), '\0'};
+        buffer.append(fraction);
+        return *this;
+    }
+
+    // UTC 时间，格式为 YYYY-MM-DD HH:MM:SS
+    TsvWriter &timestamp(const time_t time) {
+        std::tm tm{};
+        gmtime_r(&time, &tm);
+        char text[24];
+        std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+        return field(text);
+    }
+
+    void end_row() {
+        buffer.push_back('\n');
+        line_start = true;
+        rows++;
+        if (buffer.size() >= FLUSH_SIZE)
+            flush();
+    }
+
+    void flush() {
+        if (file && !buffer.empty())
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+
+    void close() {
+        flush();
+        if (file)
+            std::fclose(file);
+        file = nullptr;
+    }
+};
+
+// 生成的商品：订单与历史订单快照需要名称与价格
+struct GeneratedProduct {
+    std::string name;
+    long long price_cents;
+};
+
+// 生成参数
+struct Options {
+    fs::path out = "data/generated";
+    uint64_t seed = 42;
+    size_t products = 1000000;
+    size_t users = 100000;
+    size_t order_rows = 10000000;
+    int iterations = 1000;
+};
+
+static double seconds_since(const clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+static void report(const char *table, const size_t rows,
+                   const clock_type::time_point start) {
+    double elapsed = seconds_since(start);
+    std::printf("%-16s %10zu 行  %7.2f 秒  %10.0f 行/秒\n", table, rows,
+                elapsed, elapsed > 0 ? rows / elapsed : 0.0);
+}
+
+// 商品 ID 从 1 开始连续；型号由 ID 编码，保证商品名唯一（product_name UNIQUE）
+static std::vector<GeneratedProduct> write_products(const Options &options,
+                                                    Random &rng) {
+    auto start = clock_type::now();
+    TsvWriter out(options.out / "products.tsv");
+    std::vector<GeneratedProduct> products;
+    products.reserve(options.products);
+
+    for (size_t i = 0; i < options.products; i++) {
+        GeneratedProduct p;
+        p.name = rng.pick(BRANDS) + " " + rng.pick(ADJECTIVES) +
+                 rng.pick(CATEGORIES) + " " +
+                 static_cast<char>('A' + rng.below(26)) + std::to_string(i + 1);
+        // 价格 1~5000 元，低价商品更多
+        p.price_cents = 100 + static_cast<long long>(
+                                  std::pow(rng.unit(), 3) * 499900);
+
+        int stock = static_cast<int>(rng.below(1000));
+        int status = rng.below(50) == 0 ? STATUS_DELETED : STATUS_NORMAL;
+
+        out.field(static_cast<long long>(i + 1))
+            .field(p.name)
+            .price(p.price_cents)
+            .field(stock)
+            .field(status)
+            .end_row();
+        products.push_back(std::move(p));
+    }
+
+    report("products", out.row_count(), start);
+    return products;
+}
+
+// 由种子与用户 ID 派生密码盐，使哈希列与其他列一样可复现
+static std::vector<unsigned char> user_salt(const uint64_t seed,
+                                            const uint64_t user_id) {
+    Random rng(seed ^ (user_id * 0x9e3779b97f4a7c15ULL));
+    std::vector<unsigned char> salt(SecurityUtils::SALT_LENGTH);
+    for (auto &byte : salt)
+        byte = static_cast<unsigned char>(rng.below(256));
+    return salt;
+}
+
+// 用户 ID 从 1 开始连续，用户名 userNNNNNNN，密码 pwNNNNNNN（NNNNNNN 为 ID）；
+// 密码以较低迭代次数哈希，用户登录时会按当前配置自动重新哈希
+static void write_users(const Options &options) {
+    auto start = clock_type::now();
+    TsvWriter out(options.out / "users.tsv");
+
+    constexpr size_t BATCH = 10000;
+    for (size_t first = 0; first < options.users; first += BATCH) {
+        size_t last = std::min(first + BATCH, options.users);
+
+        std::vector<std::string> passwords;
+        std::vector<std::vector<unsigned char>> salts;
+        for (size_t i = first; i < last; i++) {
+            char password[16];
+            std::snprintf(password, sizeof(password), "pw%07zu", i + 1);
+            passwords.emplace_back(password);
+            salts.push_back(user_salt(options.seed, i + 1));
+        }
+        auto hashes = SecurityUtils::hash_passwords(passwords, salts,
+                                                    options.iterations);
+
+        for (size_t i = first; i < last; i++) {
+            char username[16];
+            std::snprintf(username, sizeof(username), "user%07zu", i + 1);
+            out.field(static_cast<long long>(i + 1))
+                .field(username)
+                .field(hashes[i - first])
+                .field(0)
+                .field(STATUS_NORMAL)
+                .end_row();
+        }
+    }
+
+    report("users", out.row_count(), start);
+}
+
+// 生成订单：按时间顺序逐个生成，下单用户与商品服从 Zipf 分布；
+// 每个订单项同时写入 orders 与 history_orders（与下单时的行为一致）
+static void write_orders(const Options &options,
+                         const std::vector<GeneratedProduct> &products,
+                         Random &rng) {
+    auto start = clock_type::now();
+    TsvWriter orders(options.out / "orders.tsv");
+    TsvWriter history(options.out / "history_orders.tsv");
+
+    ZipfSampler user_sampler(options.users, 1.1);
+    ZipfSampler product_sampler(products.size(), 1.0);
+
+    int weight_sum = 0;
+    double expected_items = 0;
+    for (int k = 0; k < 5; k++) {
+        weight_sum += ITEM_COUNT_WEIGHTS[k];
+        expected_items += (k + 1) * ITEM_COUNT_WEIGHTS[k];
+    }
+    expected_items /= weight_sum;
+
+    // 预计的订单数，用于把下单时间均匀铺满整个时间窗口
+    double expected_orders =
+        std::max(1.0, options.order_rows / expected_items);
+    time_t window_start = REFERENCE_TIME - ORDER_WINDOW;
+
+    size_t rows = 0;
+    for (long long k = 0; rows < options.order_rows; k++) {
+        long long order_id = ORDER_ID_BASE + k;
+        time_t order_time = window_start + static_cast<time_t>(std::min(
+                                               k / expected_orders, 1.0) *
+                                           (ORDER_WINDOW - 1));
+        long long user_id = user_sampler.sample(rng);
+        int delivery = static_cast<int>(rng.below(3));
+
+        std::string address = rng.pick(AREAS) + rng.pick(ROADS) +
+                              std::to_string(rng.below(999) + 1) + "号";
+
+        // 已过预计送达时间的订单已完成，其余运输中；少量订单被取消
+        int status = order_time + DELIVERY_DAYS[delivery] * 24 * 3600 <
+                             REFERENCE_TIME
+                         ? ORDER_COMPLETED
+                         : ORDER_NOT_COMPLETED;
+        if (rng.below(100) < 8)
+            status = ORDER_CANCEL;
+
+        int pick = static_cast<int>(rng.below(weight_sum));
+        int item_count = 1;
+        while (pick >= ITEM_COUNT_WEIGHTS[item_count - 1])
+            pick -= ITEM_COUNT_WEIGHTS[item_count++ - 1];
+
+        for (int i = 0; i < item_count && rows < options.order_rows; i++) {
+            size_t product_id = product_sampler.sample(rng);
+            const GeneratedProduct &product = products[product_id - 1];
+            long long count = rng.below(3) + 1;
+
+            orders.field(user_id)
+                .field(static_cast<long long>(product_id))
+                .field(order_id)
+                .field(count)
+                .timestamp(order_time)
+                .field(delivery)
+                .field(address)
+                .field(status)
+                .end_row();
+
+            history.field(user_id)
+                .field(product.name)
+                .price(product.price_cents)
+                .field(order_id)
+                .field(count)
+                .timestamp(order_time)
+                .field(delivery)
+                .field(address)
+                .field(status)
+                .end_row();
+            rows++;
+        }
+    }
+
+    report("orders", orders.row_count(), start);
+    report("history_orders", history.row_count(), start);
+}
+
+// 生成 LOAD DATA 脚本（时间按 UTC 写出，导入时会话时区设为 UTC）
+static bool write_load_script(const Options &options) {
+    fs::path dir = fs::absolute(options.out);
+    std::FILE *file = std::fopen((options.out / "load.sql").c_str(), "wb");
+    if (!file)
+        return false;
+
+    struct Table {
+        const char *name;
+        const char *file;
+        const char *columns;
+    };
+    const Table tables[] = {
+        {"users", "users.tsv", "id, username, password, is_admin, status"},
+        {"products", "products.tsv",
+         "product_id, product_name, price, stock, status"},
+        {"orders", "orders.tsv",
+         "user_id, product_id, order_id, count, order_time, "
+         "delivery_selection, address, status"},
+        {"history_orders", "history_orders.tsv",
+         "user_id, product_name, price, order_id, count, order_time, "
+         "delivery_selection, address, status"},
+    };
+
+    std::fprintf(file, "-- 由 data_gen 生成（种子 %llu），请导入空库\n"
+                       "SET time_zone = '+00:00';\n"
+                       "SET unique_checks = 0;\n\n",
+                 static_cast<unsigned long long>(options.seed));
+    for (const auto &t : tables) {
+        std::fprintf(file,
+                     "LOAD DATA LOCAL INFILE '%s' INTO TABLE %s\n"
+                     "  CHARACTER SET utf8mb4\n"
+                     "  FIELDS TERMINATED BY '\\t' LINES TERMINATED BY '\\n'\n"
+                     "  (%s);\n\n",
+                     (dir / t.file).c_str(), t.name, t.columns);
+    }
+    std::fprintf(file, "SET unique_checks = 1;\n");
+    std::fclose(file);
+    return true;
+}
+
+static bool parse_options(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view flag = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char *value = argv[++i];
+
+        if (flag == "--out")
+            options.out = value;
+        else if (flag == "--seed")
+            options.seed = std::strtoull(value, nullptr, 10);
+        else if (flag == "--products")
+            options.products = std::strtoull(value, nullptr, 10);
+        else if (flag == "--users")
+            options.users = std::strtoull(value, nullptr, 10);
+        else if (flag == "--order-rows")
+            options.order_rows = std::strtoull(value, nullptr, 10);
+        else if (flag == "--iterations")
+            options.iterations = std::atoi(value);
+        else
+            return false;
+    }
+    return options.products > 0 && options.users > 0 &&
+           options.users <= 9999999 && options.iterations > 0;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "用法: data_gen [--out 目录] [--seed 种子] "
+                     "[--products 商品数] [--users 用户数(<=9999999)]\n"
+                     "                [--order-rows 订单行数] "
+                     "[--iterations 密码哈希迭代次数]\n");
+        return -1;
+    }
+
+    // 创建输出目录并确认可写
+    std::error_code ec;
+    fs::create_directories(options.out, ec);
+    if (ec || !TsvWriter(options.out / "products.tsv").is_open()) {
+        std::fprintf(stderr, "无法写入输出目录 %s\n", options.out.c_str());
+        return -1;
+    }
+
+    std::printf("种子 %llu: %zu 个商品, %zu 个用户, %zu 行订单 -> %s\n\n",
+                static_cast<unsigned long long>(options.seed),
+                options.products, options.users, options.order_rows,
+                options.out.c_str());
+
+    // 各表使用独立的随机数流，调整一张表的规模不影响其他表的内容
+    auto start = clock_type::now();
+    Random product_rng(options.seed);
+    Random order_rng(options.seed + 1);
+
+    auto products = write_products(options, product_rng);
+    write_users(options);
+    write_orders(options, products, order_rng);
+
+    if (!write_load_script(options)) {
+        std::fprintf(stderr, "无法写入 load.sql\n");
+        return -1;
+    }
+
+    std::printf("\n共耗时 %.2f 秒，导入: mysql --local-infile=1 -u root -p "
+                "ShoppingApp < %s\n",
+                seconds_since(start), (options.out / "load.sql").c_str());
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file      HashBench.cpp
+ * @brief     密码哈希吞吐基准
+ * @details   按 1, 2, 4 ... 最大线程数依次运行 SecurityUtils::hash_password，
+ *            输出每秒哈希次数及相对单线程的加速比，用于评估 KDF 成本设置。
+ *
+ *            用法: hash_bench [迭代次数] [每轮秒数] [最大线程数]
+ *            迭代次数为 0 时先按 DEFAULT_TARGET_MS 校准。
+ */
+
+#include "SecurityUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+// 以 thread_count 个线程持续哈希 seconds 秒，返回完成的哈希次数
+static long long run_round(const int thread_count, const int iterations,
+                           const double seconds) {
+    std::atomic<bool> running{true};
+    std::atomic<long long> total{0};
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < thread_count; t++) {
+        workers.emplace_back([&] {
+            long long local = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                SecurityUtils::hash_password("benchmark-password", iterations);
+                local++;
+            }
+            total += local;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto &w : workers)
+        w.join();
+
+    return total.load();
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 0;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    int max_threads = argc > 3 ? std::atoi(argv[3])
+                               : static_cast<int>(std::max(
+                                     1u, std::thread::hardware_concurrency()));
+
+    if (iterations <= 0) {
+        iterations = SecurityUtils::calibrate_iterations(
+            std::chrono::milliseconds(SecurityUtils::DEFAULT_TARGET_MS));
+        std::printf("校准结果: %d 次迭代 ≈ %d ms/哈希\n", iterations,
+                    SecurityUtils::DEFAULT_TARGET_MS);
+    }
+
+    std::printf("迭代次数: %d, 每轮 %.1f 秒, 最大线程数: %d\n\n", iterations,
+                seconds, max_threads);
+    std::printf("%8s %12s %14s %10s\n", "threads", "hashes", "hashes/s",
+                "speedup");
+
+    double single_rate = 0;
+    std::vector<int> thread_counts;
+    for (int t = 1; t < max_threads; t *= 2)
+        thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    for (int threads : thread_counts) {
+        auto start = clock_type::now();
+        long long hashes = run_round(threads, iterations, seconds);
+        double elapsed =
+            std::chrono::duration<double>(clock_type::now() - start).count();
+
+        double rate = hashes / elapsed;
+        if (threads == 1)
+            single_rate = rate;
+
+        std::printf("%8d %12lld %14.1f %9.2fx\n", threads, hashes, rate,
+                    single_rate > 0 ? rate / single_rate : 0.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,548 @@
+/**
+ * @file      LoadGen.cpp
+ * @brief     模拟并发购物用户的压测工具
+ * @details   不经过界面，直接驱动各管理类：每个模拟用户占用一个线程和一份
+ *            独立的 DataStore，按给定比例循环执行浏览/搜索、加购、结算、
+ *            取消订单与查看历史订单，输出各操作的吞吐、延迟分位数与错误率。
+ *
+ *            加 --socket 时改为经由后台守护进程：每个模拟用户使用自己的
+ *            ShoppingClient 连接并登录，测量包含协议往返的端到端耗时。
+ *
+ *            用法: load_gen [--socket 路径] [用户数列表] [每轮秒数] [操作比例]
+ *                           [思考时间毫秒]
+ *            用户数列表如 1,4,16，每个用户数运行一轮以观察扩展性；
+ *            操作比例如 browse=50,cart=25,checkout=10,cancel=5,history=10。
+ *            直连数据库时需要环境变量 DB_PASSWORD；压测账号 loadgen_NNNN
+ *            不存在时自动创建。
+ */
+
+#include "DataStore.h"
+#include "Database.h"
+#include "Logger.h"
+#include "SecurityUtils.h"
+#include "ShoppingClient.h"
+#include "UserManager.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+// 模拟用户的操作类型
+enum Op { BROWSE, ADD_TO_CART, CHECKOUT, CANCEL, HISTORY, OP_COUNT };
+
+static const std::array<const char *, OP_COUNT> OP_NAMES = {
+    "browse", "cart", "checkout", "cancel", "history"};
+
+// 默认操作比例：以浏览为主，少量下单与取消
+static const std::array<double, OP_COUNT> DEFAULT_MIX = {50, 25, 10, 5, 10};
+
+// 压测账号的密码与直连时的哈希迭代次数（直连不登录，无需真实成本）
+static constexpr const char *ACCOUNT_PASSWORD = "loadgen";
+static constexpr int ACCOUNT_HASH_ITERATIONS = 1000;
+
+// 单个线程的统计，结束后合并
+struct OpStats {
+    // 每次操作的耗时（含出错的操作，不含跳过的操作）
+    std::array<std::vector<double>, OP_COUNT> latencies_ms;
+    std::array<long long, OP_COUNT> errors{};  // 抛出异常或记录了错误日志
+    std::array<long long, OP_COUNT> skipped{}; // 无可操作对象（如购物车为空）
+
+    void merge(const OpStats &other) {
+        for (int op = 0; op < OP_COUNT; op++) {
+            latencies_ms[op].insert(latencies_ms[op].end(),
+                                    other.latencies_ms[op].begin(),
+                                    other.latencies_ms[op].end());
+            errors[op] += other.errors[op];
+            skipped[op] += other.skipped[op];
+        }
+    }
+};
+
+// 解析 "browse=50,cart=25" 形式的操作比例，未列出的操作比例为 0
+static bool parse_mix(const std::string &text,
+                      std::array<double, OP_COUNT> &mix) {
+    mix.fill(0);
+    std::stringstream ss(text);
+    std::string entry;
+    while (std::getline(ss, entry, ',')) {
+        auto eq = entry.find('=');
+        if (eq == std::string::npos)
+            return false;
+        auto it = std::find(OP_NAMES.begin(), OP_NAMES.end(),
+                            entry.substr(0, eq));
+        if (it == OP_NAMES.end())
+            return false;
+        mix[it - OP_NAMES.begin()] = std::atof(entry.c_str() + eq + 1);
+    }
+    return std::any_of(mix.begin(), mix.end(), [](double w) { return w > 0; });
+}
+
+static std::string account_name(const int index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "loadgen_%04d", index);
+    return name;
+}
+
+// 查找或创建压测账号，返回用户 ID（失败返回 -1）
+static int ensure_account(UserManager &user_manager, const int index) {
+    std::string name = account_name(index);
+    auto user = user_manager.get_user_by_name(name);
+    if (!user.has_value()) {
+        user_manager.append_user(
+            User(name, SecurityUtils::hash_password(ACCOUNT_PASSWORD,
+                                                    ACCOUNT_HASH_ITERATIONS)));
+        user = user_manager.get_user_by_name(name);
+    }
+    return user.has_value() ? user->id : -1;
+}
+
+// 经由后台服务登录压测账号，不存在时先注册，返回用户 ID（失败返回 -1）
+static int ensure_account(ShoppingClient &client, const int index) {
+    std::string name = account_name(index);
+    if (client.check_login(name, ACCOUNT_PASSWORD) != Result::SUCCESS) {
+        std::string error_message;
+        client.check_register(name, ACCOUNT_PASSWORD, ACCOUNT_PASSWORD,
+                              error_message);
+        if (client.check_login(name, ACCOUNT_PASSWORD) != Result::SUCCESS)
+            return -1;
+    }
+    return client.get_current_user()->id;
+}
+
+// 各模拟用户共享的管理类（与 AppContext 相同，管理类本身可跨线程使用）
+struct Managers {
+    UserManager user_manager;
+    ProductManager product_manager;
+    CartManager cart_manager;
+    OrderManager order_manager;
+    HistoryOrderManager history_order_manager;
+};
+
+/**
+ * @brief 模拟用户：只在自己的线程中使用
+ *
+ */
+class Shopper {
+  public:
+    virtual ~Shopper() = default;
+
+    // 执行一次操作；无可操作对象时返回 false
+    virtual bool run(const Op op) = 0;
+};
+
+/**
+ * @brief 直接驱动管理类的模拟用户，持有独立的数据仓库
+ *
+ */
+class LocalShopper : public Shopper {
+  private:
+    int user_id;
+    DataStore store;
+    const std::vector<std::string> &keywords;
+    std::mt19937 rng;
+
+    // 最近一次浏览的结果，加购时从中挑选商品
+    ProductSearchResult last_result;
+
+    size_t random_index(const size_t size) {
+        return std::uniform_int_distribution<size_t>(0, size - 1)(rng);
+    }
+
+    void browse() {
+        // 四分之一浏览全部商品，其余按商品名搜索
+        std::string query =
+            random_index(4) == 0 ? "" : keywords[random_index(keywords.size())];
+        last_result = store.fetch_products(query);
+        store.apply_products(last_result);
+    }
+
+  public:
+    LocalShopper(Managers &m, const int user_id,
+                 const std::vector<std::string> &keywords, const unsigned seed)
+        : user_id(user_id),
+          store(m.product_manager, m.cart_manager, m.order_manager,
+                m.history_order_manager),
+          keywords(keywords), rng(seed) {}
+
+    bool run(const Op op) override {
+        switch (op) {
+        case BROWSE:
+            browse();
+            return true;
+
+        case ADD_TO_CART: {
+            if (last_result.empty())
+                browse();
+            if (last_result.empty())
+                return false;
+            const Product &p = last_result[random_index(last_result.size())];
+            store.add_to_cart(user_id, p.product_id, 1);
+            return true;
+        }
+
+        case CHECKOUT: {
+            auto load = store.fetch_cart(user_id, store.known_products());
+            store.apply_cart(load);
+            if (store.cart()->empty())
+                return false;
+
+            std::vector<CartItem> selected = *store.cart();
+            for (auto &item : selected)
+                item.delivery_selection = random_index(3);
+            store.checkout(user_id, selected, "压测地址");
+            return true;
+        }
+
+        case CANCEL: {
+            auto load = store.fetch_orders(user_id, store.known_products());
+            store.apply_orders(load);
+
+            std::vector<long long> open_orders;
+            for (const auto &[order_id, order] : *store.orders())
+                if (order.status == FullOrderStatus::NOT_COMPLETED)
+                    open_orders.push_back(order_id);
+            if (open_orders.empty())
+                return false;
+
+            store.cancel_order(open_orders[random_index(open_orders.size())]);
+            return true;
+        }
+
+        case HISTORY: {
+            auto history = store.fetch_history(user_id);
+            store.apply_history(history);
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+};
+
+/**
+ * @brief 经由后台服务的模拟用户：持有自己的连接，以对应的压测账号登录
+ *
+ */
+class RemoteShopper : public Shopper {
+  private:
+    ShoppingClient client;
+    int user_id = -1;
+    const std::vector<std::string> &keywords;
+    std::mt19937 rng;
+
+    ProductSearchResult last_result;
+
+    size_t random_index(const size_t size) {
+        return std::uniform_int_distribution<size_t>(0, size - 1)(rng);
+    }
+
+    void browse() {
+        std::string query =
+            random_index(4) == 0 ? "" : keywords[random_index(keywords.size())];
+        last_result = client.search_product(query);
+    }
+
+  public:
+    RemoteShopper(const std::string &socket_path, const int index,
+                  const std::vector<std::string> &keywords, const unsigned seed)
+        : keywords(keywords), rng(seed) {
+        if (client.connect(socket_path))
+            user_id = ensure_account(client, index);
+    }
+
+    bool run(const Op op) override {
+        if (user_id < 0)
+            throw std::runtime_error("未连接或登录后台服务");
+
+        switch (op) {
+        case BROWSE:
+            browse();
+            return true;
+
+        case ADD_TO_CART: {
+            if (last_result.empty())
+                browse();
+            if (last_result.empty())
+                return false;
+            const Product &p = last_result[random_index(last_result.size())];
+            client.add_item(user_id, p.product_id, 1);
+            return true;
+        }
+
+        case CHECKOUT: {
+            std::vector<CartItem> selected = client.fetch_cart(user_id);
+            if (selected.empty())
+                return false;
+            for (auto &item : selected)
+                item.delivery_selection = random_index(3);
+            client.purchase(user_id, selected, "压测地址");
+            return true;
+        }
+
+        case CANCEL: {
+            std::vector<long long> open_orders;
+            for (const auto &[order_id, order] :
+                 client.fetch_full_orders(user_id))
+                if (order.status == FullOrderStatus::NOT_COMPLETED)
+                    open_orders.push_back(order_id);
+            if (open_orders.empty())
+                return false;
+
+            long long order_id = open_orders[random_index(open_orders.size())];
+            if (client.cancel_order(order_id))
+                client.cancel_history_order(order_id);
+            return true;
+        }
+
+        case HISTORY:
+            client.fetch_history_orders(user_id);
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+// 为第 t 个线程创建模拟用户（在该线程中调用）
+using ShopperFactory = std::function<std::unique_ptr<Shopper>(const size_t)>;
+
+// 以 user_count 个模拟用户运行 seconds 秒，返回合并后的统计
+static OpStats run_round(const ShopperFactory &make_shopper,
+                         const size_t user_count,
+                         const std::array<double, OP_COUNT> &mix,
+                         const double seconds, const int think_ms) {
+    std::atomic<bool> running{true};
+    std::vector<OpStats> stats(user_count);
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < user_count; t++) {
+        workers.emplace_back([&, t] {
+            auto shopper = make_shopper(t);
+            std::mt19937 rng(static_cast<unsigned>(t));
+            std::discrete_distribution<int> pick(mix.begin(), mix.end());
+            OpStats &local = stats[t];
+
+            while (running.load(std::memory_order_relaxed)) {
+                Op op = static_cast<Op>(pick(rng));
+
+                // 管理类把数据库错误记入日志而不抛出，按本线程错误日志数判断
+                uint64_t errors_before = Logger::thread_error_count();
+                bool failed = false;
+                bool done = false;
+                auto start = clock_type::now();
+                try {
+                    done = shopper->run(op);
+                } catch (const std::exception &) {
+                    failed = true;
+                }
+                double elapsed_ms = std::chrono::duration<double, std::milli>(
+                                        clock_type::now() - start)
+                                        .count();
+                if (Logger::thread_error_count() != errors_before)
+                    failed = true;
+
+                if (!done && !failed) {
+                    local.skipped[op]++;
+                } else {
+                    local.latencies_ms[op].push_back(elapsed_ms);
+                    if (failed)
+                        local.errors[op]++;
+                }
+
+                if (think_ms > 0)
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(think_ms));
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto &w : workers)
+        w.join();
+
+    OpStats total;
+    for (const auto &s : stats)
+        total.merge(s);
+    return total;
+}
+
+// 已排序样本的分位数
+static double percentile(const std::vector<double> &sorted, const double p) {
+    if (sorted.empty())
+        return 0;
+    size_t index = static_cast<size_t>(p * sorted.size());
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void print_report(OpStats &stats, const double elapsed) {
+    std::printf("%-10s %9s %10s %9s %9s %9s %9s %8s %7s %8s\n", "op", "count",
+                "ops/s", "p50(ms)", "p90(ms)", "p99(ms)", "max(ms)", "errors",
+                "err%", "skipped");
+
+    long long total_count = 0, total_errors = 0;
+    for (int op = 0; op < OP_COUNT; op++) {
+        auto &samples = stats.latencies_ms[op];
+        std::sort(samples.begin(), samples.end());
+
+        long long count = samples.size();
+        total_count += count;
+        total_errors += stats.errors[op];
+
+        std::printf("%-10s %9lld %10.1f %9.2f %9.2f %9.2f %9.2f %8lld %6.2f%% "
+                    "%8lld\n",
+                    OP_NAMES[op], count, count / elapsed,
+                    percentile(samples, 0.50), percentile(samples, 0.90),
+                    percentile(samples, 0.99),
+                    samples.empty() ? 0.0 : samples.back(), stats.errors[op],
+                    count ? 100.0 * stats.errors[op] / count : 0.0,
+                    stats.skipped[op]);
+    }
+
+    std::printf("%-10s %9lld %10.1f %49lld %6.2f%%\n\n", "total", total_count,
+                total_count / elapsed, total_errors,
+                total_count ? 100.0 * total_errors / total_count : 0.0);
+}
+
+int main(int argc, char **argv) {
+    // --socket 可以出现在任意位置，其余为位置参数
+    std::string socket_path;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--socket" && i + 1 < argc)
+            socket_path = argv[++i];
+        else
+            args.emplace_back(argv[i]);
+    }
+
+    std::vector<int> user_counts;
+    std::stringstream counts(args.size() > 0 ? args[0] : "1,4,16");
+    for (std::string n; std::getline(counts, n, ',');)
+        if (std::atoi(n.c_str()) > 0)
+            user_counts.push_back(std::atoi(n.c_str()));
+    double seconds = args.size() > 1 ? std::atof(args[1].c_str()) : 10.0;
+    int think_ms = args.size() > 3 ? std::atoi(args[3].c_str()) : 0;
+
+    std::array<double, OP_COUNT> mix = DEFAULT_MIX;
+    if (args.size() > 2 && !parse_mix(args[2], mix)) {
+        std::fprintf(stderr,
+                     "操作比例格式错误，例如 "
+                     "browse=50,cart=25,checkout=10,cancel=5,history=10\n");
+        return -1;
+    }
+    if (user_counts.empty() || seconds <= 0) {
+        std::fprintf(stderr, "用法: load_gen [--socket 路径] [用户数列表] "
+                             "[每轮秒数] [操作比例] [思考时间毫秒]\n");
+        return -1;
+    }
+
+    // 压测期间的错误只计数，不刷屏
+    Logger::get_instance().set_console_output(false);
+
+    int max_users = *std::max_element(user_counts.begin(), user_counts.end());
+    std::vector<std::string> keywords;
+    std::unique_ptr<Managers> managers;
+    std::vector<int> user_ids;
+    ShopperFactory make_shopper;
+
+    if (!socket_path.empty()) {
+        ShoppingClient client;
+        if (!client.connect(socket_path)) {
+            std::fprintf(stderr, "无法连接后台服务 %s\n", socket_path.c_str());
+            return -1;
+        }
+
+        // 预先注册并登录一次压测账号，注册与首次登录的哈希不计入压测
+        for (int i = 0; i < max_users; i++) {
+            if (ensure_account(client, i) < 0) {
+                std::fprintf(stderr, "无法登录压测账号 loadgen_%04d\n", i);
+                return -1;
+            }
+        }
+
+        // 搜索关键词取自在售商品的第一页
+        auto page =
+            client.search_product_async("", false, 0, Rpc::MAX_SEARCH_LIMIT)
+                .get();
+        for (size_t i = 0; i < page.result.size(); i++)
+            keywords.emplace_back(page.result[i].product_name);
+
+        make_shopper = [&](const size_t t) -> std::unique_ptr<Shopper> {
+            return std::make_unique<RemoteShopper>(
+                socket_path, static_cast<int>(t), keywords,
+                static_cast<unsigned>(t * 7919 + 17));
+        };
+    } else {
+        DbConfig config;
+        const char *db_pass = std::getenv("DB_PASSWORD");
+        if (!db_pass) {
+            std::fprintf(stderr, "未找到环境变量 DB_PASSWORD\n");
+            return -1;
+        }
+        config.password = db_pass;
+        config.database = "ShoppingApp";
+        if (!Database::connect(config)) {
+            std::fprintf(stderr, "无法连接到数据库\n");
+            return -1;
+        }
+
+        managers = std::make_unique<Managers>();
+
+        // 搜索关键词取自当前在售商品名
+        for (const auto &p : managers->product_manager.get_catalog()->products)
+            if (p.status == ProductStatus::NORMAL)
+                keywords.emplace_back(p.product_name);
+
+        for (int i = 0; i < max_users; i++) {
+            int id = ensure_account(managers->user_manager, i);
+            if (id < 0) {
+                std::fprintf(stderr, "无法创建压测账号 loadgen_%04d\n", i);
+                return -1;
+            }
+            user_ids.push_back(id);
+        }
+
+        make_shopper = [&](const size_t t) -> std::unique_ptr<Shopper> {
+            return std::make_unique<LocalShopper>(
+                *managers, user_ids[t], keywords,
+                static_cast<unsigned>(t * 7919 + 17));
+        };
+    }
+    if (keywords.empty()) {
+        std::fprintf(stderr, "没有在售商品，请先导入商品\n");
+        return -1;
+    }
+
+    std::printf("商品 %zu 个, 每轮 %.1f 秒, 思考时间 %d ms, 操作比例:",
+                keywords.size(), seconds, think_ms);
+    for (int op = 0; op < OP_COUNT; op++)
+        std::printf(" %s=%g", OP_NAMES[op], mix[op]);
+    std::printf("\n\n");
+
+    for (int users : user_counts) {
+        std::printf("== %d 个并发用户 ==\n", users);
+
+        auto start = clock_type::now();
+        auto stats = run_round(make_shopper, users, mix, seconds, think_ms);
+        double elapsed =
+            std::chrono::duration<double>(clock_type::now() - start).count();
+        print_report(stats, elapsed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file      RpcCodecCheck.cpp
+ * @brief     后台服务协议编解码的往返检查
+ * @details   检查 varint / svarint / f64 / str 的边界值，以及 Codec.h 中每对
+ *            encode / decode：编码、解码后再编码，两次编码的字节必须相同，
+ *            且解码恰好读完负载；截断的负载必须抛出 WireError。
+ *            各字段使用互不相同的取值，字段顺序错位也会被发现。
+ *
+ *            用法: rpc_codec_check
+ *            全部通过时退出码为 0，否则输出失败项并返回 1。
+ */
+
+#include "Codec.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace Rpc;
+
+static int failures = 0;
+
+static void check(const bool ok, const std::string &what) {
+    if (!ok) {
+        failures++;
+        std::printf("FAIL %s\n", what.c_str());
+    }
+}
+
+// 编码 -> 解码 -> 再编码，比较两次编码的字节，并检查截断时报错
+template <typename T> static void round_trip(const char *name, const T &value) {
+    WireWriter first;
+    encode(first, value);
+
+    T decoded{};
+    WireReader reader(first.data());
+    try {
+        decode(reader, decoded);
+    } catch (const WireError &e) {
+        check(false, std::string(name) + ": 解码失败: " + e.what());
+        return;
+    }
+    check(reader.at_end(), std::string(name) + ": 解码后有剩余字节");
+
+    WireWriter second;
+    encode(second, decoded);
+    check(first.data() == second.data(), std::string(name) + ": 往返不一致");
+
+    if (first.size() > 0) {
+        bool threw = false;
+        try {
+            T partial{};
+            WireReader truncated(
+                std::string_view(first.data()).substr(0, first.size() - 1));
+            decode(truncated, partial);
+        } catch (const WireError &) {
+            threw = true;
+        }
+        check(threw, std::string(name) + ": 截断的负载没有报错");
+    }
+}
+
+static void check_scalars() {
+    const uint64_t unsigned_values[] = {
+        0, 1, 127, 128, 255, 16383, 16384, (1ull << 32) - 1, 1ull << 32,
+        std::numeric_limits<uint64_t>::max()};
+    for (uint64_t v : unsigned_values) {
+        WireWriter out;
+        out.varint(v);
+        WireReader in(out.data());
+        check(in.varint() == v && in.at_end(),
+              "varint " + std::to_string(v));
+    }
+
+    const int64_t signed_values[] = {0,
+                                     1,
+                                     -1,
+                                     63,
+                                     -64,
+                                     64,
+                                     -65,
+                                     std::numeric_limits<int32_t>::min(),
+                                     std::numeric_limits<int32_t>::max(),
+                                     std::numeric_limits<int64_t>::min(),
+                                     std::numeric_limits<int64_t>::max()};
+    for (int64_t v : signed_values) {
+        WireWriter out;
+        out.svarint(v);
+        WireReader in(out.data());
+        check(in.svarint() == v && in.at_end(),
+              "svarint " + std::to_string(v));
+    }
+
+    // zigzag 使小的负数也只占一个字节
+    WireWriter small;
+    small.svarint(-64);
+    check(small.size() == 1, "svarint -64 应只占 1 字节");
+
+    const double doubles[] = {0.0, -0.0, 0.1, -1234.5678,
+                              std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::denorm_min()};
+    for (double v : doubles) {
+        WireWriter out;
+        out.f64(v);
+        WireReader in(out.data());
+        double back = in.f64();
+        check(std::memcmp(&back, &v, sizeof(v)) == 0 && in.at_end(),
+              "f64 " + std::to_string(v));
+    }
+
+    const std::string texts[] = {"", "a", "中文商品名", std::string(300, 'x'),
+                                 std::string("\0nul", 4)};
+    for (const auto &text : texts) {
+        WireWriter out;
+        out.str(text);
+        WireReader in(out.data());
+        check(in.str() == text && in.at_end(),
+              "str（长度 " + std::to_string(text.size()) + "）");
+    }
+
+    // 超过 10 字节的 varint 与超出剩余字节数的数组长度都应报错
+    bool threw = false;
+    try {
+        std::string overlong(11, '\xFF');
+        WireReader in(overlong);
+        in.varint();
+    } catch (const WireError &) {
+        threw = true;
+    }
+    check(threw, "过长的 varint 没有报错");
+
+    threw = false;
+    try {
+        WireWriter out;
+        out.varint(5);
+        WireReader in(out.data());
+        in.count();
+    } catch (const WireError &) {
+        threw = true;
+    }
+    check(threw, "越界的数组长度没有报错");
+}
+
+static void check_models() {
+    Product product("测试商品 Pro", 199.5, 42, 7, ProductStatus::DELETED);
+    round_trip("Product", product);
+
+    CartItem cart_item(3, 7, 2, CartItemStatus::DELETED, 1);
+    round_trip("CartItem", cart_item);
+
+    OrderItem order_item(3, 7, 2, 1700000000, 2, "上海市",
+                         FullOrderStatus::CANCEL);
+    round_trip("OrderItem", order_item);
+
+    FullOrder order;
+    order.order_id = order_item.order_id;
+    order.total_price = 405.25;
+    order.order_time = 1700000001;
+    order.items = {order_item, OrderItem(3, 8, 5, 1700000000, 2, "上海市",
+                                         FullOrderStatus::CANCEL)};
+    order.address = "上海市";
+    order.status = FullOrderStatus::COMPLETED;
+    round_trip("FullOrder", order);
+
+    HistoryOrderItem history_item(3, "历史商品", 88.8, 4, 1700000002, 1,
+                                  "北京市", FullOrderStatus::COMPLETED);
+    round_trip("HistoryOrderItem", history_item);
+
+    HistoryFullOrder history;
+    history.order_id = history_item.order_id;
+    history.total_price = 358.2;
+    history.order_time = 1700000003;
+    history.items = {history_item};
+    history.address = "北京市";
+    history.status = FullOrderStatus::CANCEL;
+    round_trip("HistoryFullOrder", history);
+
+    round_trip("User", User("alice", "", true, 9, UserStatus::DELETED));
+
+    ProductPageQuery query;
+    query.sort_key = ProductSortKey::PRICE;
+    query.descending = true;
+    query.status = ProductStatusFilter::ALL;
+    query.page_size = 37;
+    round_trip("ProductPageQuery", query);
+
+    round_trip("ProductPageCursor（起始）", ProductPageCursor{});
+    ProductPageCursor cursor;
+    cursor.at_start = false;
+    cursor.last = product;
+    round_trip("ProductPageCursor", cursor);
+
+    ProductPage page;
+    page.products = {product, Product("另一个商品", 1.25, 0, 11)};
+    page.next_cursor = cursor;
+    page.has_more = true;
+    round_trip("ProductPage", page);
+
+    round_trip("std::vector<CartItem>（空）", std::vector<CartItem>{});
+    round_trip("std::map<long long, FullOrder>",
+               std::map<long long, FullOrder>{{order.order_id, order}});
+    round_trip("std::map<long long, HistoryFullOrder>",
+               std::map<long long, HistoryFullOrder>{
+                   {history.order_id, history}});
+    round_trip("std::optional<Product>", std::optional<Product>(product));
+    round_trip("std::optional<Product>（空）", std::optional<Product>());
+}
+
+int main() {
+    check_scalars();
+    check_models();
+
+    if (failures > 0) {
+        std::printf("%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部编解码检查通过\n");
+    return 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file      ShoppingBench.cpp
+ * @brief     模型层与工具函数热点路径的微基准
+ * @details   基于 Google Benchmark，覆盖不同目录规模下的商品搜索（缓存命中 /
+ *            未命中）、订单聚合、密码哈希与校验、多线程竞争下的日志写入，
+ *            以及价格、时间格式化。模型层用例使用进程内生成的确定性数据，
+ *            不连接数据库，不同提交、不同 Linux 机器上的结果可以直接比较。
+ *
+ *            用法: shopping_bench [--benchmark_filter=正则] [其他 Google
+ *            Benchmark 参数]
+ */
+
+#include "Logger.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include "SecurityUtils.h"
+#include "Utils.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- 确定性数据 ---
+// 只使用 mt19937 的原始输出（其序列由标准规定），不使用实现相关的分布类，
+// 保证任何标准库实现生成的数据都相同
+
+static constexpr uint32_t FIXTURE_SEED = 20251219;
+
+static const std::vector<std::string> ADJECTIVES = {
+    "经典", "轻薄", "无线", "智能", "便携", "复古", "加厚", "迷你"};
+static const std::vector<std::string> NOUNS = {
+    "耳机", "键盘", "鼠标", "水杯", "背包", "台灯", "雨伞", "T恤",
+    "Phone", "Laptop", "Camera", "Watch"};
+
+// 生成 count 个商品：ID 从 1 开始连续，每 20 个商品中有 1 个已删除
+static std::vector<Product> make_products(const size_t count) {
+    std::mt19937 rng(FIXTURE_SEED);
+    std::vector<Product> products;
+    products.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        std::string name = ADJECTIVES[rng() % ADJECTIVES.size()] +
+                           NOUNS[rng() % NOUNS.size()] + "-" +
+                           std::to_string(rng() % 10000);
+        double price = (rng() % 100000) / 100.0;
+        int stock = rng() % 500;
+        ProductStatus status =
+            i % 20 == 19 ? ProductStatus::DELETED : ProductStatus::NORMAL;
+        products.emplace_back(name, price, stock, static_cast<int>(i + 1),
+                              status);
+    }
+    return products;
+}
+
+// 生成 count 个订单项：平均每 4 项一个订单，商品 ID 取自 [1, product_count]
+static std::vector<OrderItem> make_order_items(const size_t count,
+                                               const size_t product_count) {
+    std::mt19937 rng(FIXTURE_SEED + 1);
+    std::vector<OrderItem> items;
+    items.reserve(count);
+
+    const time_t base_time = 1766000000;
+    long long order_id = 0;
+    int delivery_selection = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0 || rng() % 4 == 0) {
+            order_id = base_time + static_cast<long long>(i);
+            delivery_selection = rng() % 3;
+        }
+
+        OrderItem item(1, static_cast<int>(rng() % product_count + 1),
+                       static_cast<int>(rng() % 5 + 1), base_time,
+                       delivery_selection, "北京市海淀区",
+                       FullOrderStatus::NOT_COMPLETED);
+        item.order_id = order_id;
+        items.push_back(item);
+    }
+    return items;
+}
+
+// 目录规模：1 千、1 万、10 万个商品
+#define CATALOG_SIZES Arg(1000)->Arg(10000)->Arg(100000)
+
+// --- 商品搜索 ---
+
+// 重复同一搜索词：除第一次外全部命中搜索缓存
+static void BM_SearchProduct_CacheHit(benchmark::State &state) {
+    ProductManager product_manager;
+    product_manager.publish_catalog(make_products(state.range(0)));
+    product_manager.search_product("耳机");
+
+    for (auto _ : state) {
+        auto result = product_manager.search_product("耳机");
+        benchmark::DoNotOptimize(result.size());
+    }
+}
+BENCHMARK(BM_SearchProduct_CacheHit)->CATALOG_SIZES;
+
+// 轮流使用多于缓存容量的不同搜索词：每次都扫描整个目录
+static void BM_SearchProduct_CacheMiss(benchmark::State &state) {
+    ProductManager product_manager;
+    product_manager.publish_catalog(make_products(state.range(0)));
+
+    std::vector<std::string> queries;
+    for (size_t k = 0; k < 256; k++)
+        queries.push_back(NOUNS[k % NOUNS.size()] + "-" + std::to_string(k));
+
+    size_t next = 0;
+    for (auto _ : state) {
+        auto result = product_manager.search_product(queries[next]);
+        benchmark::DoNotOptimize(result.size());
+        next = (next + 1) % queries.size();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SearchProduct_CacheMiss)
+    ->CATALOG_SIZES->Unit(benchmark::kMicrosecond);
+
+// --- 订单聚合 ---
+
+// 把 range(0) 个订单项聚合为完整订单，单价从内存目录中查询
+static void BM_AggregateOrders(benchmark::State &state) {
+    const size_t product_count = 1000;
+    Catalog catalog(make_products(product_count), 1);
+    auto items = make_order_items(state.range(0), product_count);
+    auto price_of = [&catalog](const int product_id) {
+        const Product *p = catalog.find(product_id);
+        return p ? p->price : 0.0;
+    };
+
+    for (auto _ : state) {
+        auto orders = OrderManager::aggregate_orders(items, price_of);
+        benchmark::DoNotOptimize(orders.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AggregateOrders)->Arg(100)->Arg(1000)->Arg(10000);
+
+// --- 密码哈希 ---
+// 使用固定迭代次数而不是本机校准值，保证不同机器上的工作量相同
+
+static void BM_HashPassword(benchmark::State &state) {
+    for (auto _ : state) {
+        auto hash = SecurityUtils::hash_password("benchmark-password",
+                                                 state.range(0));
+        benchmark::DoNotOptimize(hash);
+    }
+}
+BENCHMARK(BM_HashPassword)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_CheckPassword(benchmark::State &state) {
+    std::string stored =
+        SecurityUtils::hash_password("benchmark-password", state.range(0));
+
+    for (auto _ : state) {
+        bool ok = SecurityUtils::check_password("benchmark-password", stored);
+        benchmark::DoNotOptimize(ok);
+    }
+}
+BENCHMARK(BM_CheckPassword)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// --- 日志 ---
+
+// 多个线程同时写日志，测量全局互斥锁下的吞吐（输出写到 /dev/null）
+static void BM_LoggerContention(benchmark::State &state) {
+    auto &logger = Logger::get_instance();
+    const std::string message =
+        "benchmark thread " + std::to_string(state.thread_index());
+
+    for (auto _ : state)
+        logger.log(LogLevel::INFO, message, __FILE__, __LINE__);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerContention)->ThreadRange(1, 8)->UseRealTime();
+
+// --- 格式化 ---
+
+static void BM_FormatPrice(benchmark::State &state) {
+    double price = 0.01;
+    for (auto _ : state) {
+        auto text = Utils::format_price(price);
+        benchmark::DoNotOptimize(text);
+        price += 1.37;
+    }
+}
+BENCHMARK(BM_FormatPrice);
+
+static void BM_TimeToString(benchmark::State &state) {
+    time_t time = 1766000000;
+    for (auto _ : state) {
+        auto text = Utils::time_to_string(time);
+        benchmark::DoNotOptimize(text);
+        time += 61;
+    }
+}
+BENCHMARK(BM_TimeToString);
+
+int main(int argc, char **argv) {
+    // 日志只测量格式化与加锁的开销，不输出到终端或项目日志文件
+    auto &logger = Logger::get_instance();
+    logger.set_level(LogLevel::DEBUG);
+    logger.set_console_output(false);
+    logger.set_log_file("/dev/null");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "Logger.h"
+#include "MetricsServer.h"
+#include "Protocol.h"
+#include "RpcServer.h"
+#include "ShoppingService.h"
+#include "Startup.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <pthread.h>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using std::string;
+using std::string_view;
+
+// 用法: shopping_daemon [--socket <路径>] [--workers <工作线程数>]
+//                        [--metrics-port <端口>]
+int main(int argc, char *argv[]) {
+    string socket_path = Rpc::DEFAULT_SOCKET_PATH;
+    unsigned int workers = 4;
+    int metrics_port = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (string_view(argv[i]) == "--socket") {
+            socket_path = argv[i + 1];
+        } else if (string_view(argv[i]) == "--workers") {
+            workers = static_cast<unsigned int>(std::atoi(argv[i + 1]));
+        } else if (string_view(argv[i]) == "--metrics-port") {
+            metrics_port = std::atoi(argv[i + 1]);
+        } else {
+            std::cerr << "用法: " << argv[0]
+                      << " [--socket <路径>] [--workers <工作线程数>]"
+                         " [--metrics-port <端口>]"
+                      << std::endl;
+            return -1;
+        }
+    }
+
+    // 配置日志系统
+    auto &logger = Logger::get_instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_log_file(string(DATA_PATH) + "/shopping_daemon.log");
+    logger.set_console_output(true);
+    logger.set_file_output(true);
+
+    LOG_INFO("Shopping 后台服务启动中...");
+
+    // 与 shopping_app 相同的密码哈希成本与数据库配置
+    Startup::configure_kdf_from_env();
+    if (!Startup::connect_database_from_env())
+        return -1;
+
+    // 在创建任何线程之前屏蔽退出信号，由专门的线程同步等待
+    sigset_t signals = Startup::block_exit_signals();
+
+    // 设置 TRACE_FILE 时记录调用追踪，退出时以 Chrome 追踪事件格式写入该文件
+    auto trace_file = Startup::enable_trace_from_env();
+
+    ShoppingService service;
+    RpcServer server(service, workers);
+    if (!server.start(socket_path))
+        return -1;
+
+    // 在 127.0.0.1 上导出 Prometheus 格式的指标
+    MetricsServer metrics_server;
+    if (metrics_port > 0) {
+        if (metrics_server.start(metrics_port))
+            LOG_INFO("指标导出: http://127.0.0.1:" +
+                     std::to_string(metrics_port) + "/metrics");
+        else
+            LOG_ERROR("无法在端口 " + std::to_string(metrics_port) +
+                      " 上导出指标");
+    }
+
+    std::thread signal_thread([&] {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        LOG_INFO("收到信号 " + std::to_string(signal) + "，正在停止后台服务");
+        server.stop();
+    });
+
+    server.run();
+
+    // run 也可能因监听失败而返回，此时给信号线程发一个信号让它退出
+    pthread_kill(signal_thread.native_handle(), SIGTERM);
+    signal_thread.join();
+
+    if (trace_file)
+        Startup::write_trace(*trace_file);
+
+    Startup::log_cache_stats("商品搜索", service.get_search_cache_stats());
+    return 0;
+}
@@ -1,20 +1,73 @@
 #include "Database.h"
+#include "Metrics.h"
+#include <cctype>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
 
 std::unique_ptr<mysqlx::Session> Database::session = nullptr;
-bool Database::is_connected_flag = false;
+std::atomic<bool> Database::is_connected_flag{false};
 bool Database::is_tables_initialized = false;
 std::mutex Database::mutex;
+DbConfig Database::connection_config;
+std::thread::id Database::owner_thread;
+std::atomic<unsigned int> Database::connection_epoch{0};
+
+// 当前线程执行的 SQL 语句数
+static thread_local uint64_t thread_statements = 0;
+
+namespace {
+
+// 建立会话的次数与耗时（主会话与各线程的会话）
+void record_session_open(const std::chrono::nanoseconds elapsed,
+                         const bool failed) {
+    static auto &opened = Metrics::Registry::get_instance().counter(
+        "shopping_db_sessions_opened_total", "已建立的数据库会话数");
+    static auto &errors = Metrics::Registry::get_instance().counter(
+        "shopping_db_session_errors_total", "建立数据库会话失败的次数");
+    static auto &seconds = Metrics::Registry::get_instance().histogram(
+        "shopping_db_session_open_seconds", "建立数据库会话的耗时");
+    if (failed) {
+        errors.inc();
+        return;
+    }
+    opened.inc();
+    seconds.observe(elapsed);
+}
+
+// 一种语句的耗时直方图与失败计数
+struct StatementMetrics {
+    Metrics::Histogram &seconds;
+    Metrics::Counter &errors;
+};
+
+StatementMetrics statement_metrics(const char *op) {
+    auto &registry = Metrics::Registry::get_instance();
+    return {registry.histogram("shopping_db_statement_seconds",
+                               "SQL 语句的执行耗时", {{"op", op}}),
+            registry.counter("shopping_db_statement_errors_total",
+                             "执行失败的 SQL 语句数", {{"op", op}})};
+}
+
+} // namespace
 
 bool Database::connect(const DbConfig &config) {
     try {
         if (is_connected())
             return true;
 
+        auto start = std::chrono::steady_clock::now();
         session = std::make_unique<mysqlx::Session>(
             config.host, config.port, config.user, config.password,
             config.database);
+        record_session_open(std::chrono::steady_clock::now() - start, false);
 
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            connection_config = config;
+        }
+        owner_thread = std::this_thread::get_id();
+        connection_epoch++;
         is_connected_flag = true;
 
         initialize_tables();
@@ -22,22 +75,51 @@ bool Database::connect(const DbConfig &config) {
         LOG_INFO("数据库初始化并链接成功");
         return true;
     } catch (const mysqlx::Error &e) {
+        record_session_open({}, true);
         LOG_ERROR("MySQL 连接失败: " + std::string(e.what()));
         return false;
     }
 }
 
 mysqlx::Session& Database::get_session() {
-    if (!is_connected_flag || !session) {
+    if (!is_connected_flag) {
         throw std::runtime_error("数据库未连接，请先调用 connect()");
     }
-    return *session;
+    if (std::this_thread::get_id() == owner_thread)
+        return *session;
+
+    // 其他线程：按需建立线程局部会话，重新连接后重建
+    thread_local std::unique_ptr<mysqlx::Session> local_session;
+    thread_local unsigned int local_epoch = 0;
+
+    unsigned int epoch = connection_epoch.load();
+    if (!local_session || local_epoch != epoch) {
+        DbConfig config;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            config = connection_config;
+        }
+        local_session.reset();
+        auto start = std::chrono::steady_clock::now();
+        try {
+            local_session = std::make_unique<mysqlx::Session>(
+                config.host, config.port, config.user, config.password,
+                config.database);
+        } catch (const mysqlx::Error &) {
+            record_session_open({}, true);
+            throw;
+        }
+        record_session_open(std::chrono::steady_clock::now() - start, false);
+        local_epoch = epoch;
+    }
+    return *local_session;
 }
 
-bool Database::is_connected() { return is_connected_flag && session != nullptr; }
+bool Database::is_connected() { return is_connected_flag; }
 
 void Database::close() {
     std::lock_guard<std::mutex> lock(mutex);
+    is_connected_flag = false;
     if (session) {
         session.reset();
     }
@@ -51,15 +133,85 @@ bool Database::execute(const std::string &query) {
         LOG_ERROR("数据库未连接，无法执行语句。");
         return false;
     }
+    Trace::Span span("sql", "SQL");
+    annotate_span(span, query);
+    auto start = std::chrono::steady_clock::now();
     try {
-        session->sql(query).execute();
+        get_session().sql(query).execute();
+        record_statement("execute", std::chrono::steady_clock::now() - start,
+                         false);
         return true;
     } catch (const mysqlx::Error &e) {
+        record_statement("execute", std::chrono::steady_clock::now() - start,
+                         true);
         LOG_ERROR("SQL 执行失败: " + query + " 错误: " + e.what());
         return false;
     }
 }
 
+void Database::record_statement(const char *op,
+                                const std::chrono::nanoseconds elapsed,
+                                const bool failed) {
+    thread_statements++;
+
+    // 三种语句各自缓存一次查找结果
+    static StatementMetrics execute_metrics = statement_metrics("execute");
+    static StatementMetrics query_metrics = statement_metrics("query");
+    static StatementMetrics statement = statement_metrics("statement");
+
+    std::string_view kind(op);
+    StatementMetrics &metrics = kind == "execute" ? execute_metrics
+                                : kind == "query" ? query_metrics
+                                                  : statement;
+    metrics.seconds.observe(elapsed);
+    if (failed)
+        metrics.errors.inc();
+}
+
+uint64_t Database::thread_statement_count() { return thread_statements; }
+
+void Database::annotate_span(Trace::Span &span, const std::string &sql) {
+    if (!span.is_active())
+        return;
+    span.set_detail(sql);
+
+    std::istringstream in(sql);
+    std::string keyword, word;
+    in >> keyword;
+    for (auto &c : keyword)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    // 表名跟在第一个 FROM / INTO / UPDATE 之后
+    std::string previous = keyword;
+    while (in >> word) {
+        if (previous == "FROM" || previous == "INTO" || previous == "UPDATE") {
+            span.set_name(keyword + " " + word.substr(0, word.find('(')));
+            return;
+        }
+        previous = word;
+        for (auto &c : previous)
+            c = static_cast<char>(
+                std::toupper(static_cast<unsigned char>(c)));
+    }
+    span.set_name(keyword);
+}
+
+mysqlx::SqlResult Database::Statement::execute() {
+    Trace::Span span("sql", "SQL");
+    annotate_span(span, text);
+    auto start = std::chrono::steady_clock::now();
+    try {
+        mysqlx::SqlResult result = stmt.execute();
+        record_statement("statement",
+                         std::chrono::steady_clock::now() - start, false);
+        return result;
+    } catch (const mysqlx::Error &) {
+        record_statement("statement",
+                         std::chrono::steady_clock::now() - start, true);
+        throw;
+    }
+}
+
 void Database::initialize_tables() {
     if (is_tables_initialized)
         return;
@@ -69,7 +221,7 @@ void Database::initialize_tables() {
             CREATE TABLE IF NOT EXISTS users (
                 id INT PRIMARY KEY AUTO_INCREMENT,
                 username VARCHAR(16) NOT NULL UNIQUE,
-                password  VARCHAR(97) NOT NULL,
+                password  VARCHAR(128) NOT NULL,
                 is_admin BOOLEAN DEFAULT FALSE,
                 status TINYINT DEFAULT 0,
                 created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
@@ -85,7 +237,13 @@ void Database::initialize_tables() {
               price DOUBLE NOT NULL,
               stock INT NOT NULL DEFAULT 0,
               status TINYINT DEFAULT 0,
-              created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+              created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+              INDEX idx_status (status),
+              INDEX idx_status_name (status, product_name),
+              INDEX idx_status_price (status, price),
+              INDEX idx_status_stock (status, stock),
+              INDEX idx_price (price),
+              INDEX idx_stock (stock)
           ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
              )";
 
@@ -146,6 +304,8 @@ void Database::initialize_tables() {
         session->sql(create_orders_table).execute();
         session->sql(create_history_orders_table).execute();
 
+        migrate_tables();
+
         LOG_INFO("数据库表初始化完成");
 
         is_tables_initialized = true;
@@ -155,3 +315,46 @@ void Database::initialize_tables() {
         throw;
     }
 }
+
+void Database::migrate_tables() {
+    // 旧版本建表时密码列为 VARCHAR(97)，放不下带算法和迭代次数的哈希格式
+    auto res = session
+                   ->sql("SELECT CAST(CHARACTER_MAXIMUM_LENGTH AS SIGNED) "
+                         "FROM information_schema.COLUMNS "
+                         "WHERE TABLE_SCHEMA = DATABASE() AND "
+                         "TABLE_NAME = 'users' AND COLUMN_NAME = 'password'")
+                   .execute();
+    auto row = res.fetchOne();
+    if (row && row[0].get<int>() < 128) {
+        session->sql("ALTER TABLE users MODIFY password VARCHAR(128) NOT NULL")
+            .execute();
+        LOG_INFO("users.password 列已扩展为 VARCHAR(128)");
+    }
+
+    // 商品分页按 (状态, 排序键, 商品 ID) keyset 查询，
+    // InnoDB 二级索引隐含主键列，以下索引即覆盖 (status, 排序键, product_id)
+    ensure_index("products", "idx_status", "status");
+    ensure_index("products", "idx_status_name", "status, product_name");
+    ensure_index("products", "idx_status_price", "status, price");
+    ensure_index("products", "idx_status_stock", "status, stock");
+    ensure_index("products", "idx_price", "price");
+    ensure_index("products", "idx_stock", "stock");
+}
+
+void Database::ensure_index(const std::string &table, const std::string &index,
+                            const std::string &columns) {
+    auto res = session
+                   ->sql("SELECT COUNT(*) FROM information_schema.STATISTICS "
+                         "WHERE TABLE_SCHEMA = DATABASE() AND "
+                         "TABLE_NAME = ? AND INDEX_NAME = ?")
+                   .bind(table, index)
+                   .execute();
+    auto row = res.fetchOne();
+    if (row && row[0].get<int64_t>() > 0)
+        return;
+
+    session->sql("ALTER TABLE " + table + " ADD INDEX " + index + " (" +
+                 columns + ")")
+        .execute();
+    LOG_INFO(table + " 表已补建索引 " + index + " (" + columns + ")");
+}
@@ -1,8 +1,15 @@
 #pragma once
 #include "Logger.h"
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <mysqlx/xdevapi.h>
+#include <string>
+#include <thread>
+#include <utility>
 
 struct DbConfig {
     std::string host = "localhost";
@@ -15,38 +22,104 @@ struct DbConfig {
 class Database {
   private:
     static std::unique_ptr<mysqlx::Session> session;
-    static bool is_connected_flag;
+    static std::atomic<bool> is_connected_flag;
     static bool is_tables_initialized;
     static std::mutex mutex;
 
+    // 连接配置，供其他线程建立各自的会话
+    static DbConfig connection_config;
+
+    // 调用 connect 的线程（使用主会话），其他线程使用线程局部会话
+    static std::thread::id owner_thread;
+
+    // 每次重新连接时递增，使旧的线程局部会话失效
+    static std::atomic<unsigned int> connection_epoch;
+
     static void initialize_tables();
 
+    // 对已存在的旧表做增量结构调整（建表语句不会修改已存在的表）
+    static void migrate_tables();
+
+    // 索引不存在时为已有的表补建（旧版本建表时没有该索引）
+    static void ensure_index(const std::string &table, const std::string &index,
+                             const std::string &columns);
+
+    // 记录一条语句的耗时与是否失败（op 为 "execute"、"query" 或 "statement"）
+    static void record_statement(const char *op,
+                                 const std::chrono::nanoseconds elapsed,
+                                 const bool failed);
+
+    // 追踪启用时为 span 设置语句名（首个关键字加表名，如 "SELECT carts"）
+    // 并附上完整语句
+    static void annotate_span(Trace::Span &span, const std::string &sql);
+
     Database() = default;
 
   public:
+    /**
+     * @brief 带追踪与耗时统计的 SQL 语句
+     *
+     * 用法与 mysqlx::SqlStatement 相同（bind 后 execute），
+     * execute 记录一个 "sql" 类别的 span 及 shopping_db_statement_seconds。
+     */
+    class Statement {
+      private:
+        mysqlx::SqlStatement stmt;
+        std::string text;
+
+      public:
+        Statement(mysqlx::SqlStatement stmt, std::string text)
+            : stmt(std::move(stmt)), text(std::move(text)) {}
+
+        template <typename... Args> Statement &bind(Args &&...args) {
+            stmt.bind(std::forward<Args>(args)...);
+            return *this;
+        }
+
+        mysqlx::SqlResult execute();
+    };
+
     static bool connect(const DbConfig &config);
 
+    // 获取当前线程的会话：连接线程返回主会话，
+    // 其他线程（如后台加载线程）首次调用时建立自己的会话，会话不可跨线程共享
     static mysqlx::Session& get_session();
 
+    // 在当前线程的会话上准备一条 SQL 语句
+    static Statement sql(const std::string &text) {
+        return Statement(get_session().sql(text), text);
+    }
+
     static bool is_connected();
 
     static void close();
 
     static bool execute(const std::string &query);
 
+    // 当前线程累计执行的 SQL 语句数（含失败的），
+    // 供界面统计一帧内在 UI 线程上同步执行了多少条语句
+    static uint64_t thread_statement_count();
+
     template <typename Func>
     static void query(const std::string &sql, Func &&callback) {
         if (!is_connected_flag) {
             throw std::runtime_error("数据库未连接，请先调用 connect()");
         }
+        Trace::Span span("sql", "SQL");
+        annotate_span(span, sql);
+        auto start = std::chrono::steady_clock::now();
         try {
-            auto result = session->sql(sql).execute();
+            auto result = get_session().sql(sql).execute();
             while (auto row = result.fetchOne()) {
                 callback(row);
             }
         } catch (const mysqlx::Error &e) {
+            record_statement("query", std::chrono::steady_clock::now() - start,
+                             true);
             LOG_ERROR("SQL 查询失败: " + sql + " 错误: " + e.what());
             throw;
         }
+        record_statement("query", std::chrono::steady_clock::now() - start,
+                         false);
     }
 };
@@ -0,0 +1,465 @@
+#include "HttpService.h"
+#include "JsonCodec.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <Utils.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_set>
+
+using json = nlohmann::json;
+
+namespace {
+
+// 搜索结果每页默认与最多返回的商品数
+constexpr size_t DEFAULT_PAGE_LIMIT = 50;
+constexpr size_t MAX_PAGE_LIMIT = 500;
+
+constexpr int DELIVERY_OPTION_COUNT =
+    sizeof(DELIVERY_PRICES) / sizeof(DELIVERY_PRICES[0]);
+
+void reply(httplib::Response &res, const int status, const json &body) {
+    res.status = status;
+    res.set_content(body.dump(), "application/json");
+}
+
+void reply_error(httplib::Response &res, const int status,
+                 const std::string &message) {
+    reply(res, status, {{"error", message}});
+}
+
+// 路径中第 i 个捕获组（路由正则保证为数字）
+long long path_id(const httplib::Request &req, const size_t i) {
+    return std::stoll(req.matches[i].str());
+}
+
+// 查询参数，不存在时返回默认值
+size_t query_size(const httplib::Request &req, const std::string &key,
+                  const size_t fallback) {
+    if (!req.has_param(key))
+        return fallback;
+    return static_cast<size_t>(std::stoul(req.get_param_value(key)));
+}
+
+// 订单表（订单号 -> 订单）按订单号顺序转为数组
+template <typename T>
+json orders_to_json(const std::map<long long, T> &orders) {
+    json list = json::array();
+    for (const auto &entry : orders)
+        list.push_back(entry.second);
+    return list;
+}
+
+} // namespace
+
+std::optional<Session> HttpService::authorize(const httplib::Request &req,
+                                              httplib::Response &res,
+                                              const int user_id) {
+    const std::string prefix = "Bearer ";
+    std::string header = req.get_header_value("Authorization");
+    std::optional<Session> session;
+    if (header.compare(0, prefix.size(), prefix) == 0)
+        session = sessions.find(header.substr(prefix.size()));
+
+    if (!session) {
+        reply_error(res, 401, "未登录或会话已过期");
+        return std::nullopt;
+    }
+    if (session->user_id != user_id && !session->is_admin) {
+        reply_error(res, 403, "无权访问其他用户的数据");
+        return std::nullopt;
+    }
+    return session;
+}
+
+HttpService::RouteHandler HttpService::route(const std::string &name,
+                                             RouteHandler handler) {
+    RouteStats &stats = metrics.add_route(name);
+
+    // 同时记入全局注册表，由 /metrics/prometheus 导出
+    auto &registry = Metrics::Registry::get_instance();
+    Metrics::Histogram &seconds = registry.histogram(
+        "shopping_http_request_seconds", "HTTP 请求的处理耗时",
+        {{"route", name}});
+    std::array<Metrics::Counter *, 3> responses = {};
+    const char *classes[] = {"2xx", "4xx", "5xx"};
+    for (size_t i = 0; i < responses.size(); i++)
+        responses[i] = &registry.counter(
+            "shopping_http_responses_total", "按状态码类别统计的 HTTP 响应数",
+            {{"route", name}, {"code", classes[i]}});
+
+    return [&stats, &seconds, responses, name, handler = std::move(handler)](
+               const httplib::Request &req, httplib::Response &res) {
+        TRACE_SCOPE("http", name);
+        auto start = std::chrono::steady_clock::now();
+        try {
+            handler(req, res);
+        } catch (const json::exception &e) {
+            // 请求体不是合法 JSON 或字段类型不符
+            reply_error(res, 400, e.what());
+        } catch (const std::invalid_argument &) {
+            reply_error(res, 400, "参数格式错误");
+        } catch (const std::out_of_range &) {
+            reply_error(res, 400, "参数超出范围");
+        } catch (const std::exception &e) {
+            LOG_ERROR(name + " 处理失败: " + std::string(e.what()));
+            reply_error(res, 500, "服务器内部错误");
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        stats.record(res.status, elapsed);
+        seconds.observe(elapsed);
+        responses[res.status >= 500 ? 2 : res.status >= 400 ? 1 : 0]->inc();
+    };
+}
+
+void HttpService::register_routes(httplib::Server &server) {
+    auto bind = [this](void (HttpService::*method)(const httplib::Request &,
+                                                   httplib::Response &)) {
+        return [this, method](const httplib::Request &req,
+                              httplib::Response &res) {
+            (this->*method)(req, res);
+        };
+    };
+
+    server.Post("/api/login",
+                route("POST /api/login", bind(&HttpService::login)));
+    server.Delete("/api/session",
+                  route("DELETE /api/session", bind(&HttpService::logout)));
+    server.Post("/api/register", route("POST /api/register",
+                                       bind(&HttpService::register_user)));
+
+    server.Get("/api/products", route("GET /api/products",
+                                      bind(&HttpService::search_products)));
+    server.Get(R"(/api/products/(\d+))",
+               route("GET /api/products/{id}",
+                     bind(&HttpService::get_product)));
+
+    server.Get(R"(/api/users/(\d+)/cart)",
+               route("GET /api/users/{uid}/cart",
+                     bind(&HttpService::get_cart)));
+    server.Post(R"(/api/users/(\d+)/cart)",
+                route("POST /api/users/{uid}/cart",
+                      bind(&HttpService::add_to_cart)));
+    server.Put(R"(/api/users/(\d+)/cart/(\d+))",
+               route("PUT /api/users/{uid}/cart/{pid}",
+                     bind(&HttpService::update_cart_item)));
+    server.Delete(R"(/api/users/(\d+)/cart/(\d+))",
+                  route("DELETE /api/users/{uid}/cart/{pid}",
+                        bind(&HttpService::remove_from_cart)));
+    server.Post(R"(/api/users/(\d+)/checkout)",
+                route("POST /api/users/{uid}/checkout",
+                      bind(&HttpService::checkout)));
+
+    server.Get(R"(/api/users/(\d+)/orders)",
+               route("GET /api/users/{uid}/orders",
+                     bind(&HttpService::get_orders)));
+    server.Post(R"(/api/users/(\d+)/orders/(\d+)/cancel)",
+                route("POST /api/users/{uid}/orders/{id}/cancel",
+                      bind(&HttpService::cancel_order)));
+    server.Get(R"(/api/users/(\d+)/history)",
+               route("GET /api/users/{uid}/history",
+                     bind(&HttpService::get_history)));
+
+    // 指标与存活检查不计入请求指标
+    server.Get("/metrics",
+               [this](const httplib::Request &, httplib::Response &res) {
+                   json body = metrics.to_json();
+                   CacheStats cache = get_search_cache_stats();
+                   body["search_cache"] = {{"hits", cache.hits},
+                                           {"misses", cache.misses},
+                                           {"hit_ratio", cache.hit_ratio()},
+                                           {"size", cache.size}};
+                   body["sessions"] = sessions.size();
+                   reply(res, 200, body);
+               });
+    server.Get("/metrics/prometheus",
+               [this](const httplib::Request &, httplib::Response &res) {
+                   static auto &open_sessions =
+                       Metrics::Registry::get_instance().gauge(
+                           "shopping_http_sessions", "当前打开的登录会话数");
+                   open_sessions.set(static_cast<double>(sessions.size()));
+                   res.set_content(Metrics::Registry::get_instance().render(),
+                                   "text/plain; version=0.0.4; charset=utf-8");
+               });
+    // 最近的追踪记录（Chrome 追踪事件格式），需以 TRACE_FILE 启用追踪
+    server.Get("/debug/trace",
+               [](const httplib::Request &, httplib::Response &res) {
+                   res.set_content(
+                       Trace::Recorder::get_instance().to_chrome_json(),
+                       "application/json");
+               });
+    server.Get("/healthz",
+               [](const httplib::Request &, httplib::Response &res) {
+                   reply(res, 200, {{"status", "ok"}});
+               });
+}
+
+// --- 用户 ---
+
+void HttpService::login(const httplib::Request &req, httplib::Response &res) {
+    json body = json::parse(req.body);
+    std::string username = body.at("username").get<std::string>();
+    std::string password = body.at("password").get<std::string>();
+
+    auto user = user_manager.authenticate(username, password);
+    if (!user) {
+        reply_error(res, 401, "用户名或密码错误");
+        return;
+    }
+
+    if (++login_count % SESSION_SWEEP_INTERVAL == 0)
+        sessions.expire_idle(SESSION_IDLE_TIMEOUT);
+
+    reply(res, 200, {{"token", sessions.open(*user)}, {"user", *user}});
+}
+
+void HttpService::logout(const httplib::Request &req, httplib::Response &res) {
+    const std::string prefix = "Bearer ";
+    std::string header = req.get_header_value("Authorization");
+    if (header.compare(0, prefix.size(), prefix) != 0 ||
+        !sessions.close(header.substr(prefix.size()))) {
+        reply_error(res, 401, "未登录或会话已过期");
+        return;
+    }
+    reply(res, 200, {{"status", "ok"}});
+}
+
+void HttpService::register_user(const httplib::Request &req,
+                                httplib::Response &res) {
+    json body = json::parse(req.body);
+    std::string username = body.at("username").get<std::string>();
+    std::string password = body.at("password").get<std::string>();
+    std::string again_password = body.value("again_password", password);
+
+    std::string error_message;
+    if (user_manager.check_register(username, password, again_password,
+                                    error_message) != Result::SUCCESS) {
+        reply_error(res, 400, error_message);
+        return;
+    }
+    reply(res, 201, {{"username", username}});
+}
+
+// --- 商品 ---
+
+void HttpService::search_products(const httplib::Request &req,
+                                  httplib::Response &res) {
+    std::string query = req.has_param("q") ? req.get_param_value("q") : "";
+    size_t limit =
+        std::min(query_size(req, "limit", DEFAULT_PAGE_LIMIT), MAX_PAGE_LIMIT);
+    size_t offset = query_size(req, "offset", 0);
+
+    auto result = product_manager.search_product(query);
+
+    json products = json::array();
+    for (size_t i = offset; i < result.size() && i < offset + limit; i++)
+        products.push_back(result[i]);
+
+    const auto &catalog = result.get_catalog();
+    reply(res, 200,
+          {{"catalog_version", catalog ? catalog->version : 0},
+           {"total", result.size()},
+           {"offset", offset},
+           {"products", products}});
+}
+
+void HttpService::get_product(const httplib::Request &req,
+                              httplib::Response &res) {
+    int product_id = static_cast<int>(path_id(req, 1));
+    auto product = product_manager.get_product(product_id);
+    if (!product || product->status == ProductStatus::DELETED) {
+        reply_error(res, 404, "商品不存在");
+        return;
+    }
+    reply(res, 200, *product);
+}
+
+// --- 购物车 ---
+
+void HttpService::get_cart(const httplib::Request &req,
+                           httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    if (!authorize(req, res, user_id))
+        return;
+    reply(res, 200, cart_manager.fetch_cart(user_id));
+}
+
+void HttpService::add_to_cart(const httplib::Request &req,
+                              httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    if (!authorize(req, res, user_id))
+        return;
+    json body = json::parse(req.body);
+    int product_id = body.at("product_id").get<int>();
+    int count = body.value("count", 1);
+    if (count <= 0) {
+        reply_error(res, 400, "数量必须大于 0");
+        return;
+    }
+
+    auto cart = sessions.with_user(user_id, [&] {
+        cart_manager.add_item(user_id, product_id, count);
+        return cart_manager.fetch_cart(user_id);
+    });
+    reply(res, 200, cart);
+}
+
+void HttpService::update_cart_item(const httplib::Request &req,
+                                   httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    int product_id = static_cast<int>(path_id(req, 2));
+    if (!authorize(req, res, user_id))
+        return;
+    json body = json::parse(req.body);
+    int count = body.at("count").get<int>();
+    if (count <= 0) {
+        reply_error(res, 400, "数量必须大于 0");
+        return;
+    }
+    // 配送方式只在结账时随选中的商品提交，购物车中不保存
+    if (body.contains("delivery_selection")) {
+        reply_error(res, 400, "配送方式在结账时指定");
+        return;
+    }
+
+    auto cart = sessions.with_user(user_id, [&] {
+        cart_manager.update_item(user_id, product_id, count, -1);
+        return cart_manager.fetch_cart(user_id);
+    });
+    reply(res, 200, cart);
+}
+
+void HttpService::remove_from_cart(const httplib::Request &req,
+                                   httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    int product_id = static_cast<int>(path_id(req, 2));
+    if (!authorize(req, res, user_id))
+        return;
+
+    auto cart = sessions.with_user(user_id, [&] {
+        cart_manager.delete_item(user_id, product_id);
+        return cart_manager.fetch_cart(user_id);
+    });
+    reply(res, 200, cart);
+}
+
+// 与 DataStore::checkout 相同的流程（OrderManager::purchase），但整单结算：
+// 任何一个商品库存不足都不下单。同一用户的结账按用户串行执行
+void HttpService::checkout(const httplib::Request &req,
+                           httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    if (!authorize(req, res, user_id))
+        return;
+    json body = json::parse(req.body);
+    std::string address = body.at("address").get<std::string>();
+    if (address.empty() ||
+        Utils::utf8_length(address) > FullOrder::MAX_ADDRESS_LENGTH) {
+        reply_error(res, 400, "收货地址无效");
+        return;
+    }
+
+    std::vector<CartItem> selected;
+    std::unordered_set<int> selected_ids;
+    for (const auto &item : body.at("items")) {
+        int product_id = item.at("product_id").get<int>();
+        int count = item.at("count").get<int>();
+        int delivery_selection = item.value("delivery_selection", 0);
+        if (count <= 0 || delivery_selection < 0 ||
+            delivery_selection >= DELIVERY_OPTION_COUNT) {
+            reply_error(res, 400, "数量或配送方式无效");
+            return;
+        }
+        if (!selected_ids.insert(product_id).second) {
+            reply_error(res, 400,
+                        "商品 " + std::to_string(product_id) + " 重复选择");
+            return;
+        }
+        selected.emplace_back(user_id, product_id, count,
+                              CartItemStatus::NOT_ORDERED, delivery_selection);
+    }
+    if (selected.empty()) {
+        reply_error(res, 400, "没有选择要结算的商品");
+        return;
+    }
+
+    sessions.with_user(user_id, [&] {
+        // 只能结算购物车中的商品，在扣减库存之前检查
+        auto cart = cart_manager.fetch_cart(user_id);
+        for (const auto &item : selected) {
+            bool in_cart = std::any_of(
+                cart.begin(), cart.end(), [&](const CartItem &c) {
+                    return c.product_id == item.product_id;
+                });
+            if (!in_cart) {
+                reply_error(res, 409,
+                            "商品 " + std::to_string(item.product_id) +
+                                " 不在购物车中");
+                return;
+            }
+        }
+
+        // 只结算选中的商品（购物车中的其他商品不受影响）
+        auto result = order_manager.purchase(
+            user_id, selected, address, cart_manager, product_manager,
+            history_order_manager, "http", true);
+        if (result.rejected_product_id != 0) {
+            reply_error(res, 409,
+                        "商品 " + std::to_string(result.rejected_product_id) +
+                            " 不存在、已下架或库存不足");
+            return;
+        }
+        if (result.ordered.empty()) {
+            reply_error(res, 409, "购物车已变化，请刷新后重试");
+            return;
+        }
+        reply(res, 201, {{"ordered", result.ordered}});
+    });
+}
+
+// --- 订单 ---
+
+void HttpService::get_orders(const httplib::Request &req,
+                             httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    if (!authorize(req, res, user_id))
+        return;
+    reply(res, 200,
+          orders_to_json(
+              order_manager.fetch_full_orders(user_id, product_manager)));
+}
+
+void HttpService::cancel_order(const httplib::Request &req,
+                               httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    long long order_id = path_id(req, 2);
+    if (!authorize(req, res, user_id))
+        return;
+
+    sessions.with_user(user_id, [&] {
+        // 只能取消属于该用户的订单；重复取消由 cancel_order 保证只恢复一次库存
+        auto orders = order_manager.fetch_full_orders(user_id, product_manager);
+        if (!orders.count(order_id)) {
+            reply_error(res, 404, "订单不存在");
+            return;
+        }
+        if (!order_manager.cancel_order(order_id, product_manager)) {
+            reply_error(res, 409, "订单已完成或已取消");
+            return;
+        }
+        history_order_manager.cancel_history_order(order_id, product_manager);
+        reply(res, 200, {{"order_id", order_id}});
+    });
+}
+
+void HttpService::get_history(const httplib::Request &req,
+                              httplib::Response &res) {
+    int user_id = static_cast<int>(path_id(req, 1));
+    if (!authorize(req, res, user_id))
+        return;
+    reply(res, 200,
+          orders_to_json(history_order_manager.fetch_history_orders(
+              user_id, product_manager)));
+}
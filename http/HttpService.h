@@ -0,0 +1,115 @@
+/**
+ * @file      HttpService.h
+ * @brief     HTTP/JSON 服务
+ * @details   把商品搜索、购物车、结账、订单与历史订单以 JSON 接口暴露出来，
+ *            由 cpp-httplib 的线程池并发处理请求。各工作线程使用自己的
+ *            数据库会话，线程数即会话数上限。
+ *
+ *            接口一览（请求与响应体均为 JSON）：
+ *            - POST   /api/login                          登录，返回会话令牌
+ *            - DELETE /api/session                        注销
+ *            - POST   /api/register                       注册
+ *            - GET    /api/products?q=&limit=&offset=     搜索在售商品
+ *            - GET    /api/products/{id}                  商品详情
+ *            - GET    /api/users/{uid}/cart               购物车
+ *            - POST   /api/users/{uid}/cart               加入购物车
+ *            - PUT    /api/users/{uid}/cart/{pid}         修改数量
+ *            - DELETE /api/users/{uid}/cart/{pid}         移出购物车
+ *            - POST   /api/users/{uid}/checkout           结账
+ *            - GET    /api/users/{uid}/orders             订单
+ *            - POST   /api/users/{uid}/orders/{id}/cancel 取消订单
+ *            - GET    /api/users/{uid}/history            历史订单
+ *            - GET    /metrics                            请求指标
+ *            - GET    /metrics/prometheus                 Prometheus 格式指标
+ *            - GET    /debug/trace                        调用追踪记录
+ *            - GET    /healthz                            存活检查
+ *
+ *            /api/users/{uid} 下的接口需要在 Authorization 头中携带
+ *            "Bearer <令牌>"，令牌须属于该用户或管理员。
+ */
+
+#pragma once
+#include "CartManager.h"
+#include "HistoryOrderManager.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include "RequestMetrics.h"
+#include "SessionManager.h"
+#include "UserManager.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <httplib.h>
+#include <optional>
+#include <string>
+
+/**
+ * @brief HTTP/JSON 服务：路由到管理类的分发
+ *
+ * 应监听在回环地址上（未使用 TLS），由本机前端或测试客户端访问。
+ */
+class HttpService {
+  public:
+    using RouteHandler =
+        std::function<void(const httplib::Request &, httplib::Response &)>;
+
+  private:
+    UserManager user_manager;
+    ProductManager product_manager;
+    CartManager cart_manager;
+    OrderManager order_manager;
+    HistoryOrderManager history_order_manager;
+
+    // 登录会话；同一用户的多步写操作经由它按用户串行化
+    SessionManager sessions;
+
+    // 会话空闲超时，每登录 SESSION_SWEEP_INTERVAL 次清理一次过期会话
+    static constexpr std::chrono::seconds SESSION_IDLE_TIMEOUT{30 * 60};
+    static constexpr uint64_t SESSION_SWEEP_INTERVAL = 256;
+    std::atomic<uint64_t> login_count{0};
+
+    RequestMetrics metrics;
+
+    // 校验请求携带的令牌是否可以访问该用户的数据，失败时写入 401 / 403
+    std::optional<Session> authorize(const httplib::Request &req,
+                                     httplib::Response &res, const int user_id);
+
+    // 包装处理函数：统一的错误响应与请求指标
+    RouteHandler route(const std::string &name, RouteHandler handler);
+
+    void login(const httplib::Request &req, httplib::Response &res);
+    void logout(const httplib::Request &req, httplib::Response &res);
+    void register_user(const httplib::Request &req, httplib::Response &res);
+    void search_products(const httplib::Request &req, httplib::Response &res);
+    void get_product(const httplib::Request &req, httplib::Response &res);
+    void get_cart(const httplib::Request &req, httplib::Response &res);
+    void add_to_cart(const httplib::Request &req, httplib::Response &res);
+    void update_cart_item(const httplib::Request &req, httplib::Response &res);
+    void remove_from_cart(const httplib::Request &req, httplib::Response &res);
+    void checkout(const httplib::Request &req, httplib::Response &res);
+    void get_orders(const httplib::Request &req, httplib::Response &res);
+    void cancel_order(const httplib::Request &req, httplib::Response &res);
+    void get_history(const httplib::Request &req, httplib::Response &res);
+
+  public:
+    HttpService() = default;
+
+    HttpService(const HttpService &) = delete;
+    HttpService &operator=(const HttpService &) = delete;
+
+    /**
+     * @brief 在服务器上注册所有路由（在 listen 之前调用）
+     *
+     * @param server HTTP 服务器
+     */
+    void register_routes(httplib::Server &server);
+
+    /**
+     * @brief 获取商品搜索缓存的命中统计
+     *
+     * @return CacheStats 统计信息
+     */
+    CacheStats get_search_cache_stats() const {
+        return product_manager.get_search_cache_stats();
+    }
+};
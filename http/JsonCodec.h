@@ -0,0 +1,70 @@
+/**
+ * @file      JsonCodec.h
+ * @brief     模型类型到 JSON 的转换
+ * @details   供 HTTP 服务序列化响应，字段名与结构体成员一致，
+ *            枚举按整数值输出（与数据库中存储的值相同），用户信息不含密码哈希。
+ */
+
+#pragma once
+#include "HistoryOrderManager.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include "UserManager.h"
+#include <nlohmann/json.hpp>
+
+// nlohmann::json 通过参数相关查找调用 to_json，需与类型位于同一命名空间
+
+inline void to_json(nlohmann::json &j, const Product &product) {
+    j = {{"product_id", product.product_id},
+         {"product_name", product.product_name},
+         {"price", product.price},
+         {"stock", product.stock},
+         {"status", static_cast<int>(product.status)}};
+}
+
+inline void to_json(nlohmann::json &j, const CartItem &item) {
+    j = {{"product_id", item.product_id},
+         {"count", item.count},
+         {"status", static_cast<int>(item.status)},
+         {"delivery_selection", item.delivery_selection}};
+}
+
+inline void to_json(nlohmann::json &j, const OrderItem &item) {
+    j = {{"product_id", item.product_id},
+         {"count", item.count},
+         {"delivery_selection", item.delivery_selection},
+         {"status", static_cast<int>(item.status)}};
+}
+
+inline void to_json(nlohmann::json &j, const FullOrder &order) {
+    j = {{"order_id", order.order_id},
+         {"total_price", order.total_price},
+         {"order_time", static_cast<long long>(order.order_time)},
+         {"address", order.address},
+         {"status", static_cast<int>(order.status)},
+         {"items", order.items}};
+}
+
+inline void to_json(nlohmann::json &j, const HistoryOrderItem &item) {
+    j = {{"product_name", item.product_name},
+         {"price", item.price},
+         {"count", item.count},
+         {"delivery_selection", item.delivery_selection},
+         {"status", static_cast<int>(item.status)}};
+}
+
+inline void to_json(nlohmann::json &j, const HistoryFullOrder &order) {
+    j = {{"order_id", order.order_id},
+         {"total_price", order.total_price},
+         {"order_time", static_cast<long long>(order.order_time)},
+         {"address", order.address},
+         {"status", static_cast<int>(order.status)},
+         {"items", order.items}};
+}
+
+inline void to_json(nlohmann::json &j, const User &user) {
+    j = {{"id", user.id},
+         {"username", user.username},
+         {"is_admin", user.is_admin},
+         {"status", static_cast<int>(user.status)}};
+}
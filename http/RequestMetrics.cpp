@@ -0,0 +1,86 @@
+#include "RequestMetrics.h"
+
+using json = nlohmann::json;
+
+void RouteStats::record(const int status,
+                        const std::chrono::nanoseconds elapsed) {
+    uint64_t us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (status >= 500)
+        server_errors.fetch_add(1, std::memory_order_relaxed);
+    else if (status >= 400)
+        client_errors.fetch_add(1, std::memory_order_relaxed);
+    total_us.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t seen = max_us.load(std::memory_order_relaxed);
+    while (us > seen &&
+           !max_us.compare_exchange_weak(seen, us, std::memory_order_relaxed))
+        ;
+
+    double ms = us / 1000.0;
+    size_t bucket = 0;
+    while (bucket < BUCKET_BOUNDS_MS.size() && ms > BUCKET_BOUNDS_MS[bucket])
+        bucket++;
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+double RouteStats::percentile_ms(const double q) const {
+    uint64_t total = 0;
+    for (const auto &bucket : buckets)
+        total += bucket.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+
+    uint64_t target = static_cast<uint64_t>(q * total + 0.5);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_BOUNDS_MS.size(); i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return BUCKET_BOUNDS_MS[i];
+    }
+    // 落在溢出桶时以最大值代替
+    return max_us.load(std::memory_order_relaxed) / 1000.0;
+}
+
+json RouteStats::to_json() const {
+    uint64_t n = count.load(std::memory_order_relaxed);
+    uint64_t total = total_us.load(std::memory_order_relaxed);
+
+    json histogram = json::array();
+    for (size_t i = 0; i < buckets.size(); i++) {
+        json bucket = {{"count", buckets[i].load(std::memory_order_relaxed)}};
+        if (i < BUCKET_BOUNDS_MS.size())
+            bucket["le_ms"] = BUCKET_BOUNDS_MS[i];
+        histogram.push_back(bucket);
+    }
+
+    return {{"route", name},
+            {"requests", n},
+            {"client_errors", client_errors.load(std::memory_order_relaxed)},
+            {"server_errors", server_errors.load(std::memory_order_relaxed)},
+            {"avg_ms", n ? total / 1000.0 / n : 0.0},
+            {"max_ms", max_us.load(std::memory_order_relaxed) / 1000.0},
+            {"p50_ms", percentile_ms(0.50)},
+            {"p90_ms", percentile_ms(0.90)},
+            {"p99_ms", percentile_ms(0.99)},
+            {"histogram", histogram}};
+}
+
+RouteStats &RequestMetrics::add_route(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return routes.emplace_back(name);
+}
+
+json RequestMetrics::to_json() {
+    auto uptime = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started);
+
+    json result = {{"uptime_seconds", uptime.count()},
+                   {"routes", json::array()}};
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto &route : routes)
+        result["routes"].push_back(route.to_json());
+    return result;
+}
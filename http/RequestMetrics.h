@@ -0,0 +1,87 @@
+/**
+ * @file      RequestMetrics.h
+ * @brief     HTTP 请求级指标
+ * @details   按路由统计请求数、4xx / 5xx 数与延迟直方图。
+ *            路由在服务启动前注册，记录时只做原子加法，不加锁，
+ *            线程池中的所有工作线程可以同时记录。
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+
+/**
+ * @brief 单个路由的统计
+ *
+ */
+class RouteStats {
+  public:
+    // 延迟直方图各桶的上界（毫秒），超过最后一个上界的计入溢出桶
+    static constexpr std::array<double, 12> BUCKET_BOUNDS_MS = {
+        0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000};
+
+  private:
+    std::string name;
+
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> client_errors{0}; ///< 4xx
+    std::atomic<uint64_t> server_errors{0}; ///< 5xx
+    std::atomic<uint64_t> total_us{0};
+    std::atomic<uint64_t> max_us{0};
+    std::array<std::atomic<uint64_t>, BUCKET_BOUNDS_MS.size() + 1> buckets{};
+
+    // 由直方图估计分位数：返回累计数达到 q 的桶的上界
+    double percentile_ms(const double q) const;
+
+  public:
+    explicit RouteStats(std::string name) : name(std::move(name)) {}
+
+    /**
+     * @brief 记录一次请求
+     *
+     * @param status HTTP 状态码
+     * @param elapsed 处理耗时
+     */
+    void record(const int status, const std::chrono::nanoseconds elapsed);
+
+    /**
+     * @brief 导出统计
+     *
+     * @return nlohmann::json 请求数、错误数、平均 / 最大延迟与 p50/p90/p99
+     */
+    nlohmann::json to_json() const;
+};
+
+/**
+ * @brief 全部路由的指标
+ *
+ */
+class RequestMetrics {
+  private:
+    std::mutex mtx;
+    std::deque<RouteStats> routes; ///< deque 扩容不移动已有元素，引用保持有效
+    std::chrono::steady_clock::time_point started =
+        std::chrono::steady_clock::now();
+
+  public:
+    /**
+     * @brief 注册路由（在服务启动前调用）
+     *
+     * @param name 路由名称，如 "GET /api/products"
+     * @return RouteStats& 该路由的统计，生命周期与本对象相同
+     */
+    RouteStats &add_route(const std::string &name);
+
+    /**
+     * @brief 导出所有路由的统计及运行时长
+     *
+     * @return nlohmann::json 指标
+     */
+    nlohmann::json to_json();
+};
@@ -13,6 +13,9 @@
 Logger *Logger::instance = nullptr;
 std::mutex Logger::mutex;
 
+// 当前线程记录的错误日志条数
+static thread_local uint64_t thread_errors = 0;
+
 // 静态成员初始化
 Logger::Logger()
     : min_level(LogLevel::DEBUG), enable_console(true), enable_file(true),
@@ -104,13 +107,29 @@ void Logger::write_log(LogLevel level, const std::string &message,
 
 void Logger::log(LogLevel level, const std::string &message,
                  const std::string &file, int line) {
+    if (level >= LogLevel::ERROR)
+        thread_errors++;
+
     // 过滤低于最低级别的日志
     if (level < min_level) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex);
-    write_log(level, message, file, line);
+    // 进入排队：记录排队深度的峰值
+    uint32_t depth = pending.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint32_t peak = peak_pending.load(std::memory_order_relaxed);
+    while (depth > peak &&
+           !peak_pending.compare_exchange_weak(peak, depth,
+                                               std::memory_order_relaxed))
+        ;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        write_log(level, message, file, line);
+    }
+
+    lines.fetch_add(1, std::memory_order_relaxed);
+    pending.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void Logger::set_level(LogLevel level) {
@@ -145,9 +164,19 @@ void Logger::set_file_output(bool enable) {
     enable_file = enable;
 }
 
+uint64_t Logger::thread_error_count() { return thread_errors; }
+
 void Logger::flush() {
     std::lock_guard<std::mutex> lock(mutex);
     if (log_file.is_open()) {
         log_file.flush();
     }
 }
+
+LoggerStats Logger::get_stats() const {
+    LoggerStats stats;
+    stats.pending = pending.load(std::memory_order_relaxed);
+    stats.peak_pending = peak_pending.load(std::memory_order_relaxed);
+    stats.lines = lines.load(std::memory_order_relaxed);
+    return stats;
+}
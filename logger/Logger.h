@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <mutex>
 #include <string>
@@ -24,6 +26,18 @@ enum class LogLevel {
     CRITICAL = 4, // 严重错误
 };
 
+/**
+ * @brief 日志写入的统计信息
+ *
+ * 日志是在调用线程上同步写出的，没有独立的队列；
+ * 排队深度即正在等待或持有日志锁的调用数。
+ */
+struct LoggerStats {
+    uint32_t pending = 0;      ///< 正在等待或持有日志锁的写入数
+    uint32_t peak_pending = 0; ///< pending 的历史最大值
+    uint64_t lines = 0;        ///< 累计写出的日志条数
+};
+
 /**
  * @brief 日志记录类
  *
@@ -41,6 +55,10 @@ class Logger {
     bool enable_file;          // 是否启用文件输出
     std::string log_file_path; // 日志文件路径
 
+    std::atomic<uint32_t> pending{0};      // 等待或持有锁的写入数
+    std::atomic<uint32_t> peak_pending{0}; // pending 的历史最大值
+    std::atomic<uint64_t> lines{0};        // 累计写出的条数
+
     /**
      * @brief 私有构造函数
      *
@@ -142,6 +160,25 @@ class Logger {
      * @brief 刷新日志缓冲区
      */
     void flush();
+
+    /**
+     * @brief 获取当前线程累计记录的错误日志条数
+     *
+     * 统计 ERROR 及以上级别的日志（不受最低记录级别过滤影响），
+     * 供压测等场景按线程判断一次操作是否出错。
+     *
+     * @return uint64_t 错误日志条数
+     */
+    static uint64_t thread_error_count();
+
+    /**
+     * @brief 获取日志写入的统计信息
+     *
+     * 只读取原子计数，不加锁，可在任意线程频繁调用。
+     *
+     * @return LoggerStats 统计信息
+     */
+    LoggerStats get_stats() const;
 };
 
 // 便捷宏定义，简化日志调用
@@ -2,16 +2,20 @@
 system("chcp 65001");
 #endif
 
-#include "Database.h"
 #include "Logger.h"
+#include "MetricsServer.h"
+#include "SecurityUtils.h"
 #include "ShopAppUI.h"
+#include "Startup.h"
+#include <cstdlib>
+#include <iostream>
 #include <string>
 #include <string_view>
 
 using std::string;
 using std::string_view;
 
-int main() {
+int main(int argc, char *argv[]) {
     // 配置日志系统
     auto &logger = Logger::get_instance();
     logger.set_level(LogLevel::DEBUG);
@@ -22,56 +26,74 @@ int main() {
 
     LOG_INFO("Shopping App 启动中...");
 
-    DbConfig config;
-
-    const char *db_pass = std::getenv("DB_PASSWORD");
-    if (!db_pass) {
-        LOG_ERROR("未找到环境变量 DB_PASSWORD");
+    Startup::configure_kdf_from_env();
+    if (!Startup::connect_database_from_env())
         return -1;
-    }
 
-    config.password = db_pass;
-    config.database = "ShoppingApp";
+    AppContext ctx;
 
-    if (!Database::connect(config)) {
-        LOG_ERROR("无法连接到数据库，程序终止。");
-        return -1;
+    // 批量导入用户：--import-users <文件路径> [哈希迭代次数]
+    if (argc >= 3 && string_view(argv[1]) == "--import-users") {
+        int iterations = argc >= 4 ? std::atoi(argv[3])
+                                   : SecurityUtils::get_iterations();
+        auto report = ctx.user_manager.import_users(argv[2], iterations);
+
+        std::cout << "导入 " << report.imported << " 个用户（重复 "
+                  << report.duplicates << "，无效 " << report.invalid
+                  << "，失败 " << report.failed << "），耗时 "
+                  << report.seconds << " 秒，" << report.users_per_second()
+                  << " 用户/秒" << std::endl;
+        return report.failed == 0 ? 0 : -1;
     }
 
-    // 初始化商品信息
-
-    // try {
-
-    //     // 获取普通 statement
-    //     std::unique_ptr<sql::Statement> stmt(
-    //         Database::get_connection()->createStatement());
-
-    //     std::string path2 = "/home/lei/ShoppingApp/data/ProductsInfo.txt";
-    //     std::string sql2 =
-    //         "LOAD DATA LOCAL INFILE '" + path2 + "' INTO TABLE products";
-
-    //     // 执行加载商品信息
-    //     stmt->execute(sql2);
-    //     LOG_INFO("商品信息加载成功");
-
-    // } catch (sql::SQLException &e) {
-    //     LOG_ERROR("加载数据失败: " + std::string(e.what()));
-    // }
-
-    AppContext ctx;
+    // 批量导入 / 导出商品：--import-products <文件路径>、--export-products
+    // <文件路径>（.csv 为逗号分隔，其余为制表符分隔）
+    if (argc >= 3 && (string_view(argv[1]) == "--import-products" ||
+                      string_view(argv[1]) == "--export-products")) {
+        auto print_progress = [](const ProductTransferReport &report) {
+            std::cout << "\r已处理 " << report.processed << " 行，写入 "
+                      << report.written << " 个" << std::flush;
+        };
+
+        auto report =
+            string_view(argv[1]) == "--import-products"
+                ? ctx.product_manager.import_products(argv[2], print_progress)
+                : ctx.product_manager.export_products(argv[2], print_progress);
+
+        std::cout << "\n完成：写入 " << report.written << " 个（无效 "
+                  << report.invalid << "，失败 " << report.failed << "），耗时 "
+                  << report.seconds << " 秒，" << report.rows_per_second()
+                  << " 行/秒" << std::endl;
+        for (const auto &error : report.errors)
+            std::cout << "  " << error << std::endl;
+        return report.failed == 0 ? 0 : -1;
+    }
 
-    // // 添加管理员和普通用户
-    // std::string hash_password1 = SecurityUtils::hash_password("1234");
-    // User temp1("lei", hash_password1, true);
-    // std::string hash_password2 = SecurityUtils::hash_password("1234");
-    // User temp2("zhang", hash_password2, false);
+    // 设置 METRICS_PORT 时在 127.0.0.1 上导出 Prometheus 格式的指标
+    MetricsServer metrics_server;
+    if (const char *metrics_port = std::getenv("METRICS_PORT")) {
+        int port = std::atoi(metrics_port);
+        if (metrics_server.start(port))
+            LOG_INFO("指标导出: http://127.0.0.1:" + std::to_string(port) +
+                     "/metrics");
+        else
+            LOG_ERROR("无法在端口 " + std::to_string(port) + " 上导出指标");
+    }
 
-    // ctx.user_manager.append_user(temp1);
-    // ctx.user_manager.append_user(temp2);
+    // 设置 TRACE_FILE 时记录调用追踪，退出时以 Chrome 追踪事件格式写入该文件
+    auto trace_file = Startup::enable_trace_from_env();
 
     ShopAppUI my_app(ctx);
 
     my_app.run();
 
+    if (trace_file)
+        Startup::write_trace(*trace_file);
+
+    // 退出时报告查询缓存的效果
+    Startup::log_cache_stats("商品搜索",
+                             ctx.product_manager.get_search_cache_stats());
+    Startup::log_cache_stats("用户", ctx.user_manager.get_cache_stats());
+
     return 0;
 }
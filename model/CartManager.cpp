@@ -1,28 +1,27 @@
 #include "CartManager.h"
+#include "ChangeBus.h"
 #include "Database.h"
+#include "Trace.h"
 
 using std::string;
 using std::string_view;
 
-void CartManager::load_cart(const int user_id) {
+std::vector<CartItem> CartManager::fetch_cart(const int user_id) const {
+    TRACE_SCOPE("model", "CartManager::fetch_cart");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法加载商品信息到内存。");
     }
 
-    is_loaded = false;
-    cart_list.clear();
+    std::vector<CartItem> result;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT user_id, product_id, count, status, "
-                            "delivery_selection FROM carts")
+        auto res = Database::sql("SELECT user_id, product_id, count, status, "
+                                 "delivery_selection FROM carts "
+                                 "WHERE user_id = ? AND status = ?")
+                       .bind(user_id,
+                             static_cast<int>(CartItemStatus::NOT_ORDERED))
                        .execute();
         while (auto row = res.fetchOne()) {
-            if (static_cast<int>(CartItemStatus::NOT_ORDERED) !=
-                row[3].get<int>()) {
-                continue;
-            }
-
             CartItem temp;
 
             temp.id = row[0].get<int>();
@@ -30,30 +29,31 @@ void CartManager::load_cart(const int user_id) {
             temp.count = row[2].get<int>();
             temp.delivery_selection = row[4].get<int>();
             temp.status = static_cast<CartItemStatus>(row[3].get<int>());
-            cart_list.push_back(temp);
+            result.push_back(temp);
         }
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("加载购物车列表到内存失败，" + string(e.what()));
     };
 
-    is_loaded = true;
+    return result;
 }
 
 void CartManager::add_item(const int user_id, const int product_id,
                            const int count) {
+    TRACE_SCOPE("model", "CartManager::add_item");
 
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法添加新商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("INSERT INTO carts (user_id, product_id, count, status) "
-                 "VALUES (?, ?, ?, ?) "
-                 "ON DUPLICATE KEY UPDATE count = count + VALUES(count)")
+        Database::sql("INSERT INTO carts (user_id, product_id, count, status) "
+                      "VALUES (?, ?, ?, ?) "
+                      "ON DUPLICATE KEY UPDATE count = count + VALUES(count)")
             .bind(user_id, product_id, count,
                   static_cast<int>(CartItemStatus::NOT_ORDERED))
             .execute();
+        ChangeBus::get_instance().publish(CART_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("添加新商品失败: " + std::string(e.what()));
     }
@@ -61,46 +61,48 @@ void CartManager::add_item(const int user_id, const int product_id,
 
 void CartManager::update_item(const int user_id, const int product_id,
                               const int count, const int delivery_selection) {
+    TRACE_SCOPE("model", "CartManager::update_item");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法更新购物车商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE carts SET count = ?, delivery_selection = ? WHERE "
-                 "user_id = ? AND product_id = ? AND status = ?")
+        Database::sql("UPDATE carts SET count = ?, delivery_selection = ? "
+                      "WHERE user_id = ? AND product_id = ? AND status = ?")
             .bind(count, delivery_selection, user_id, product_id,
                   static_cast<int>(CartItemStatus::NOT_ORDERED))
             .execute();
+        ChangeBus::get_instance().publish(CART_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("更新购物车商品失败: " + std::string(e.what()));
     }
 }
 
 void CartManager::delete_item(const int user_id, const int product_id) {
+    TRACE_SCOPE("model", "CartManager::delete_item");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法删除购物车商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("DELETE FROM carts WHERE user_id = ? AND product_id = ? "
-                 "AND status = ?")
+        Database::sql("DELETE FROM carts WHERE user_id = ? AND product_id = ? "
+                      "AND status = ?")
             .bind(user_id, product_id,
                   static_cast<int>(CartItemStatus::DELETED))
             .execute();
 
-        Database::get_session()
-            .sql("UPDATE carts SET status = ? WHERE user_id = ? AND "
-                 "product_id = ?")
+        Database::sql("UPDATE carts SET status = ? WHERE user_id = ? AND "
+                      "product_id = ?")
             .bind(static_cast<int>(CartItemStatus::DELETED), user_id, product_id)
             .execute();
+        ChangeBus::get_instance().publish(CART_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("删除购物车商品失败: " + std::string(e.what()));
     }
 }
 
 std::vector<CartItem> CartManager::checkout(int user_id) {
+    TRACE_SCOPE("model", "CartManager::checkout");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法加载结账商品。");
     }
@@ -110,11 +112,10 @@ std::vector<CartItem> CartManager::checkout(int user_id) {
     std::vector<int> product_ids_to_delete;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT user_id, product_id, count, "
-                            "delivery_selection FROM carts "
-                            "WHERE user_id = ? AND status = ? "
-                            "AND delivery_selection != ?")
+        auto res = Database::sql("SELECT user_id, product_id, count, "
+                                 "delivery_selection FROM carts "
+                                 "WHERE user_id = ? AND status = ? "
+                                 "AND delivery_selection != ?")
                        .bind(user_id,
                              static_cast<int>(CartItemStatus::NOT_ORDERED), -1)
                        .execute();
@@ -139,3 +140,47 @@ std::vector<CartItem> CartManager::checkout(int user_id) {
 
     return items;
 }
+
+std::vector<CartItem>
+CartManager::checkout_items(const int user_id,
+                            const std::vector<CartItem> &items) {
+    TRACE_SCOPE("model", "CartManager::checkout_items");
+    if (!Database::is_connected()) {
+        LOG_ERROR("数据库未连接，无法结账购物车商品。");
+    }
+
+    std::vector<CartItem> taken;
+
+    for (const auto &item : items) {
+        try {
+            // 唯一键包含状态，先清理该商品此前留下的已删除记录
+            Database::sql("DELETE FROM carts WHERE user_id = ? AND "
+                          "product_id = ? AND status = ?")
+                .bind(user_id, item.product_id,
+                      static_cast<int>(CartItemStatus::DELETED))
+                .execute();
+
+            // 只有仍在购物车中的记录才会被改为已删除，重复的商品第二次不命中
+            auto res = Database::sql("UPDATE carts SET status = ?, count = ?, "
+                                     "delivery_selection = ? WHERE user_id = "
+                                     "? AND product_id = ? AND status = ?")
+                           .bind(static_cast<int>(CartItemStatus::DELETED),
+                                 item.count, item.delivery_selection, user_id,
+                                 item.product_id,
+                                 static_cast<int>(CartItemStatus::NOT_ORDERED))
+                           .execute();
+            if (res.getAffectedItemsCount() == 0)
+                continue;
+
+            taken.emplace_back(user_id, item.product_id, item.count,
+                               CartItemStatus::NOT_ORDERED,
+                               item.delivery_selection);
+        } catch (const mysqlx::Error &e) {
+            LOG_ERROR("结账购物车商品失败: " + std::string(e.what()));
+        }
+    }
+
+    if (!taken.empty())
+        ChangeBus::get_instance().publish(CART_CHANGED);
+    return taken;
+}
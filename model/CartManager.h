@@ -53,13 +53,6 @@ struct CartItem {
  * 管理购物车数据，提供商品添加、状态更新、持久化存储以及加载未下单商品到内存等功能
  */
 class CartManager {
-  private:
-    // 内存缓存：从数据库中导出的该用户未下单的购物车商品列表
-    std::vector<CartItem> cart_list;
-
-    // 标志位：当前用户的购物车数据是否已加载到内存
-    bool is_loaded = false;
-
   public:
     /**
      * @brief 构造函数
@@ -68,33 +61,14 @@ class CartManager {
     CartManager() = default;
 
     /**
-     * @brief 加载购物车数据
+     * @brief 从数据库读取购物车数据
      *
-     * 从数据库文件中筛选出指定用户且状态为未下单(NOT_ORDERED)的商品，加载到内存中
+     * 只访问数据库，可在后台线程调用，结果由 DataStore 在 UI 线程写入快照。
      *
      * @param user_id 用户 ID
-     * @return 无返回值
-     */
-    void load_cart(const int user_id);
-
-    /**
-     * @brief 获取购物车商品列表指针
-     *
-     * 获取内存中缓存的购物车列表。
-     *
-     * @return std::optional<std::vector<CartItem> *>
-     * 若已加载则返回列表指针，否则返回 nullopt
-     * @note 调用此函数前必须先调用 load_cart 确保数据已加载
+     * @return std::vector<CartItem> 该用户未下单的购物车商品
      */
-    std::optional<std::vector<CartItem> *> get_cart_list_ptr() {
-        if (is_loaded)
-            return &cart_list;
-        else {
-            LOG_CRITICAL("购物车列表未加载到内存");
-            throw std::runtime_error("购物车列表未加载到内存");
-            return std::nullopt;
-        }
-    }
+    std::vector<CartItem> fetch_cart(const int user_id) const;
 
     /**
      * @brief 添加商品到购物车
@@ -144,6 +118,20 @@ class CartManager {
      */
     std::vector<CartItem> checkout(int user_id);
 
+    /**
+     * @brief 按给定的商品结账
+     *
+     * 只结算 items 中仍在购物车里（未下单）的商品：写入最终的数量与配送方式
+     * 并移出购物车。购物车中的其他商品不受影响，即使已选择了配送方式；
+     * 已被删除或在 items 中重复出现的商品不会返回。
+     *
+     * @param user_id 用户 ID
+     * @param items 已预留库存的商品（product_id、count、delivery_selection）
+     * @return std::vector<CartItem> 实际移出购物车、应生成订单的商品
+     */
+    std::vector<CartItem> checkout_items(const int user_id,
+                                         const std::vector<CartItem> &items);
+
     // 析构器
     ~CartManager() {}
 };
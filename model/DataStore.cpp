@@ -0,0 +1,249 @@
+#include "DataStore.h"
+#include "Trace.h"
+#include <algorithm>
+#include <unordered_set>
+
+void DataStore::merge_products(const std::vector<Product> &products) {
+    if (products.empty())
+        return;
+
+    ProductTable table = *product_table;
+    for (const auto &p : products)
+        table[p.product_id] = p;
+    replace(product_table, std::move(table));
+}
+
+const Product *DataStore::find_product(const int product_id) const {
+    auto it = product_table->find(product_id);
+    if (it != product_table->end())
+        return &it->second;
+
+    // 目录中包含已删除的商品，只返回有效商品
+    const Product *p = catalog ? catalog->find(product_id) : nullptr;
+    return p && p->status == ProductStatus::NORMAL ? p : nullptr;
+}
+
+ProductSearchResult DataStore::fetch_products(const std::string &query) const {
+    TRACE_SCOPE("model", "DataStore::fetch_products");
+    return product_manager.search_product(query);
+}
+
+CartLoad DataStore::fetch_cart(const int user_id,
+                               const KnownProducts &known) const {
+    TRACE_SCOPE("model", "DataStore::fetch_cart");
+    CartLoad load;
+    load.items = cart_manager.fetch_cart(user_id);
+
+    // 只读取商品表中还没有的商品
+    std::unordered_set<int> fetched;
+    for (const auto &item : load.items) {
+        if (known.contains(item.product_id) ||
+            !fetched.insert(item.product_id).second)
+            continue;
+        auto product_opt = product_manager.get_product(item.product_id);
+        if (product_opt.has_value())
+            load.products.push_back(product_opt.value());
+    }
+    return load;
+}
+
+OrderLoad DataStore::fetch_orders(const int user_id,
+                                  const KnownProducts &known) const {
+    TRACE_SCOPE("model", "DataStore::fetch_orders");
+    OrderLoad load;
+    load.orders = order_manager.fetch_full_orders(user_id, product_manager);
+
+    std::unordered_set<int> fetched;
+    for (const auto &entry : load.orders) {
+        for (const auto &item : entry.second.items) {
+            if (known.contains(item.product_id) ||
+                !fetched.insert(item.product_id).second)
+                continue;
+            auto product_opt = product_manager.get_product(item.product_id);
+            if (product_opt.has_value())
+                load.products.push_back(product_opt.value());
+        }
+    }
+    return load;
+}
+
+HistoryTable DataStore::fetch_history(const int user_id) const {
+    TRACE_SCOPE("model", "DataStore::fetch_history");
+    return history_order_manager.fetch_history_orders(user_id,
+                                                      product_manager);
+}
+
+void DataStore::apply_products(const ProductSearchResult &result) {
+    if (!result.get_catalog() || result.get_catalog() == catalog)
+        return;
+
+    catalog = result.get_catalog();
+    replace(product_table, ProductTable{});
+}
+
+void DataStore::apply_cart(CartLoad &load) {
+    merge_products(load.products);
+    replace(cart_table, std::move(load.items));
+}
+
+void DataStore::apply_orders(OrderLoad &load) {
+    merge_products(load.products);
+    replace(order_table, std::move(load.orders));
+}
+
+void DataStore::apply_history(HistoryTable &history) {
+    replace(history_table, std::move(history));
+}
+
+void DataStore::add_to_cart(const int user_id, const int product_id,
+                            const int count) {
+    TRACE_SCOPE("model", "DataStore::add_to_cart");
+    cart_manager.add_item(user_id, product_id, count);
+
+    CartTable items = *cart_table;
+    auto it = std::find_if(items.begin(), items.end(), [&](const CartItem &i) {
+        return i.product_id == product_id;
+    });
+    if (it != items.end())
+        it->count += count;
+    else
+        items.emplace_back(user_id, product_id, count);
+    replace(cart_table, std::move(items));
+}
+
+void DataStore::remove_from_cart(const int user_id, const int product_id) {
+    TRACE_SCOPE("model", "DataStore::remove_from_cart");
+    cart_manager.delete_item(user_id, product_id);
+
+    CartTable items = *cart_table;
+    items.erase(std::remove_if(items.begin(), items.end(),
+                               [&](const CartItem &i) {
+                                   return i.product_id == product_id;
+                               }),
+                items.end());
+    replace(cart_table, std::move(items));
+}
+
+void DataStore::checkout(const int user_id,
+                         const std::vector<CartItem> &selected,
+                         const std::string &address) {
+    TRACE_SCOPE("model", "DataStore::checkout");
+
+    // 库存不足的商品留在购物车中
+    auto ordered_cart_lists =
+        order_manager
+            .purchase(user_id, selected, address, cart_manager,
+                      product_manager, history_order_manager, "app")
+            .ordered;
+    if (ordered_cart_lists.empty())
+        return;
+
+    std::vector<Product> stock_updates;
+    for (const auto &item : ordered_cart_lists) {
+        const Product *cached = find_product(item.product_id);
+        if (cached) {
+            Product p = *cached;
+            p.stock -= item.count;
+            stock_updates.push_back(p);
+        }
+    }
+
+    // 已下单的商品移出购物车；新订单由变更事件触发重新读取
+    merge_products(stock_updates);
+    CartTable items = *cart_table;
+    items.erase(std::remove_if(items.begin(), items.end(),
+                               [&](const CartItem &i) {
+                                   return std::any_of(
+                                       ordered_cart_lists.begin(),
+                                       ordered_cart_lists.end(),
+                                       [&](const CartItem &o) {
+                                           return o.product_id ==
+                                                  i.product_id;
+                                       });
+                               }),
+                items.end());
+    replace(cart_table, std::move(items));
+}
+
+void DataStore::cancel_order(const long long order_id) {
+    TRACE_SCOPE("model", "DataStore::cancel_order");
+    // 订单已完成或已被取消（如重复点击）时不恢复库存、不改动缓存
+    if (!order_manager.cancel_order(order_id, product_manager))
+        return;
+    history_order_manager.cancel_history_order(order_id, product_manager);
+
+    auto order_it = order_table->find(order_id);
+    if (order_it == order_table->end())
+        return;
+
+    // 恢复已缓存商品的库存
+    std::vector<Product> stock_updates;
+    for (const auto &item : order_it->second.items) {
+        const Product *p = find_product(item.product_id);
+        if (p) {
+            Product restored = *p;
+            restored.stock += item.count;
+            stock_updates.push_back(restored);
+        }
+    }
+    merge_products(stock_updates);
+
+    OrderTable orders = *order_table;
+    orders[order_id].status = FullOrderStatus::CANCEL;
+    replace(order_table, std::move(orders));
+
+    if (history_table->count(order_id)) {
+        HistoryTable history = *history_table;
+        history[order_id].status = FullOrderStatus::CANCEL;
+        replace(history_table, std::move(history));
+    }
+}
+
+void DataStore::update_order_info(const long long order_id,
+                                  const std::string &new_address,
+                                  const int new_delivery_selection) {
+    TRACE_SCOPE("model", "DataStore::update_order_info");
+    order_manager.update_order_info(order_id, new_address,
+                                    new_delivery_selection);
+    history_order_manager.update_history_order_info(order_id, new_address,
+                                                    new_delivery_selection);
+
+    // 订单与历史订单的聚合字段按相同规则修改
+    auto patch = [&](auto &order) {
+        if (!new_address.empty()) {
+            order.address = new_address;
+            for (auto &item : order.items)
+                item.address = new_address;
+        }
+        if (new_delivery_selection != -1 && !order.items.empty()) {
+            int old_selection = order.items[0].delivery_selection;
+            order.total_price += DELIVERY_PRICES[new_delivery_selection] -
+                                 DELIVERY_PRICES[old_selection];
+            for (auto &item : order.items)
+                item.delivery_selection = new_delivery_selection;
+        }
+    };
+
+    if (order_table->count(order_id)) {
+        OrderTable orders = *order_table;
+        patch(orders[order_id]);
+        replace(order_table, std::move(orders));
+    }
+    if (history_table->count(order_id)) {
+        HistoryTable history = *history_table;
+        patch(history[order_id]);
+        replace(history_table, std::move(history));
+    }
+}
+
+void DataStore::clear_history(const int user_id) {
+    TRACE_SCOPE("model", "DataStore::clear_history");
+    history_order_manager.delete_all_history_orders(user_id);
+    replace(history_table, HistoryTable{});
+}
+
+void DataStore::clear_user_data() {
+    replace(cart_table, CartTable{});
+    replace(order_table, OrderTable{});
+    replace(history_table, HistoryTable{});
+}
@@ -0,0 +1,269 @@
+/**
+ * @file      DataStore.h
+ * @brief     应用数据仓库头文件
+ * @details   统一持有商品、购物车、订单与历史订单数据的唯一一份缓存。
+ *            商品以目录快照为主，另按 ID 存放目录之外读取或修改过的商品，
+ *            每类数据带版本号，
+ *            以不可变快照的形式提供给界面渲染；所有写操作也经由仓库统一执行。
+ */
+
+#pragma once
+#include "CartManager.h"
+#include "HistoryOrderManager.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 带版本号的不可变数据快照
+ *
+ * 快照内容一经发布不再修改，写入时整体替换为新快照并递增版本号，
+ * 因此可以安全地交给后台线程读取或跨帧持有。
+ *
+ * @tparam T 数据类型
+ */
+template <typename T> struct Snapshot {
+    uint64_t version = 0; ///< 版本号，每次替换递增（0 表示尚未加载）
+    std::shared_ptr<const T> data = std::make_shared<const T>(); ///< 数据
+
+    const T &operator*() const { return *data; }
+    const T *operator->() const { return data.get(); }
+};
+
+using ProductTable = std::unordered_map<int, Product>;       ///< 商品 ID -> 商品
+using CartTable = std::vector<CartItem>;                     ///< 购物车条目
+using OrderTable = std::map<long long, FullOrder>;           ///< 订单号 -> 订单
+using HistoryTable = std::map<long long, HistoryFullOrder>; ///< 订单号 -> 历史订单
+
+/**
+ * @brief 仓库中已有商品的只读视图（供后台读取时跳过已有商品）
+ *
+ */
+struct KnownProducts {
+    Snapshot<ProductTable> table;           ///< 目录之外的商品
+    std::shared_ptr<const Catalog> catalog; ///< 商品目录快照（可能为空）
+
+    bool contains(const int product_id) const {
+        return table->count(product_id) ||
+               (catalog && catalog->find(product_id));
+    }
+};
+
+/**
+ * @brief 后台读取的购物车数据（含仓库中尚未缓存的商品）
+ *
+ */
+struct CartLoad {
+    CartTable items;
+    std::vector<Product> products;
+};
+
+/**
+ * @brief 后台读取的订单数据（含仓库中尚未缓存的商品）
+ *
+ */
+struct OrderLoad {
+    OrderTable orders;
+    std::vector<Product> products;
+};
+
+/**
+ * @brief 应用数据仓库
+ *
+ * 线程约定：快照的读取、apply_* 与写操作只在 UI 线程调用；
+ * fetch_* 只访问数据库、不修改仓库，可在后台线程调用。
+ */
+class DataStore {
+  private:
+    ProductManager &product_manager;
+    CartManager &cart_manager;
+    OrderManager &order_manager;
+    HistoryOrderManager &history_order_manager;
+
+    // 商品目录快照：最近一次商品搜索结果所引用的目录
+    std::shared_ptr<const Catalog> catalog;
+
+    // 目录之外的商品（购物车、订单中读取的商品及写入后修改过的商品），
+    // 查找时优先于目录
+    Snapshot<ProductTable> product_table;
+    Snapshot<CartTable> cart_table;
+    Snapshot<OrderTable> order_table;
+    Snapshot<HistoryTable> history_table;
+
+    // 辅助函数：用新数据替换快照并递增版本号
+    template <typename T> static void replace(Snapshot<T> &slot, T data) {
+        slot.data = std::make_shared<const T>(std::move(data));
+        slot.version++;
+    }
+
+    // 辅助函数：把商品合并进商品表（已存在的按 ID 覆盖）
+    void merge_products(const std::vector<Product> &products);
+
+  public:
+    /**
+     * @brief 构造函数
+     *
+     * @param product_manager 商品管理器
+     * @param cart_manager 购物车管理器
+     * @param order_manager 订单管理器
+     * @param history_order_manager 历史订单管理器
+     */
+    DataStore(ProductManager &product_manager, CartManager &cart_manager,
+              OrderManager &order_manager,
+              HistoryOrderManager &history_order_manager)
+        : product_manager(product_manager), cart_manager(cart_manager),
+          order_manager(order_manager),
+          history_order_manager(history_order_manager) {}
+
+    DataStore(const DataStore &) = delete;
+    DataStore &operator=(const DataStore &) = delete;
+
+    // --- 快照读取（UI 线程） ---
+
+    const Snapshot<ProductTable> &products() const { return product_table; }
+    const Snapshot<CartTable> &cart() const { return cart_table; }
+    const Snapshot<OrderTable> &orders() const { return order_table; }
+    const Snapshot<HistoryTable> &history() const { return history_table; }
+
+    /**
+     * @brief 按 ID 查找已缓存的有效商品
+     *
+     * @param product_id 商品 ID
+     * @return const Product* 找到返回指针（在下次写入商品数据前有效），否则
+     * nullptr
+     */
+    const Product *find_product(const int product_id) const;
+
+    /**
+     * @brief 获取已有商品的只读视图，交给后台读取使用
+     *
+     * @return KnownProducts 当前商品表快照与目录快照
+     */
+    KnownProducts known_products() const { return {product_table, catalog}; }
+
+    // --- 后台读取（工作线程，不修改仓库） ---
+
+    /**
+     * @brief 搜索有效商品
+     *
+     * @param query 搜索关键词
+     * @return ProductSearchResult 匹配的商品（引用目录快照，不拷贝商品）
+     */
+    ProductSearchResult fetch_products(const std::string &query) const;
+
+    /**
+     * @brief 读取用户购物车及其中尚未缓存的商品
+     *
+     * @param user_id 用户 ID
+     * @param known 发起读取时已有的商品（不再读取）
+     * @return CartLoad 读取结果
+     */
+    CartLoad fetch_cart(const int user_id, const KnownProducts &known) const;
+
+    /**
+     * @brief 读取用户订单及其中尚未缓存的商品
+     *
+     * @param user_id 用户 ID
+     * @param known 发起读取时已有的商品（不再读取）
+     * @return OrderLoad 读取结果
+     */
+    OrderLoad fetch_orders(const int user_id,
+                           const KnownProducts &known) const;
+
+    /**
+     * @brief 读取用户历史订单
+     *
+     * @param user_id 用户 ID
+     * @return HistoryTable 读取结果
+     */
+    HistoryTable fetch_history(const int user_id) const;
+
+    // --- 应用读取结果（UI 线程） ---
+
+    /**
+     * @brief 采用搜索结果所引用的目录快照
+     *
+     * 目录是商品写入后重新加载的，比商品表中的条目新，商品表随之清空。
+     *
+     * @param result 搜索结果
+     */
+    void apply_products(const ProductSearchResult &result);
+
+    void apply_cart(CartLoad &load);
+
+    void apply_orders(OrderLoad &load);
+
+    void apply_history(HistoryTable &history);
+
+    // --- 写操作（UI 线程） ---
+    // 写入数据库后立即更新仓库中能确定结果的部分，其余由变更事件触发重新读取
+
+    /**
+     * @brief 添加商品到购物车
+     *
+     * @param user_id 用户 ID
+     * @param product_id 商品 ID
+     * @param count 数量
+     */
+    void add_to_cart(const int user_id, const int product_id, const int count);
+
+    /**
+     * @brief 从购物车移除商品
+     *
+     * @param user_id 用户 ID
+     * @param product_id 商品 ID
+     */
+    void remove_from_cart(const int user_id, const int product_id);
+
+    /**
+     * @brief 结算购物车中选中的商品
+     *
+     * 扣减库存、生成订单及历史订单快照。只有预留到库存且仍在购物车中的
+     * 选中商品才会下单；库存不足的商品不扣减、不下单，留在购物车中；
+     * 预留后发现已不在购物车中的商品归还库存。
+     *
+     * @param user_id 用户 ID
+     * @param selected 选中的商品（product_id、count、delivery_selection）
+     * @param address 收货地址
+     */
+    void checkout(const int user_id, const std::vector<CartItem> &selected,
+                  const std::string &address);
+
+    /**
+     * @brief 取消订单（恢复库存，同步历史订单状态）
+     *
+     * 订单已完成或已被取消时不做任何修改。
+     *
+     * @param order_id 订单号
+     */
+    void cancel_order(const long long order_id);
+
+    /**
+     * @brief 修改订单地址或配送方式（同步历史订单）
+     *
+     * @param order_id 订单号
+     * @param new_address 新地址（空字符串表示不修改）
+     * @param new_delivery_selection 新配送方式（-1 表示不修改）
+     */
+    void update_order_info(const long long order_id,
+                           const std::string &new_address,
+                           const int new_delivery_selection);
+
+    /**
+     * @brief 清除用户的全部历史订单
+     *
+     * @param user_id 用户 ID
+     */
+    void clear_history(const int user_id);
+
+    /**
+     * @brief 清空用户相关数据（注销时调用，商品表保留）
+     *
+     */
+    void clear_user_data();
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include "Logger.h"
+#include "Trace.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 后台任务执行器：固定数量的工作线程按提交顺序执行任务，
+// 用于把数据库读取等耗时操作移出 UI 事件循环；
+// 每个工作线程持有自己的数据库会话，线程数即会话数上限
+class Executor {
+  private:
+    std::vector<std::thread> workers;
+
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    void worker_loop(const unsigned int index) {
+        Trace::Recorder::get_instance().set_thread_name(
+            "executor-" + std::to_string(index));
+
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping)
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            // 任务中的异常不能让工作线程退出
+            try {
+                task();
+            } catch (const std::exception &e) {
+                LOG_ERROR("后台任务执行失败: " + std::string(e.what()));
+            } catch (...) {
+                LOG_ERROR("后台任务执行失败: 未知异常");
+            }
+        }
+    }
+
+  public:
+    // 默认两个工作线程：一个慢查询不会挡住其他页面的加载
+    explicit Executor(const unsigned int thread_count = 2) {
+        unsigned int count = thread_count == 0 ? 1 : thread_count;
+        for (unsigned int i = 0; i < count; i++)
+            workers.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    ~Executor() { shutdown(); }
+
+    // 提交任务（已停止时丢弃）
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (stopping)
+                return;
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+    // 停止执行器：丢弃尚未开始的任务，等待正在执行的任务结束
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+            tasks.clear();
+        }
+        cv.notify_all();
+        for (auto &worker : workers) {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+};
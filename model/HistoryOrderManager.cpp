@@ -1,26 +1,28 @@
 #include "HistoryOrderManager.h"
+#include "ChangeBus.h"
 #include "Database.h"
+#include "Trace.h"
 
 using std::string;
 
-void HistoryOrderManager::load_history_orders(const int user_id,
-                                              ProductManager &product_manager) {
+std::map<long long, HistoryFullOrder>
+HistoryOrderManager::fetch_history_orders(const int user_id,
+                                          ProductManager &product_manager) {
+    TRACE_SCOPE("model", "HistoryOrderManager::fetch_history_orders");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法加载历史订单信息到内存。");
     }
 
     check_and_update_arrived_orders(user_id);
 
-    history_orders_map.clear();
-    is_loaded = false;
+    std::map<long long, HistoryFullOrder> history_orders_map;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT user_id, product_name, order_id, price, "
-                            "count, UNIX_TIMESTAMP(order_time) AS "
-                            "order_time_unix, delivery_selection, address, "
-                            "status FROM history_orders "
-                            "WHERE user_id = ? AND status IN (1, -1)")
+        auto res = Database::sql("SELECT user_id, product_name, order_id, "
+                                 "price, count, UNIX_TIMESTAMP(order_time) AS "
+                                 "order_time_unix, delivery_selection, "
+                                 "address, status FROM history_orders WHERE "
+                                 "user_id = ? AND status IN (1, -1)")
                        .bind(user_id)
                        .execute();
         while (auto row = res.fetchOne()) {
@@ -68,13 +70,14 @@ void HistoryOrderManager::load_history_orders(const int user_id,
         LOG_ERROR("加载历史订单到内存失败");
     }
 
-    is_loaded = true;
+    return history_orders_map;
 }
 
 void HistoryOrderManager::add_history_order(const int user_id,
                                             ProductManager &product_manager,
                                             std::vector<CartItem> cart_lists,
                                             const std::string address) {
+    TRACE_SCOPE("model", "HistoryOrderManager::add_history_order");
 
     std::vector<HistoryOrderItem> history_order_list;
 
@@ -93,16 +96,17 @@ void HistoryOrderManager::add_history_order(const int user_id,
 
             auto pro_info = product_opt.value();
 
-            Database::get_session()
-                .sql("INSERT INTO history_orders (user_id, product_name, price, "
-                     "order_id, count, order_time, delivery_selection, address, "
-                     "status) VALUES(?, ?, ?, ?, ?, CURRENT_TIMESTAMP, ?, ?, ?)")
+            Database::sql("INSERT INTO history_orders (user_id, product_name, "
+                          "price, order_id, count, order_time, "
+                          "delivery_selection, address, status) VALUES(?, ?, "
+                          "?, ?, ?, CURRENT_TIMESTAMP, ?, ?, ?)")
                 .bind(cart_item.id, pro_info.product_name, pro_info.price,
                       cart_item.id + static_cast<int64_t>(time),
                       cart_item.count, cart_item.delivery_selection, address,
                       static_cast<int>(FullOrderStatus::NOT_COMPLETED))
                 .execute();
         }
+        ChangeBus::get_instance().publish(HISTORY_ORDER_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("添加历史订单失败: " + std::string(e.what()));
     }
@@ -143,7 +147,7 @@ void HistoryOrderManager::update_history_order(
 
         sql += "WHERE order_id = ? ";
 
-        auto stmt = Database::get_session().sql(sql);
+        auto stmt = Database::sql(sql);
         if (new_status.has_value())
             stmt.bind(static_cast<int>(new_status.value()));
         if (new_address.has_value())
@@ -152,6 +156,7 @@ void HistoryOrderManager::update_history_order(
             stmt.bind(new_delivery.value());
         stmt.bind(order_id);
         stmt.execute();
+        ChangeBus::get_instance().publish(HISTORY_ORDER_CHANGED);
 
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("更新数据库中的历史订单失败: " + std::string(e.what()));
@@ -160,6 +165,7 @@ void HistoryOrderManager::update_history_order(
 
 void HistoryOrderManager::cancel_history_order(
     const long long order_id, ProductManager &product_manager) {
+    TRACE_SCOPE("model", "HistoryOrderManager::cancel_history_order");
     return update_history_order(order_id, FullOrderStatus::CANCEL, std::nullopt,
                                 std::nullopt);
 }
@@ -167,6 +173,7 @@ void HistoryOrderManager::cancel_history_order(
 void HistoryOrderManager::update_history_order_info(
     const long long order_id, const std::string &new_address,
     const int new_delivery_selection) {
+    TRACE_SCOPE("model", "HistoryOrderManager::update_history_order_info");
     if (new_address.empty()) {
         return update_history_order(order_id, std::nullopt, std::nullopt,
                                     new_delivery_selection);
@@ -181,6 +188,8 @@ void HistoryOrderManager::update_history_order_info(
 }
 
 void HistoryOrderManager::check_and_update_arrived_orders(int user_id) {
+    TRACE_SCOPE("model",
+                "HistoryOrderManager::check_and_update_arrived_orders");
 
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法更新到达的历史订单状态。");
@@ -203,8 +212,7 @@ void HistoryOrderManager::check_and_update_arrived_orders(int user_id) {
 
         sql += "ELSE 3153600000 END) <= ?";
 
-        Database::get_session()
-            .sql(sql)
+        Database::sql(sql)
             .bind(static_cast<int>(FullOrderStatus::COMPLETED), user_id,
                   static_cast<int>(FullOrderStatus::NOT_COMPLETED),
                   static_cast<int64_t>(now))
@@ -216,16 +224,17 @@ void HistoryOrderManager::check_and_update_arrived_orders(int user_id) {
 }
 
 void HistoryOrderManager::delete_all_history_orders(const int user_id) {
+    TRACE_SCOPE("model", "HistoryOrderManager::delete_all_history_orders");
 
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法删除数据库中的历史订单。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE history_orders SET status = ? WHERE user_id = ?")
+        Database::sql("UPDATE history_orders SET status = ? WHERE user_id = ?")
             .bind(static_cast<int>(FullOrderStatus::DELETED), user_id)
             .execute();
+        ChangeBus::get_instance().publish(HISTORY_ORDER_CHANGED);
 
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("更新数据库中的历史订单失败: " + std::string(e.what()));
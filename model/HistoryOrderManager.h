@@ -72,12 +72,6 @@ struct HistoryFullOrder {
  */
 class HistoryOrderManager {
   private:
-    // 内存缓存：历史订单映射表 (key: order_id)
-    std::map<long long, HistoryFullOrder> history_orders_map;
-
-    // 标志位：当前用户的历史数据是否已加载
-    bool is_loaded = false;
-
     // 配送时间映射 (索引对应配送方式 0, 1, 2)
     // 0: 普通(5天), 1: 普快(3天), 2: 特快(1天)
     const std::vector<int> DELIVERY_DAYS = {5, 3, 1};
@@ -112,17 +106,17 @@ class HistoryOrderManager {
     void check_and_update_arrived_orders(int user_id);
 
     /**
-     * @brief 加载历史订单
+     * @brief 从数据库读取并聚合历史订单
      *
-     * 读取属于该用户的历史记录，过滤出 COMPLETED 或 CANCEL 状态的订单，
-     * 并聚合到内存 map 中供 UI 调用。
+     * 读取属于该用户的历史记录，过滤出 COMPLETED 或 CANCEL 状态的订单并聚合。
+     * 只访问数据库（含自动收货的状态更新），可在后台线程调用。
      *
      * @param user_id 用户 ID
-     * @param product_manager 商品管理器引用（预留接口，目前主要使用快照数据）
-     * @return 无返回值
+     * @param product_manager 商品管理器引用
+     * @return std::map<long long, HistoryFullOrder> 聚合后的历史订单
      */
-    void load_history_orders(const int user_id,
-                             ProductManager &product_manager);
+    std::map<long long, HistoryFullOrder>
+    fetch_history_orders(const int user_id, ProductManager &product_manager);
 
     /**
      * @brief 添加历史订单
@@ -169,29 +163,13 @@ class HistoryOrderManager {
      * @brief 删除指定用户的所有历史订单（逻辑删除）
      *
      * 将该用户所有的历史订单项状态更新为 DELETED。
-     * 这些记录仍在数据库文件中，但不再会被 load_history_orders 加载。
+     * 这些记录仍在数据库文件中，但不再会被 fetch_history_orders 读取。
      *
      * @param user_id 用户 ID
      * @return 无返回值
      */
     void delete_all_history_orders(const int user_id);
 
-    /**
-     * @brief 获取历史订单映射指针
-     *
-     * @return std::optional<std::map<long long, HistoryFullOrder> *>
-     * 若已加载返回指针，否则返回 nullopt
-     */
-    std::optional<std::map<long long, HistoryFullOrder> *>
-    get_history_map_ptr() {
-        if (is_loaded)
-            return &history_orders_map;
-        else {
-            LOG_CRITICAL("历史订单列表未加载到内存");
-            throw std::runtime_error("历史订单列表未加载到内存");
-            return std::nullopt;
-        }
-    }
     // 析构器
     ~HistoryOrderManager() {}
 };
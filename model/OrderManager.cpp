@@ -1,29 +1,35 @@
 #include "OrderManager.h"
 #include "CartManager.h"
+#include "ChangeBus.h"
 #include "Database.h"
+#include "HistoryOrderManager.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <algorithm>
 #include <string>
 
 using std::nullopt;
 using std::optional;
 using std::string;
 
-void OrderManager::load_full_orders(const int user_id,
-                                    ProductManager &product_manager) {
+std::map<long long, FullOrder>
+OrderManager::fetch_full_orders(const int user_id,
+                                ProductManager &product_manager) {
+    TRACE_SCOPE("model", "OrderManager::fetch_full_orders");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法加载订单到内存。");
     }
 
     check_and_update_arrived_orders(user_id);
 
-    orders_map.clear();
-    is_loaded = false;
+    std::vector<OrderItem> items;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT user_id, product_id, order_id, count, "
-                            "UNIX_TIMESTAMP(order_time) AS order_time_unix, "
-                            "delivery_selection, address, status FROM orders "
-                            "WHERE user_id = ? AND status = ?")
+        auto res = Database::sql("SELECT user_id, product_id, order_id, count, "
+                                 "UNIX_TIMESTAMP(order_time) AS "
+                                 "order_time_unix, delivery_selection, "
+                                 "address, status FROM orders WHERE user_id = "
+                                 "? AND status = ?")
                        .bind(user_id,
                              static_cast<int>(FullOrderStatus::NOT_COMPLETED))
                        .execute();
@@ -40,36 +46,48 @@ void OrderManager::load_full_orders(const int user_id,
                 temp.address = row[6].get<std::string>();
                 temp.status = static_cast<FullOrderStatus>(row[7].get<int>());
 
-                FullOrder &order = orders_map[temp.order_id];
+                items.push_back(std::move(temp));
+            }
+        }
 
-                double item_price =
-                    product_manager.get_price_by_id(temp.product_id);
-                order.total_price += temp.count * item_price;
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("加载订单到内存失败");
+    }
 
-                if (order.items.empty()) {
-                    order.total_price +=
-                        DELIVERY_PRICES[temp.delivery_selection];
-                    order.order_id = temp.order_id;
-                    order.order_time = temp.order_time;
+    return aggregate_orders(items, [&product_manager](const int product_id) {
+        return product_manager.get_price_by_id(product_id);
+    });
+}
 
-                    order.address = temp.address;
-                    order.status = temp.status;
-                }
+std::map<long long, FullOrder> OrderManager::aggregate_orders(
+    const std::vector<OrderItem> &items,
+    const std::function<double(const int)> &price_of) {
+    std::map<long long, FullOrder> orders_map;
 
-                order.items.push_back(temp);
-            }
+    for (const auto &item : items) {
+        FullOrder &order = orders_map[item.order_id];
+
+        order.total_price += item.count * price_of(item.product_id);
+
+        if (order.items.empty()) {
+            order.total_price += DELIVERY_PRICES[item.delivery_selection];
+            order.order_id = item.order_id;
+            order.order_time = item.order_time;
+
+            order.address = item.address;
+            order.status = item.status;
         }
 
-    } catch (const mysqlx::Error &e) {
-        LOG_ERROR("加载订单到内存失败");
+        order.items.push_back(item);
     }
 
-    is_loaded = true;
+    return orders_map;
 }
 
 void OrderManager::add_order(const int user_id,
                              std::vector<CartItem> cart_lists,
                              const std::string address) {
+    TRACE_SCOPE("model", "OrderManager::add_order");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法添加订单到数据库。");
     }
@@ -83,21 +101,68 @@ void OrderManager::add_order(const int user_id,
                                 cart_item.delivery_selection, address,
                                 FullOrderStatus::NOT_COMPLETED);
 
-            Database::get_session()
-                .sql("INSERT INTO orders (user_id, product_id, order_id, "
-                     "count, order_time, delivery_selection, address, status) "
-                     "values(?, ?, ?, ?, CURRENT_TIMESTAMP, ?, ?, ?)")
+            Database::sql("INSERT INTO orders (user_id, product_id, order_id, "
+                          "count, order_time, delivery_selection, address, "
+                          "status) values(?, ?, ?, ?, CURRENT_TIMESTAMP, ?, ?, "
+                          "?)")
                 .bind(cart_item.id, cart_item.product_id,
                       cart_item.id + static_cast<int64_t>(time),
                       cart_item.count, cart_item.delivery_selection, address,
                       static_cast<int>(FullOrderStatus::NOT_COMPLETED))
                 .execute();
         }
+        ChangeBus::get_instance().publish(ORDER_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("添加新订单失败: " + std::string(e.what()));
     }
 }
 
+PurchaseResult OrderManager::purchase(
+    const int user_id, const std::vector<CartItem> &selected,
+    const std::string &address, CartManager &cart_manager,
+    ProductManager &product_manager, HistoryOrderManager &history_order_manager,
+    const std::string &source, const bool all_or_nothing) {
+    TRACE_SCOPE("model", "OrderManager::purchase");
+    Metrics::ScopedTimer timer(Metrics::Registry::get_instance().histogram(
+        "shopping_checkout_seconds", "结账（扣库存、生成订单）的耗时",
+        {{"source", source}}));
+    PurchaseResult result;
+
+    // 在数据库中原子扣减库存，其他进程同时购买同一商品也不会超卖
+    std::vector<CartItem> reserved;
+    for (const auto &item : selected) {
+        if (item.count > 0 &&
+            product_manager.adjust_stock(item.product_id, -item.count)) {
+            reserved.push_back(item);
+        } else if (all_or_nothing) {
+            for (const auto &r : reserved)
+                product_manager.adjust_stock(r.product_id, r.count);
+            result.rejected_product_id = item.product_id;
+            return result;
+        }
+    }
+
+    // 只结算预留到库存且仍在购物车中的商品，其余归还库存
+    result.ordered = cart_manager.checkout_items(user_id, reserved);
+    for (const auto &o : result.ordered) {
+        auto it = std::find_if(
+            reserved.begin(), reserved.end(), [&](const CartItem &r) {
+                return r.product_id == o.product_id && r.count == o.count;
+            });
+        if (it != reserved.end())
+            reserved.erase(it);
+    }
+    for (const auto &item : reserved)
+        product_manager.adjust_stock(item.product_id, item.count);
+
+    if (!result.ordered.empty()) {
+        add_order(user_id, result.ordered, address);
+        history_order_manager.add_history_order(user_id, product_manager,
+                                                result.ordered, address);
+    }
+    return result;
+}
+
 void OrderManager::update_order(const long long order_id,
                                 std::optional<FullOrderStatus> new_status,
                                 std::optional<std::string> new_address,
@@ -133,7 +198,7 @@ void OrderManager::update_order(const long long order_id,
 
         sql += "WHERE order_id = ? ";
 
-        auto stmt = Database::get_session().sql(sql);
+        auto stmt = Database::sql(sql);
         if (new_status.has_value())
             stmt.bind(static_cast<int>(new_status.value()));
         if (new_address.has_value())
@@ -142,6 +207,7 @@ void OrderManager::update_order(const long long order_id,
             stmt.bind(new_delivery.value());
         stmt.bind(order_id);
         stmt.execute();
+        ChangeBus::get_instance().publish(ORDER_CHANGED);
 
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("更新数据库中的订单失败: " + std::string(e.what()));
@@ -149,43 +215,59 @@ void OrderManager::update_order(const long long order_id,
 }
 
 void OrderManager::update_stock_by_order_id(const long long order_id,
-                                            ProductManager product_manager) {
+                                            ProductManager &product_manager) {
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法更新数据库中的库存。");
     }
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT product_id, count FROM orders "
-                            "WHERE order_id = ?")
+        auto res = Database::sql("SELECT product_id, count FROM orders "
+                                 "WHERE order_id = ?")
                        .bind(static_cast<int64_t>(order_id))
                        .execute();
         while (auto row = res.fetchOne()) {
             int product_id = row[0].get<int>();
             int buy_count = row[1].get<int>();
 
-            auto p_opt = product_manager.get_product(product_id);
-            if (p_opt.has_value()) {
-                auto &p = p_opt.value();
-                product_manager.update_product(p.product_name, product_id,
-                                               p.price, p.stock + buy_count);
-            }
+            product_manager.adjust_stock(product_id, buy_count);
         }
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("无法更新数据库商品库存");
     }
 }
 
-void OrderManager::cancel_order(const long long order_id,
+bool OrderManager::cancel_order(const long long order_id,
                                 ProductManager &product_manager) {
+    TRACE_SCOPE("model", "OrderManager::cancel_order");
+    if (!Database::is_connected()) {
+        LOG_ERROR("数据库未连接，无法取消订单。");
+    }
+
+    // 只有把订单从未完成改为取消的一方恢复库存，
+    // 同一订单被并发或重复取消时库存只恢复一次
+    try {
+        auto res = Database::sql("UPDATE orders SET status = ? "
+                                 "WHERE order_id = ? AND status = ?")
+                       .bind(static_cast<int>(FullOrderStatus::CANCEL),
+                             static_cast<int64_t>(order_id),
+                             static_cast<int>(FullOrderStatus::NOT_COMPLETED))
+                       .execute();
+        if (res.getAffectedItemsCount() == 0)
+            return false;
+        ChangeBus::get_instance().publish(ORDER_CHANGED);
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("取消订单失败: " + std::string(e.what()));
+        return false;
+    }
+
     update_stock_by_order_id(order_id, product_manager);
-    return update_order(order_id, FullOrderStatus::CANCEL, std::nullopt,
-                        std::nullopt);
+    return true;
 }
 
 void OrderManager::update_order_info(const long long order_id,
                                      const std::string &new_address,
                                      const int new_delivery_selection) {
+    TRACE_SCOPE("model", "OrderManager::update_order_info");
     if (new_address.empty()) {
         return update_order(order_id, std::nullopt, std::nullopt,
                             new_delivery_selection);
@@ -198,7 +280,20 @@ void OrderManager::update_order_info(const long long order_id,
                         new_delivery_selection);
 }
 
+string OrderManager::arrival_time_sql() const {
+    string sql = "(UNIX_TIMESTAMP(order_time) + CASE delivery_selection ";
+
+    for (int i = 0; i < DELIVERY_DAYS.size(); i++) {
+        long long seconds = (long long)DELIVERY_DAYS[i] * 86400;
+        sql += "WHEN " + std::to_string(i) + " THEN " +
+               std::to_string(seconds) + " ";
+    }
+
+    return sql + "ELSE 3153600000 END)";
+}
+
 void OrderManager::check_and_update_arrived_orders(int user_id) {
+    TRACE_SCOPE("model", "OrderManager::check_and_update_arrived_orders");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法更新到达订单状态。");
     }
@@ -208,19 +303,10 @@ void OrderManager::check_and_update_arrived_orders(int user_id) {
     try {
 
         string sql = "UPDATE orders SET status = ? WHERE user_id = ? AND "
-                     "status = ? AND (UNIX_TIMESTAMP(order_time) + CASE "
-                     "delivery_selection ";
-
-        for (int i = 0; i < DELIVERY_DAYS.size(); i++) {
-            long long seconds = (long long)DELIVERY_DAYS[i] * 86400;
-            sql += "WHEN " + std::to_string(i) + " THEN " +
-                   std::to_string(seconds) + " ";
-        }
-
-        sql += "ELSE 3153600000 END) <= ?";
+                     "status = ? AND " +
+                     arrival_time_sql() + " <= ?";
 
-        Database::get_session()
-            .sql(sql)
+        Database::sql(sql)
             .bind(static_cast<int>(FullOrderStatus::COMPLETED), user_id,
                   static_cast<int>(FullOrderStatus::NOT_COMPLETED),
                   static_cast<int64_t>(now))
@@ -230,3 +316,35 @@ void OrderManager::check_and_update_arrived_orders(int user_id) {
         LOG_ERROR("更新到达订单状态失败。");
     }
 }
+
+optional<ArrivalBacklog> OrderManager::count_pending_arrivals() {
+    TRACE_SCOPE("model", "OrderManager::count_pending_arrivals");
+    if (!Database::is_connected()) {
+        LOG_ERROR("数据库未连接，无法统计待送达订单。");
+        return nullopt;
+    }
+
+    try {
+        // 一个订单由多行组成，按 order_id 去重计数
+        string sql = "SELECT COUNT(DISTINCT order_id), COUNT(DISTINCT CASE "
+                     "WHEN " +
+                     arrival_time_sql() +
+                     " <= ? THEN order_id END) FROM orders WHERE status = ?";
+
+        auto res = Database::sql(sql)
+                       .bind(static_cast<int64_t>(get_current_time()),
+                             static_cast<int>(FullOrderStatus::NOT_COMPLETED))
+                       .execute();
+
+        ArrivalBacklog backlog;
+        if (auto row = res.fetchOne()) {
+            backlog.in_transit = row[0].get<int64_t>();
+            backlog.overdue = row[1].get<int64_t>();
+        }
+        return backlog;
+
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("统计待送达订单失败。");
+        return nullopt;
+    }
+}
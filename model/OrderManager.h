@@ -11,12 +11,15 @@
 #include "Logger.h"
 #include "ProductManager.h"
 #include <chrono>
+#include <functional>
 #include <map>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+class HistoryOrderManager;
+
 /**
  * @brief 订单状态枚举
  *
@@ -73,6 +76,25 @@ struct FullOrder {
     FullOrderStatus status = FullOrderStatus::NOT_COMPLETED; ///< 聚合状态
 };
 
+/**
+ * @brief 待送达订单的积压情况（全体用户）
+ *
+ * 订单送达是在用户查看订单时按时间惰性更新的，
+ * overdue 即已到送达时间、但还没有被更新状态的订单数。
+ */
+struct ArrivalBacklog {
+    long long in_transit = 0; ///< 运输中的订单数
+    long long overdue = 0;    ///< 其中已到送达时间的订单数
+};
+
+/**
+ * @brief 一次结账的结果
+ */
+struct PurchaseResult {
+    std::vector<CartItem> ordered; ///< 实际下单的购物车行
+    int rejected_product_id = 0;   ///< 整单放弃时库存不足的商品，0 表示无
+};
+
 /**
  * @brief 配送费用常量数组
  * 索引对应配送方式：0-普通, 1-快速, 2-特快
@@ -94,12 +116,6 @@ class OrderManager {
   private:
     using string_view = std::string_view;
 
-    // 内存缓存：聚合后的订单列表 map (Key: order_id, Value: FullOrder)
-    std::map<long long, FullOrder> orders_map;
-
-    // 标志位：orders_map 是否已加载
-    bool is_loaded = false;
-
     // 辅助函数：获取当前系统时间戳(time_t)
     time_t get_current_time() {
         auto now = std::chrono::system_clock::now();
@@ -115,12 +131,15 @@ class OrderManager {
 
     // 辅助函数：根据 order_id 获取所有商品并恢复库存(用于取消订单)
     void update_stock_by_order_id(const long long order_id,
-                                  ProductManager product_manager);
+                                  ProductManager &product_manager);
 
     // 配送时间映射 (索引对应配送方式 0, 1, 2)
     // 0: 普通(5天), 1: 普快(3天), 2: 特快(0天)
     const std::vector<int> DELIVERY_DAYS = {5, 3, 1};
 
+    // 辅助函数：生成计算订单送达时间戳的 SQL 表达式
+    std::string arrival_time_sql() const;
+
   public:
     /**
      * @brief 构造函数
@@ -128,32 +147,30 @@ class OrderManager {
      */
     OrderManager() = default;
     /**
-     * @brief 加载并聚合订单
+     * @brief 从数据库读取并聚合订单
      *
-     * 读取数据库文件，将属于该用户的分散 OrderItem 按 order_id 聚合成 FullOrder
-     * 对象， 并计算总价。
+     * 读取属于该用户的分散 OrderItem 并按 order_id 聚合成 FullOrder，计算总价。
+     * 只访问数据库（含自动收货的状态更新），可在后台线程调用。
      *
      * @param user_id 用户 ID
      * @param product_manager 商品管理器（用于查询商品价格以计算总价）
-     * @return 无返回值
+     * @return std::map<long long, FullOrder> 聚合后的订单
      */
-    void load_full_orders(const int user_id, ProductManager &product_manager);
+    std::map<long long, FullOrder>
+    fetch_full_orders(const int user_id, ProductManager &product_manager);
 
     /**
-     * @brief 获取聚合后的订单映射指针
+     * @brief 把订单项按 order_id 聚合成完整订单并计算总价
+     *
+     * 纯内存计算，不访问数据库。总价为各商品单价乘数量之和加上配送费。
      *
-     * @return std::optional<std::map<long long, FullOrder> *> 若已加载返回 map
-     * 指针，否则返回 nullopt
+     * @param items 订单项（同一订单的各项配送方式、地址与状态相同）
+     * @param price_of 按商品 ID 查询单价
+     * @return std::map<long long, FullOrder> 订单号 -> 完整订单
      */
-    std::optional<std::map<long long, FullOrder> *> get_orders_map_ptr() {
-        if (is_loaded)
-            return &orders_map;
-        else {
-            LOG_CRITICAL("订单列表未加载到内存");
-            throw std::runtime_error("订单列表未加载到内存");
-            return std::nullopt;
-        }
-    }
+    static std::map<long long, FullOrder>
+    aggregate_orders(const std::vector<OrderItem> &items,
+                     const std::function<double(const int)> &price_of);
 
     /**
      * @brief 创建新订单 (下单)
@@ -168,17 +185,46 @@ class OrderManager {
     void add_order(const int user_id, std::vector<CartItem> cart_lists,
                    const std::string address);
 
+    /**
+     * @brief 结算购物车中选中的商品 (下单的完整流程)
+     *
+     * 逐个用单条 UPDATE 原子扣减库存，再只结算预留到库存且仍在购物车中的
+     * 商品（同一购物车行只会被一次结账取走），其余归还库存；最后生成订单
+     * 及历史订单快照。库存不足的商品默认跳过并留在购物车中；all_or_nothing
+     * 时任何一个不足都归还已扣减的库存并放弃整单。
+     *
+     * @param user_id 用户 ID
+     * @param selected 选中的商品（product_id、count、delivery_selection）
+     * @param address 配送地址
+     * @param cart_manager 购物车管理器
+     * @param product_manager 商品管理器（扣减与归还库存）
+     * @param history_order_manager 历史订单管理器（写入快照）
+     * @param source 耗时直方图的 source 标签，如 "app"、"rpc"、"http"
+     * @param all_or_nothing 库存不足时是否放弃整单
+     * @return PurchaseResult 实际下单的商品及放弃整单的原因
+     */
+    PurchaseResult purchase(const int user_id,
+                            const std::vector<CartItem> &selected,
+                            const std::string &address,
+                            CartManager &cart_manager,
+                            ProductManager &product_manager,
+                            HistoryOrderManager &history_order_manager,
+                            const std::string &source,
+                            const bool all_or_nothing = false);
+
     /**
      * @brief 取消订单
      *
      * 将指定 order_id 下的所有 Item 状态置为 CANCEL，并自动调用 ProductManager
      * 恢复商品库存。
+     * 只取消未完成的订单，并发或重复取消同一订单时库存只恢复一次。
      *
      * @param order_id 订单号
      * @param product_manager 商品管理器（用于恢复库存）
-     * @return 无返回值
+     * @return true 本次调用取消了订单并恢复了库存
+     * @return false 订单不存在、已完成、已被取消或数据库出错
      */
-    void cancel_order(const long long order_id,
+    bool cancel_order(const long long order_id,
                       ProductManager &product_manager);
 
     /**
@@ -206,6 +252,15 @@ class OrderManager {
      */
     void check_and_update_arrived_orders(int user_id);
 
+    /**
+     * @brief 统计全体用户待送达订单的积压情况
+     *
+     * 只读，不更新订单状态；供管理员监控页在后台线程定期调用。
+     *
+     * @return std::optional<ArrivalBacklog> 统计结果，查询失败时为空
+     */
+    std::optional<ArrivalBacklog> count_pending_arrivals();
+
     /**
      * @brief 析构函数
      *
@@ -1,7 +1,14 @@
 #include "ProductManager.h"
+#include "ChangeBus.h"
 #include "Database.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <sstream>
 
 using std::ifstream;
 using std::nullopt;
@@ -10,19 +17,202 @@ using std::optional;
 using std::string;
 using std::string_view;
 
-void ProductManager::load_all_product() {
+namespace {
+
+struct SearchMetrics {
+    Metrics::Histogram &search_seconds;
+    Metrics::Histogram &catalog_load_seconds;
+    Metrics::Counter &cache_hits;
+    Metrics::Counter &cache_misses;
+};
+
+SearchMetrics &search_metrics() {
+    auto &registry = Metrics::Registry::get_instance();
+    static SearchMetrics metrics{
+        registry.histogram("shopping_search_seconds", "商品搜索的耗时"),
+        registry.histogram("shopping_catalog_load_seconds",
+                           "从数据库读取商品目录的耗时"),
+        registry.counter("shopping_cache_requests_total", "查询缓存的访问次数",
+                         {{"cache", "product_search"}, {"result", "hit"}}),
+        registry.counter("shopping_cache_requests_total", "查询缓存的访问次数",
+                         {{"cache", "product_search"}, {"result", "miss"}}),
+    };
+    return metrics;
+}
+
+} // namespace
+
+void ProductManager::load_all_product() { reload_catalog(); }
+
+std::shared_ptr<const Catalog> ProductManager::reload_catalog() {
+    TRACE_SCOPE("model", "ProductManager::reload_catalog");
+    // 版本号在读取开始前分配，开始得越晚的读取数据越新
+    uint64_t version = ++catalog_version;
+    std::shared_ptr<const Catalog> next;
+    {
+        Metrics::ScopedTimer timer(search_metrics().catalog_load_seconds);
+        auto products = fetch_all_products();
+        uint64_t matching = match_version_for(products);
+        next = std::make_shared<const Catalog>(std::move(products), version,
+                                               matching);
+    }
+
+    // 读取期间发生的写入由其安排的下一次重建补上，这里只需比已发布的新
+    auto current = std::atomic_load(&catalog);
+    while (!current || current->version < next->version) {
+        if (std::atomic_compare_exchange_weak(&catalog, &current, next))
+            return next;
+    }
+    // 已有更新的快照发布，丢弃本次结果
+    return current;
+}
+
+uint64_t
+ProductManager::match_version_for(const std::vector<Product> &products) {
+    auto current = std::atomic_load(&catalog);
+    if (current && current->products.size() == products.size() &&
+        std::equal(products.begin(), products.end(),
+                   current->products.begin(),
+                   [](const Product &a, const Product &b) {
+                       return a.product_id == b.product_id &&
+                              a.status == b.status &&
+                              a.product_name == b.product_name;
+                   }))
+        return current->match_version;
+    return ++match_version;
+}
+
+void ProductManager::invalidate_catalog() {
+    ++catalog_writes;
+    if (!std::atomic_load(&catalog))
+        return;
+
+    // 搜索缓存不清空：条目按匹配版本区分，只改库存的写入后仍然有效。
+    // 旧快照继续服务读者；已排队的重建尚未开始读取，会读到本次写入，
+    // 不必再排一次。重建开始时先清除标记，读取期间的写入会再排一次
+    if (rebuild_queued.exchange(true))
+        return;
+
+    rebuild_executor.submit([this] {
+        rebuild_queued = false;
+        reload_catalog();
+        // 写入时发布的变更事件可能早于重建完成，新快照发布后再通知一次
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
+    });
+}
+
+void ProductManager::invalidate_stock(const int product_id) {
+    ++catalog_writes;
+    if (!std::atomic_load(&catalog))
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(stock_mtx);
+        stock_dirty.insert(product_id);
+    }
+    // 与重建同在一个线程上执行，二者不会交错；标记在写入提交之后，
+    // 刷新在读取之前取走标记，读到的库存一定包含已取走的写入
+    if (stock_refresh_queued.exchange(true))
+        return;
+
+    rebuild_executor.submit([this] {
+        stock_refresh_queued = false;
+        refresh_stock();
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
+    });
+}
+
+void ProductManager::refresh_stock() {
+    TRACE_SCOPE("model", "ProductManager::refresh_stock");
+    std::vector<int> ids;
+    {
+        std::lock_guard<std::mutex> lock(stock_mtx);
+        ids.assign(stock_dirty.begin(), stock_dirty.end());
+        stock_dirty.clear();
+    }
+    if (ids.empty())
+        return;
+
+    // 读取开始前分配版本号，与 reload_catalog 一致
+    uint64_t version = ++catalog_version;
+    std::vector<std::pair<int, int>> stocks;
+    try {
+        for (size_t begin = 0; begin < ids.size();
+             begin += TRANSFER_BATCH_SIZE) {
+            size_t end = std::min(ids.size(), begin + TRANSFER_BATCH_SIZE);
+            string sql = "SELECT product_id, stock FROM products "
+                         "WHERE product_id IN (";
+            for (size_t i = begin; i < end; i++)
+                sql += (i == begin ? "?" : ", ?");
+            sql += ")";
+
+            auto stmt = Database::sql(sql);
+            for (size_t i = begin; i < end; i++)
+                stmt.bind(ids[i]);
+            auto res = stmt.execute();
+            while (auto row = res.fetchOne())
+                stocks.emplace_back(row[0].get<int>(), row[1].get<int>());
+        }
+    } catch (const mysqlx::Error &e) {
+        // 读取失败时改为整体重建，不让快照停留在旧库存上
+        LOG_ERROR("读取商品库存失败: " + std::string(e.what()));
+        invalidate_catalog();
+        return;
+    }
+
+    // 拷贝当前快照并写入库存（匹配版本与 ID 索引不变）；
+    // 已有更新的快照发布时放弃本次结果
+    auto current = std::atomic_load(&catalog);
+    while (current && current->version < version) {
+        Catalog patched = *current;
+        patched.version = version;
+        for (const auto &[product_id, stock] : stocks) {
+            auto it = patched.id_index->find(product_id);
+            if (it != patched.id_index->end())
+                patched.products[it->second].stock = stock;
+        }
+        auto next = std::make_shared<const Catalog>(std::move(patched));
+        if (std::atomic_compare_exchange_weak(&catalog, &current, next))
+            return;
+    }
+}
+
+std::shared_ptr<const Catalog> ProductManager::get_catalog() {
+    auto snapshot = std::atomic_load(&catalog);
+    if (snapshot)
+        return snapshot;
+
+    // 首次加载：等待其他线程正在进行的加载，而不是各自读取一遍
+    std::lock_guard<std::mutex> lock(first_load_mtx);
+    snapshot = std::atomic_load(&catalog);
+    if (!snapshot) {
+        uint64_t writes = catalog_writes;
+        snapshot = reload_catalog();
+        // 目录为空时的写入不安排重建，加载期间有写入则补一次
+        if (catalog_writes != writes)
+            invalidate_catalog();
+    }
+    return snapshot;
+}
+
+void ProductManager::publish_catalog(std::vector<Product> products) {
+    uint64_t matching = match_version_for(products);
+    std::atomic_store(&catalog,
+                      std::make_shared<const Catalog>(
+                          std::move(products), ++catalog_version, matching));
+}
+
+std::vector<Product> ProductManager::fetch_all_products() {
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法加载商品信息到内存。");
     }
 
-    is_loaded = false;
-
-    product_list.clear();
+    std::vector<Product> product_list;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT product_name, product_id, price, stock, "
-                            "status FROM products")
+        auto res = Database::sql("SELECT product_name, product_id, price, "
+                                 "stock, status FROM products "
+                                 "ORDER BY product_id")
                        .execute();
         while (auto row = res.fetchOne()) {
             Product temp;
@@ -38,51 +228,320 @@ void ProductManager::load_all_product() {
         LOG_ERROR("加载商品列表到内存失败，" + string(e.what()));
     };
 
-    is_loaded = true;
+    return product_list;
 }
 
 void ProductManager::add_product(const string &product_name, const double price,
                                  const int stock) {
+    TRACE_SCOPE("model", "ProductManager::add_product");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法添加新商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("INSERT INTO products (product_name, price, stock) "
-                 "VALUES(?, ?, ?)")
+        Database::sql("INSERT INTO products (product_name, price, stock) "
+                      "VALUES(?, ?, ?)")
             .bind(product_name, price, stock)
             .execute();
+        invalidate_catalog();
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("添加新商品失败: " + std::string(e.what()));
     }
 }
 
+// 按扩展名选择分隔符：.csv 为逗号，其余为制表符
+static char delimiter_for_path(const string &path) {
+    const string ext = ".csv";
+    if (path.size() >= ext.size() &&
+        path.compare(path.size() - ext.size(), ext.size(), ext) == 0)
+        return ',';
+    return '\t';
+}
+
+optional<Product>
+ProductManager::parse_product_fields(const std::vector<string> &fields,
+                                     string &error_message) {
+    // 3~4 列：商品名 价格 库存 [状态]
+    // 5 列及以上：商品ID 商品名 价格 库存 状态 [...]（商品 ID 忽略）
+    size_t offset = fields.size() >= 5 ? 1 : 0;
+    if (fields.size() < 3) {
+        error_message = "列数不足";
+        return nullopt;
+    }
+
+    Product product;
+    product.product_id = -1;
+    product.product_name = fields[offset];
+    product.status = ProductStatus::NORMAL;
+
+    size_t name_length = Utils::utf8_length(product.product_name);
+    if (product.product_name.empty() || product.product_name == "\\N") {
+        error_message = "商品名为空";
+        return nullopt;
+    } else if (name_length == string::npos) {
+        error_message = "商品名不是合法的 UTF-8 编码";
+        return nullopt;
+    } else if (name_length > Product::MAX_PRODUCT_NAME_SIZE) {
+        error_message = "商品名超过 " +
+                        std::to_string(Product::MAX_PRODUCT_NAME_SIZE) +
+                        " 个字符";
+        return nullopt;
+    }
+
+    try {
+        size_t pos = 0;
+        product.price = std::stod(fields[offset + 1], &pos);
+        if (pos != fields[offset + 1].size() || !std::isfinite(product.price) ||
+            product.price < 0) {
+            error_message = "价格不合法: " + fields[offset + 1];
+            return nullopt;
+        }
+
+        product.stock = std::stoi(fields[offset + 2], &pos);
+        if (pos != fields[offset + 2].size() || product.stock < 0) {
+            error_message = "库存不合法: " + fields[offset + 2];
+            return nullopt;
+        }
+
+        if (fields.size() > offset + 3 && !fields[offset + 3].empty() &&
+            fields[offset + 3] != "\\N") {
+            int status = std::stoi(fields[offset + 3]);
+            if (status != static_cast<int>(ProductStatus::NORMAL) &&
+                status != static_cast<int>(ProductStatus::DELETED)) {
+                error_message = "状态不合法: " + fields[offset + 3];
+                return nullopt;
+            }
+            product.status = static_cast<ProductStatus>(status);
+        }
+    } catch (const std::exception &) {
+        error_message = "数值字段无法解析";
+        return nullopt;
+    }
+
+    return product;
+}
+
+bool ProductManager::upsert_product_batch(const std::vector<Product> &batch) {
+    string sql =
+        "INSERT INTO products (product_name, price, stock, status) VALUES ";
+    for (size_t i = 0; i < batch.size(); i++)
+        sql += (i == 0 ? "(?, ?, ?, ?)" : ", (?, ?, ?, ?)");
+    // 商品名为唯一键，已存在时更新价格、库存与状态
+    sql += " ON DUPLICATE KEY UPDATE price = VALUES(price), "
+           "stock = VALUES(stock), status = VALUES(status)";
+
+    try {
+        auto stmt = Database::sql(sql);
+        for (const auto &p : batch)
+            stmt.bind(p.product_name, p.price, p.stock,
+                      static_cast<int>(p.status));
+        stmt.execute();
+        return true;
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("批量写入商品失败: " + std::string(e.what()));
+    }
+    return false;
+}
+
+ProductTransferReport
+ProductManager::import_products(const string &path,
+                                const ProductProgressCallback &on_progress) {
+    TRACE_SCOPE("model", "ProductManager::import_products");
+    ProductTransferReport report;
+    auto start = std::chrono::steady_clock::now();
+
+    ifstream file(path);
+    if (!file.is_open()) {
+        report.add_error("无法打开文件: " + path);
+        LOG_ERROR("无法打开商品文件: " + path);
+        return report;
+    }
+    if (!Database::is_connected()) {
+        report.add_error("数据库未连接");
+        LOG_ERROR("数据库未连接，无法导入商品。");
+        return report;
+    }
+
+    char delimiter = delimiter_for_path(path);
+    std::vector<Product> batch;
+    batch.reserve(TRANSFER_BATCH_SIZE);
+
+    auto flush = [&] {
+        if (batch.empty())
+            return;
+        if (upsert_product_batch(batch))
+            report.written += batch.size();
+        else {
+            report.failed += batch.size();
+            report.add_error("第 " + std::to_string(report.processed) +
+                             " 行之前的一批商品写入数据库失败");
+        }
+        batch.clear();
+
+        report.seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        if (on_progress)
+            on_progress(report);
+    };
+
+    string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        auto fields = Utils::split_delimited_line(line, delimiter);
+
+        string error;
+        auto product = parse_product_fields(fields, error);
+
+        // 首行解析失败视为表头
+        if (line_number == 1 && !product.has_value())
+            continue;
+
+        report.processed++;
+        if (!product.has_value()) {
+            report.invalid++;
+            report.add_error("第 " + std::to_string(line_number) +
+                             " 行: " + error);
+            continue;
+        }
+
+        batch.push_back(std::move(*product));
+        if (batch.size() == TRANSFER_BATCH_SIZE)
+            flush();
+    }
+    flush();
+
+    report.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    // 全部批次写完后只重建一次目录，而不是每批一次
+    if (report.written > 0) {
+        invalidate_catalog();
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
+    }
+
+    LOG_INFO("商品导入完成: 处理 " + std::to_string(report.processed) +
+             " 行，写入 " + std::to_string(report.written) + " 个，无效 " +
+             std::to_string(report.invalid) + " 行，失败 " +
+             std::to_string(report.failed) + " 行，耗时 " +
+             std::to_string(report.seconds) + " 秒");
+    return report;
+}
+
+ProductTransferReport
+ProductManager::export_products(const string &path,
+                                const ProductProgressCallback &on_progress) {
+    TRACE_SCOPE("model", "ProductManager::export_products");
+    ProductTransferReport report;
+    auto start = std::chrono::steady_clock::now();
+
+    ofstream file(path);
+    if (!file.is_open()) {
+        report.add_error("无法创建文件: " + path);
+        LOG_ERROR("无法创建商品导出文件: " + path);
+        return report;
+    }
+    if (!Database::is_connected()) {
+        report.add_error("数据库未连接");
+        LOG_ERROR("数据库未连接，无法导出商品。");
+        return report;
+    }
+
+    char delimiter = delimiter_for_path(path);
+    file << "product_id" << delimiter << "product_name" << delimiter
+         << "price" << delimiter << "stock" << delimiter << "status\n";
+
+    // 按商品 ID 做 keyset 分批读取，每批读完即写出
+    int last_id = 0;
+    while (true) {
+        size_t batch_rows = 0;
+        try {
+            auto res =
+                Database::sql("SELECT product_id, product_name, price, stock, "
+                              "status FROM products WHERE product_id > ? "
+                              "ORDER BY product_id LIMIT ?")
+                    .bind(last_id, static_cast<int>(TRANSFER_BATCH_SIZE))
+                    .execute();
+
+            std::ostringstream chunk;
+            chunk.precision(15);
+            while (auto row = res.fetchOne()) {
+                last_id = row[0].get<int>();
+                chunk << last_id << delimiter
+                      << Utils::escape_delimited_field(
+                             row[1].get<std::string>(), delimiter)
+                      << delimiter << row[2].get<double>() << delimiter
+                      << row[3].get<int>() << delimiter << row[4].get<int>()
+                      << '\n';
+                batch_rows++;
+            }
+            file << chunk.str();
+        } catch (const mysqlx::Error &e) {
+            report.add_error("读取商品失败: " + string(e.what()));
+            LOG_ERROR("导出商品失败，" + string(e.what()));
+            break;
+        }
+
+        if (!file) {
+            report.failed += batch_rows;
+            report.add_error("写入文件失败: " + path);
+            break;
+        }
+
+        report.processed += batch_rows;
+        report.written += batch_rows;
+        report.seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        if (on_progress && batch_rows > 0)
+            on_progress(report);
+
+        if (batch_rows < TRANSFER_BATCH_SIZE)
+            break;
+    }
+
+    LOG_INFO("商品导出完成: 写出 " + std::to_string(report.written) +
+             " 个，耗时 " + std::to_string(report.seconds) + " 秒");
+    return report;
+}
+
 void ProductManager::delete_product(const int product_id) {
+    TRACE_SCOPE("model", "ProductManager::delete_product");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法删除商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE products SET status = ? WHERE product_id = ?")
+        Database::sql("UPDATE products SET status = ? WHERE product_id = ?")
             .bind(static_cast<int>(ProductStatus::DELETED), product_id)
             .execute();
+        invalidate_catalog();
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("删除商品失败: " + std::string(e.what()));
     }
 }
 
 void ProductManager::restore_product(const int product_id) {
+    TRACE_SCOPE("model", "ProductManager::restore_product");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法恢复商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE products SET status = ? WHERE product_id = ?")
+        Database::sql("UPDATE products SET status = ? WHERE product_id = ?")
             .bind(static_cast<int>(ProductStatus::NORMAL), product_id)
             .execute();
+        invalidate_catalog();
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("恢复商品失败: " + std::string(e.what()));
     }
@@ -91,39 +550,82 @@ void ProductManager::restore_product(const int product_id) {
 void ProductManager::update_product(const string &product_name,
                                     const int product_id, const double price,
                                     const int stock) {
+    TRACE_SCOPE("model", "ProductManager::update_product");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法更新商品。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE products SET product_name = ?, price = ?, stock = ? "
-                 "WHERE product_id = ?")
+        Database::sql("UPDATE products SET product_name = ?, price = ?, stock "
+                      "= ? WHERE product_id = ?")
             .bind(product_name, price, stock, product_id)
             .execute();
+        invalidate_catalog();
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("更新商品失败: " + std::string(e.what()));
     }
 }
 
-std::vector<Product>
-ProductManager::search_all_product(const std::string &query) {
-    std::vector<Product> result;
+bool ProductManager::adjust_stock(const int product_id, const int delta) {
+    TRACE_SCOPE("model", "ProductManager::adjust_stock");
+    if (delta == 0)
+        return true;
 
-    if (!is_loaded) {
-        load_all_product();
+    if (!Database::is_connected()) {
+        LOG_ERROR("数据库未连接，无法调整库存。");
     }
 
-    if (query.empty()) {
-        result = product_list;
-        return result;
+    try {
+        // 扣减只对在售商品生效，已下架的商品不能再被买走；归还库存（取消订单、
+        // 结账回滚）不受状态限制，商品恢复上架后库存仍然正确
+        auto res =
+            Database::sql("UPDATE products SET stock = stock + ? "
+                          "WHERE product_id = ? AND stock + ? >= 0 "
+                          "AND (? > 0 OR status = ?)")
+                .bind(delta, product_id, delta, delta,
+                      static_cast<int>(ProductStatus::NORMAL))
+                .execute();
+        if (res.getAffectedItemsCount() == 0)
+            return false;
+        invalidate_stock(product_id);
+        ChangeBus::get_instance().publish(PRODUCT_CHANGED);
+        return true;
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("调整库存失败: " + std::string(e.what()));
     }
+    return false;
+}
 
-    std::string lower_query = query;
-    std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(),
+std::string ProductManager::normalize_query(const std::string &query) {
+    size_t begin = query.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return "";
+    size_t end = query.find_last_not_of(" \t\r\n");
+
+    std::string normalized = query.substr(begin, end - begin + 1);
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
                    ::tolower);
+    return normalized;
+}
 
-    for (const auto &p : product_list) {
+ProductSearchMatch
+ProductManager::match_products(const Catalog &catalog,
+                               const std::string &lower_query,
+                               const bool include_deleted) {
+    ProductSearchMatch match;
+
+    for (const auto &p : catalog.products) {
+        if (!include_deleted && p.status == ProductStatus::DELETED)
+            continue;
+
+        size_t index = &p - catalog.products.data();
+
+        if (lower_query.empty()) {
+            match.indices.push_back(index);
+            match.positions.push_back(std::string::npos);
+            continue;
+        }
 
         std::string id_str = std::to_string(p.product_id);
 
@@ -132,68 +634,190 @@ ProductManager::search_all_product(const std::string &query) {
                        ::tolower);
 
         if (id_str == lower_query) {
-            result.push_back(p);
+            match.indices.push_back(index);
+            match.positions.push_back(std::string::npos);
             break;
         }
 
-        if (name_str.find(lower_query) != std::string::npos) {
-            result.push_back(p);
+        size_t pos = name_str.find(lower_query);
+        if (pos != std::string::npos) {
+            match.indices.push_back(index);
+            match.positions.push_back(pos);
         }
     }
-    return result;
+    return match;
 }
 
-std::vector<Product>
-ProductManager::search_product(const std::string &query_name) {
-    std::vector<Product> result;
-
-    product_list.clear();
-    load_all_product();
-
-    if (query_name.empty()) {
-        for (const auto &p : product_list) {
-            if (p.status != ProductStatus::DELETED)
-                result.emplace_back(p);
-        }
-        return result;
+ProductSearchResult
+ProductManager::cached_search(const std::string &query,
+                              const bool include_deleted) {
+    Metrics::ScopedTimer timer(search_metrics().search_seconds);
+    auto snapshot = get_catalog();
+    std::string lower_query = normalize_query(query);
+    std::string key = std::to_string(snapshot->match_version) +
+                      (include_deleted ? "|all|" : "|valid|") + lower_query;
+
+    std::shared_ptr<const ProductSearchMatch> match;
+    if (auto cached = search_cache.get(key)) {
+        search_metrics().cache_hits.inc();
+        match = std::move(*cached);
+    } else {
+        search_metrics().cache_misses.inc();
+        match = std::make_shared<const ProductSearchMatch>(
+            match_products(*snapshot, lower_query, include_deleted));
+        search_cache.put(key, match);
     }
 
-    std::string lower_query = query_name;
-    std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(),
-                   ::tolower);
+    // 匹配版本相同的快照商品顺序相同，下标对本快照有效；结果持有该快照，
+    // 不拷贝商品
+    return ProductSearchResult(std::move(snapshot), std::move(match));
+}
 
-    for (const auto &p : product_list) {
-        if (p.status == ProductStatus::DELETED)
-            continue;
+ProductSearchResult
+ProductManager::search_all_product(const std::string &query) {
+    TRACE_SCOPE("model", "ProductManager::search_all_product");
+    return cached_search(query, true);
+}
 
-        std::string id_str = std::to_string(p.product_id);
+ProductSearchResult
+ProductManager::search_product(const std::string &query_name) {
+    TRACE_SCOPE("model", "ProductManager::search_product");
+    // 目录在商品写入后失效并重新加载，重复的搜索直接命中缓存
+    return cached_search(query_name, false);
+}
 
-        std::string name_str = std::string(p.product_name);
-        std::transform(name_str.begin(), name_str.end(), name_str.begin(),
-                       ::tolower);
+ProductPage ProductManager::list_products_page(const ProductPageQuery &query,
+                                               const ProductPageCursor &after) {
+    TRACE_SCOPE("model", "ProductManager::list_products_page");
+    if (!Database::is_connected())
+        LOG_ERROR("数据库未连接，无法分页读取商品。");
+
+    ProductPage page;
+    int limit = std::max(query.page_size, 1);
+
+    // 排序列只来自枚举，不拼接外部输入
+    string column;
+    switch (query.sort_key) {
+    case ProductSortKey::NAME:
+        column = "product_name";
+        break;
+    case ProductSortKey::PRICE:
+        column = "price";
+        break;
+    case ProductSortKey::STOCK:
+        column = "stock";
+        break;
+    default:
+        column = "product_id";
+        break;
+    }
+    bool by_id = query.sort_key == ProductSortKey::ID;
+    string cmp = query.descending ? "<" : ">";
+    string order = query.descending ? " DESC" : " ASC";
+
+    // WHERE status = ? AND (排序键, product_id) > (?, ?)
+    // ORDER BY 排序键, product_id —— 与 (status, 排序键) 索引的顺序一致
+    // （InnoDB 二级索引隐含主键列），只扫描一页的索引范围
+    string sql = "SELECT product_name, product_id, price, stock, status "
+                 "FROM products WHERE 1 = 1 ";
+    if (query.status != ProductStatusFilter::ALL)
+        sql += "AND status = ? ";
+    if (!after.at_start) {
+        sql += by_id ? "AND product_id " + cmp + " ? "
+                     : "AND (" + column + ", product_id) " + cmp + " (?, ?) ";
+    }
+    sql += "ORDER BY " + column + order;
+    if (!by_id)
+        sql += ", product_id" + order;
+    sql += " LIMIT ?";
 
-        if (id_str == lower_query) {
-            result.push_back(p);
-            break;
+    try {
+        auto stmt = Database::sql(sql);
+        if (query.status == ProductStatusFilter::NORMAL)
+            stmt.bind(static_cast<int>(ProductStatus::NORMAL));
+        else if (query.status == ProductStatusFilter::DELETED)
+            stmt.bind(static_cast<int>(ProductStatus::DELETED));
+
+        if (!after.at_start) {
+            const Product &last = after.last;
+            switch (query.sort_key) {
+            case ProductSortKey::NAME:
+                stmt.bind(last.product_name);
+                break;
+            case ProductSortKey::PRICE:
+                stmt.bind(last.price);
+                break;
+            case ProductSortKey::STOCK:
+                stmt.bind(last.stock);
+                break;
+            default:
+                break;
+            }
+            stmt.bind(last.product_id);
         }
+        // 多取一行用于判断是否还有下一页
+        stmt.bind(limit + 1);
+
+        auto res = stmt.execute();
+        while (auto row = res.fetchOne()) {
+            if (static_cast<int>(page.products.size()) == limit) {
+                page.has_more = true;
+                break;
+            }
 
-        if (name_str.find(lower_query) != std::string::npos) {
-            result.push_back(p);
+            Product temp;
+            temp.product_name = row[0].get<std::string>();
+            temp.product_id = row[1].get<int>();
+            temp.price = row[2].get<double>();
+            temp.stock = row[3].get<int>();
+            temp.status = static_cast<ProductStatus>(row[4].get<int>());
+            page.products.push_back(temp);
         }
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("分页读取商品失败，" + string(e.what()));
     }
-    return result;
+
+    if (!page.products.empty()) {
+        page.next_cursor.at_start = false;
+        page.next_cursor.last = page.products.back();
+    }
+
+    return page;
+}
+
+CacheStats ProductManager::get_search_cache_stats() const {
+    return search_cache.stats();
+}
+
+size_t ProductManager::get_catalog_bytes() const {
+    auto current = std::atomic_load(&catalog);
+    if (!current)
+        return 0;
+
+    size_t bytes =
+        sizeof(Catalog) + current->products.capacity() * sizeof(Product);
+    for (const auto &p : current->products)
+        bytes += p.product_name.capacity();
+
+    // 哈希表按节点分配：每个节点含键值与 next 指针，另有桶数组
+    if (const auto &index = current->id_index)
+        bytes += sizeof(Catalog::IdIndex) +
+                 index->size() *
+                     (sizeof(Catalog::IdIndex::value_type) + sizeof(void *)) +
+                 index->bucket_count() * sizeof(void *);
+    return bytes;
 }
 
 std::optional<Product> ProductManager::get_product(const int product_id) {
+    TRACE_SCOPE("model", "ProductManager::get_product");
     if (!Database::is_connected())
         LOG_ERROR("数据库未连接，无法获取商品信息。");
 
     optional<Product> result = nullopt;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT product_name, price, stock, status "
-                            "FROM products WHERE product_id = ?")
+        auto res = Database::sql("SELECT product_name, price, stock, status "
+                                 "FROM products WHERE product_id = ?")
                        .bind(product_id)
                        .execute();
         auto row = res.fetchOne();
@@ -215,15 +839,16 @@ std::optional<Product> ProductManager::get_product(const int product_id) {
 
 std::optional<Product>
 ProductManager::get_product(const std::string &product_name) {
+    TRACE_SCOPE("model", "ProductManager::get_product");
     if (!Database::is_connected())
         LOG_ERROR("数据库未连接，无法获取商品信息。");
 
     Product result;
 
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT product_name, product_id, price, stock, "
-                            "status FROM products WHERE product_name = ?")
+        auto res = Database::sql("SELECT product_name, product_id, price, "
+                                 "stock, status FROM products WHERE "
+                                 "product_name = ?")
                        .bind(product_name)
                        .execute();
         auto row = res.fetchOne();
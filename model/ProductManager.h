@@ -6,9 +6,20 @@
  */
 
 #pragma once
+#include "Executor.h"
+#include "LruCache.h"
 #include <Utils.h>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 /**
@@ -43,6 +54,234 @@ struct Product {
           status(s) {}
 };
 
+/**
+ * @brief 商品目录快照
+ *
+ * 某一时刻数据库中全部商品（包含已删除的商品）的不可变副本。
+ * 快照构建完成后才发布，发布后不再修改，可被任意多个线程同时读取；
+ * 重新加载时构建新快照整体替换，持有旧快照的读者不受影响。
+ * 只有库存变化时拷贝商品列表并修改库存，ID 索引与旧快照共享。
+ */
+struct Catalog {
+    using IdIndex = std::unordered_map<int, size_t>;
+
+    std::vector<Product> products;          ///< 所有商品（按商品 ID 升序）
+    std::shared_ptr<const IdIndex> id_index; ///< 商品 ID -> products 下标
+    uint64_t version = 0;                   ///< 版本号，越新越大
+    uint64_t match_version = 0;             ///< 匹配版本，库存变化时不变
+
+    Catalog() = default;
+
+    Catalog(std::vector<Product> list, const uint64_t version,
+            const uint64_t match_version = 0)
+        : products(std::move(list)), version(version),
+          match_version(match_version) {
+        auto index = std::make_shared<IdIndex>();
+        index->reserve(products.size());
+        for (size_t i = 0; i < products.size(); i++)
+            (*index)[products[i].product_id] = i;
+        id_index = std::move(index);
+    }
+
+    /**
+     * @brief 按 ID 查找商品
+     *
+     * @param product_id 商品 ID
+     * @return const Product* 找到返回指针（与快照同生命周期），否则 nullptr
+     */
+    const Product *find(const int product_id) const {
+        if (!id_index)
+            return nullptr;
+        auto it = id_index->find(product_id);
+        return it != id_index->end() ? &products[it->second] : nullptr;
+    }
+};
+
+/**
+ * @brief 一次商品搜索的匹配结果（搜索缓存中保存的内容）
+ *
+ */
+struct ProductSearchMatch {
+    std::vector<size_t> indices; ///< 命中商品在 Catalog::products 中的下标
+    std::vector<size_t>
+        positions; ///< 关键词在商品名中的位置（ID 精确匹配或空查询为 npos）
+};
+
+/**
+ * @brief 商品搜索结果
+ *
+ * 不拷贝商品：持有搜索时的目录快照与匹配下标，按下标直接引用快照中的商品。
+ * 只要结果对象存在，其引用的快照就不会被释放，元素引用始终有效。
+ * 需要独立副本时调用 to_vector。
+ */
+class ProductSearchResult {
+  private:
+    std::shared_ptr<const Catalog> catalog;
+    std::shared_ptr<const ProductSearchMatch> match;
+
+  public:
+    /**
+     * @brief 只读迭代器（按下标访问快照中的商品）
+     *
+     */
+    class const_iterator {
+      private:
+        const ProductSearchResult *result = nullptr;
+        size_t i = 0;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Product;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Product *;
+        using reference = const Product &;
+
+        const_iterator() = default;
+        const_iterator(const ProductSearchResult *result, const size_t i)
+            : result(result), i(i) {}
+
+        reference operator*() const { return (*result)[i]; }
+        pointer operator->() const { return &(*result)[i]; }
+
+        const_iterator &operator++() {
+            ++i;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++i;
+            return old;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return i == other.i;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return i != other.i;
+        }
+    };
+
+    ProductSearchResult() = default;
+
+    ProductSearchResult(std::shared_ptr<const Catalog> catalog,
+                        std::shared_ptr<const ProductSearchMatch> match)
+        : catalog(std::move(catalog)), match(std::move(match)) {}
+
+    size_t size() const { return match ? match->indices.size() : 0; }
+
+    bool empty() const { return size() == 0; }
+
+    // 第 i 个命中的商品（引用快照中的元素，不做越界检查）
+    const Product &operator[](const size_t i) const {
+        return catalog->products[match->indices[i]];
+    }
+
+    // 第 i 个命中的商品名中关键词的位置（ID 精确匹配或空查询为 npos）
+    size_t match_position(const size_t i) const {
+        return match->positions[i];
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // 结果所引用的目录快照（空结果可能为 nullptr）
+    const std::shared_ptr<const Catalog> &get_catalog() const {
+        return catalog;
+    }
+
+    // 拷贝出独立的商品列表
+    std::vector<Product> to_vector() const {
+        return std::vector<Product>(begin(), end());
+    }
+};
+
+/**
+ * @brief 商品分页排序方式
+ *
+ */
+enum class ProductSortKey {
+    ID,    ///< 按商品 ID
+    NAME,  ///< 按商品名
+    PRICE, ///< 按价格
+    STOCK, ///< 按库存
+};
+
+/**
+ * @brief 商品分页的状态过滤
+ *
+ */
+enum class ProductStatusFilter {
+    NORMAL,  ///< 只包含在售商品
+    DELETED, ///< 只包含已删除商品
+    ALL,     ///< 包含全部商品
+};
+
+/**
+ * @brief 商品分页查询条件
+ *
+ */
+struct ProductPageQuery {
+    static constexpr int DEFAULT_PAGE_SIZE = 20;
+
+    ProductSortKey sort_key = ProductSortKey::ID;             ///< 排序键
+    bool descending = false;                                  ///< 是否降序
+    ProductStatusFilter status = ProductStatusFilter::NORMAL; ///< 状态过滤
+    int page_size = DEFAULT_PAGE_SIZE;                        ///< 每页商品数
+};
+
+/**
+ * @brief 商品分页游标
+ *
+ * 按 (排序键, 商品 ID) 做 keyset 分页：下一页从上一页最后一个商品之后开始，
+ * 查询走 (状态, 排序键) 复合索引，耗时与翻到第几页无关。
+ */
+struct ProductPageCursor {
+    bool at_start = true;      ///< 为 true 时从第一页开始
+    Product last{"", 0, 0, 0}; ///< 上一页最后一个商品（取其排序键与 ID）
+};
+
+/**
+ * @brief 商品分页查询结果
+ *
+ */
+struct ProductPage {
+    std::vector<Product> products;          ///< 当前页的商品
+    ProductPageCursor next_cursor; ///< 下一页的游标
+    bool has_more = false;         ///< 是否还有下一页
+};
+
+/**
+ * @brief 商品批量导入/导出的进度与结果统计
+ *
+ */
+struct ProductTransferReport {
+    static constexpr size_t MAX_REPORTED_ERRORS = 20; ///< 最多保留的错误条数
+
+    size_t processed = 0; ///< 已处理的数据行数
+    size_t written = 0;   ///< 已写入（数据库或文件）的商品数
+    size_t invalid = 0;   ///< 校验失败而跳过的行数
+    size_t failed = 0;    ///< 因数据库或文件错误未能写入的行数
+    double seconds = 0;   ///< 总耗时（秒）
+
+    std::vector<std::string> errors; ///< 前若干条错误信息（含行号）
+
+    // 记录一条错误信息（超过上限后只计数不保存）
+    void add_error(const std::string &message) {
+        if (errors.size() < MAX_REPORTED_ERRORS)
+            errors.push_back(message);
+    }
+
+    // 吞吐（行/秒）
+    double rows_per_second() const {
+        return seconds > 0 ? processed / seconds : 0;
+    }
+};
+
+// 进度回调：每处理完一批数据调用一次
+using ProductProgressCallback =
+    std::function<void(const ProductTransferReport &)>;
+
 /**
  * @brief 商品管理类
  *
@@ -52,11 +291,99 @@ class ProductManager {
   private:
     using string_view = std::string_view;
 
-    // 内存缓存：所有商品列表（供 UI 绘制及快速查询）
-    std::vector<Product> product_list;
+    // 内存缓存：当前发布的商品目录快照（为空表示尚未加载）
+    // 只通过 std::atomic_load / std::atomic_store 访问，读者不加锁
+    std::shared_ptr<const Catalog> catalog;
+
+    // 已分配的最大目录版本号
+    std::atomic<uint64_t> catalog_version{0};
+
+    // 已分配的最大匹配版本号（只在搜索结果可能变化时分配新的）
+    std::atomic<uint64_t> match_version{0};
+
+    // 首次加载的互斥锁：目录为空时只有一个线程读取数据库，其余等待结果
+    std::mutex first_load_mtx;
+
+    // 后台重建已排队但尚未开始，期间的失效合并为一次重建
+    std::atomic<bool> rebuild_queued{false};
+
+    // 商品写入次数：首次加载期间发生写入时，加载完成后补一次重建
+    std::atomic<uint64_t> catalog_writes{0};
+
+    // 库存变化但快照尚未更新的商品，由后台一次读取它们的库存
+    std::mutex stock_mtx;
+    std::unordered_set<int> stock_dirty;
 
-    // 标志位：product_list 是否已加载
-    bool is_loaded = false;
+    // 库存刷新已排队但尚未开始，期间的库存变化合并为一次刷新
+    std::atomic<bool> stock_refresh_queued{false};
+
+    // 辅助函数：从数据库读取商品并发布为新快照，返回当前最新的快照
+    // （读取期间已有更晚开始的读取发布了快照时，放弃本次结果）
+    std::shared_ptr<const Catalog> reload_catalog();
+
+    // 辅助函数：商品写入数据库后安排一次后台重建，重建完成前读者仍使用旧快照
+    // （尚未加载目录时不重建，首次使用时读取的就是最新数据）
+    void invalidate_catalog();
+
+    // 辅助函数：只有库存变化时，安排后台读取该商品的库存并发布修改了库存的
+    // 快照副本，不重新读取整张表
+    void invalidate_stock(const int product_id);
+
+    // 辅助函数：读取库存有变化的商品的当前库存，写入当前快照的副本并发布
+    void refresh_stock();
+
+    // 辅助函数：为新读取的商品列表确定匹配版本
+    // 与当前快照的商品 ID、名称、状态逐一相同（如只改了库存或价格）时沿用其
+    // 匹配版本，此前的搜索结果仍然有效；否则分配新的匹配版本
+    uint64_t match_version_for(const std::vector<Product> &products);
+
+    // 搜索缓存容量（不同的搜索词个数）
+    static constexpr size_t SEARCH_CACHE_CAPACITY = 128;
+
+    // 搜索缓存：匹配版本 + 是否包含已删除 + 规范化搜索词 -> 匹配结果
+    // 只改库存、价格的目录更新不改变匹配版本，缓存条目继续命中；
+    // 匹配版本变化后旧条目不会再命中，随 LRU 淘汰
+    // 值为共享指针，命中时不拷贝匹配下标
+    LruCache<std::string, std::shared_ptr<const ProductSearchMatch>>
+        search_cache{
+            SEARCH_CACHE_CAPACITY,
+            [](const std::string &key,
+               const std::shared_ptr<const ProductSearchMatch> &match) {
+                return sizeof(std::string) + key.capacity() +
+                       sizeof(ProductSearchMatch) +
+                       match->indices.capacity() * sizeof(size_t) +
+                       match->positions.capacity() * sizeof(size_t);
+            }};
+
+    // 辅助函数：规范化搜索词（去除首尾空白并转为小写）
+    static std::string normalize_query(const std::string &query);
+
+    // 辅助函数：经由搜索缓存在当前目录快照中搜索
+    ProductSearchResult cached_search(const std::string &query,
+                                      const bool include_deleted);
+
+    // 辅助函数：从数据库读取所有商品（包含已删除的商品）
+    static std::vector<Product> fetch_all_products();
+
+    // 辅助函数：按 ID 精确匹配或名称模糊匹配目录中的商品
+    // （lower_query 须已规范化）
+    static ProductSearchMatch match_products(const Catalog &catalog,
+                                             const std::string &lower_query,
+                                             const bool include_deleted);
+
+    // 批量导入/导出时每批处理的行数
+    static constexpr size_t TRANSFER_BATCH_SIZE = 1000;
+
+    // 辅助函数：解析并校验一行商品数据，失败时写入错误信息
+    static std::optional<Product>
+    parse_product_fields(const std::vector<std::string> &fields,
+                         std::string &error_message);
+
+    // 辅助函数：按商品名多行 upsert 一批商品，成功返回 true
+    bool upsert_product_batch(const std::vector<Product> &batch);
+
+    // 目录重建线程（最后声明，析构时最先停止，任务不会访问已销毁的成员）
+    Executor rebuild_executor{1};
 
   public:
     /**
@@ -67,12 +394,34 @@ class ProductManager {
     /**
      * @brief 加载所有商品
      *
-     * 从数据库中读取所有商品信息（包含已删除的商品）到内存缓存中。
+     * 从数据库中读取所有商品信息（包含已删除的商品），构建新的目录快照并发布。
+     * 读取期间其他线程仍可使用旧快照。
      *
      * @return 无返回值
      */
     void load_all_product();
 
+    /**
+     * @brief 获取当前的商品目录快照
+     *
+     * 未加载时先从数据库加载（并发调用只加载一次）。商品写入后目录在后台
+     * 重建，重建完成前返回写入前的快照。可在任意线程调用，
+     * 返回的快照不会再被修改。
+     *
+     * @return std::shared_ptr<const Catalog> 商品目录快照
+     */
+    std::shared_ptr<const Catalog> get_catalog();
+
+    /**
+     * @brief 用给定的商品直接发布新的目录快照
+     *
+     * 不访问数据库，供基准测试等离线场景构造确定的目录；
+     * 商品 ID、名称或状态与当前快照不同时，此前的搜索缓存条目不会再命中。
+     *
+     * @param products 目录中的全部商品
+     */
+    void publish_catalog(std::vector<Product> products);
+
     /**
      * @brief 添加新商品
      *
@@ -84,6 +433,37 @@ class ProductManager {
     void add_product(const std::string &product_name, const double price,
                      const int stock);
 
+    /**
+     * @brief 从文件批量导入商品
+     *
+     * 逐行流式读取（内存占用与文件大小无关），扩展名为 .csv 时按逗号分隔，
+     * 否则按制表符分隔。每行可以是 `商品名 价格 库存 [状态]`，
+     * 也可以是 `商品ID 商品名 价格 库存 状态 [...]`（与 export_products 和
+     * LOAD DATA 格式兼容，商品 ID 被忽略）。首行为表头时自动跳过。
+     * 通过校验的行按商品名分批 upsert：已存在的商品更新价格、库存和状态。
+     *
+     * @param path 文件路径
+     * @param on_progress 进度回调（可为空），每批写入后调用
+     * @return ProductTransferReport 导入结果统计
+     */
+    ProductTransferReport
+    import_products(const std::string &path,
+                    const ProductProgressCallback &on_progress = nullptr);
+
+    /**
+     * @brief 导出全部商品到文件（包括已删除商品）
+     *
+     * 按商品 ID 分批读取并写出，内存占用与商品总数无关。
+     * 输出格式为带表头的 `商品ID 商品名 价格 库存 状态`，可直接用于 import_products。
+     *
+     * @param path 文件路径（扩展名为 .csv 时按逗号分隔，否则按制表符分隔）
+     * @param on_progress 进度回调（可为空），每批写出后调用
+     * @return ProductTransferReport 导出结果统计
+     */
+    ProductTransferReport
+    export_products(const std::string &path,
+                    const ProductProgressCallback &on_progress = nullptr);
+
     /**
      * @brief 删除商品
      *
@@ -106,26 +486,69 @@ class ProductManager {
     void update_product(const std::string &product_name, const int product_id,
                         const double price, const int stock);
 
+    /**
+     * @brief 原子地调整商品库存
+     *
+     * 在一条 UPDATE 语句中完成“读取-增减-写回”，并发的扣减与恢复不会互相覆盖；
+     * 扣减后库存将小于 0 或商品已下架时不做修改（归还库存不受下架限制）。
+     *
+     * @param product_id 商品 ID
+     * @param delta 库存变化量（扣减为负）
+     * @return true 已调整
+     * @return false 商品不存在、已下架、库存不足或数据库出错
+     */
+    bool adjust_stock(const int product_id, const int delta);
+
     /**
      * @brief 搜索所有商品 (包括已删除)
      *
      * 支持 ID 精确匹配或商品名称模糊查找。
      *
      * @param query 查询关键词（ID字符串或商品名）
-     * @return std::vector<Product> 匹配的商品列表
+     * @return ProductSearchResult 匹配的商品（引用目录快照，不拷贝商品）
      */
-    std::vector<Product> search_all_product(const std::string &query);
+    ProductSearchResult search_all_product(const std::string &query);
 
     /**
      * @brief 搜索有效商品 (仅限未删除)
      *
      * 仅支持商品名称模糊查找，且过滤掉状态为 DELETED
      * 的商品。通常用于用户端展示。
+     * 在当前商品目录快照中搜索，同一搜索词在目录更新前直接命中搜索缓存。
      *
      * @param name 商品名关键词
-     * @return std::vector<Product> 匹配的商品列表
+     * @return ProductSearchResult 匹配的商品（引用目录快照，不拷贝商品）
+     */
+    ProductSearchResult search_product(const std::string &name);
+
+    /**
+     * @brief 分页浏览商品
+     *
+     * 排序、过滤与分页都在 SQL 中完成，只读取一页数据，
+     * 首屏与后续翻页的耗时都与商品总数无关。
+     *
+     * @param query 排序方式、状态过滤与每页商品数
+     * @param after 游标：从该位置之后开始，默认从第一页开始
+     * @return ProductPage 当前页商品及下一页游标
+     */
+    ProductPage list_products_page(const ProductPageQuery &query,
+                                   const ProductPageCursor &after = {});
+
+    /**
+     * @brief 获取商品搜索缓存的命中统计
+     *
+     * @return CacheStats 命中/未命中次数、条目数及估算内存
+     */
+    CacheStats get_search_cache_stats() const;
+
+    /**
+     * @brief 估算当前目录快照占用的内存
+     *
+     * 只读取已发布的快照，不会触发加载；仍被旧搜索结果引用的旧快照不计入。
+     *
+     * @return size_t 商品数组、商品名与 ID 索引的估算字节数，未加载时为 0
      */
-    std::vector<Product> search_product(const std::string &name);
+    size_t get_catalog_bytes() const;
 
     /**
      * @brief 恢复商品
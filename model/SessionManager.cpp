@@ -0,0 +1,82 @@
+#include "SessionManager.h"
+#include "SecurityUtils.h"
+#include <algorithm>
+
+using std::string;
+
+void SessionManager::release_slot(const int user_id) {
+    // 引用计数只在分段锁内增加，此处为 1 说明只剩表中的这一份
+    users.erase_if(user_id, [](const UserSlot &slot) {
+        return slot.tokens.empty() && slot.lock.use_count() <= 1;
+    });
+}
+
+string SessionManager::open(const User &user) {
+    Session session;
+    session.token = SecurityUtils::random_token();
+    session.user_id = user.id;
+    session.username = user.username;
+    session.is_admin = user.is_admin;
+    session.last_seen = std::chrono::steady_clock::now();
+
+    // 先登记到用户，超出上限时取出最早的令牌
+    std::vector<string> evicted;
+    users.with(user.id, [&](UserSlot &slot) {
+        slot.tokens.push_back(session.token);
+        while (slot.tokens.size() > MAX_SESSIONS_PER_USER) {
+            evicted.push_back(slot.tokens.front());
+            slot.tokens.erase(slot.tokens.begin());
+        }
+    });
+
+    // 两张表分别加锁，不同时持有两把锁
+    sessions.set(session.token, session);
+    for (const auto &token : evicted)
+        sessions.erase(token);
+    return session.token;
+}
+
+std::optional<Session> SessionManager::find(const string &token) {
+    std::optional<Session> found;
+    sessions.visit(token, [&found](Session &session) {
+        session.last_seen = std::chrono::steady_clock::now();
+        found = session;
+    });
+    return found;
+}
+
+bool SessionManager::close(const string &token) {
+    auto session = sessions.get(token);
+    if (!session || !sessions.erase(token))
+        return false;
+
+    users.visit(session->user_id, [&token](UserSlot &slot) {
+        slot.tokens.erase(
+            std::remove(slot.tokens.begin(), slot.tokens.end(), token),
+            slot.tokens.end());
+    });
+    release_slot(session->user_id);
+    return true;
+}
+
+size_t SessionManager::expire_idle(const std::chrono::seconds idle) {
+    auto deadline = std::chrono::steady_clock::now() - idle;
+
+    std::vector<std::pair<int, string>> expired;
+    sessions.erase_if([&](const string &token, const Session &session) {
+        if (session.last_seen >= deadline)
+            return false;
+        expired.emplace_back(session.user_id, token);
+        return true;
+    });
+
+    for (const auto &[user_id, token] : expired) {
+        users.visit(user_id, [&token = token](UserSlot &slot) {
+            slot.tokens.erase(
+                std::remove(slot.tokens.begin(), slot.tokens.end(), token),
+                slot.tokens.end());
+        });
+        release_slot(user_id);
+    }
+    return expired.size();
+}
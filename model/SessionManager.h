@@ -0,0 +1,142 @@
+/**
+ * @file      SessionManager.h
+ * @brief     多用户会话管理
+ * @details   UserManager 只记录一个当前用户，适合单用户的终端界面；
+ *            服务端同时服务许多用户时，由本类按令牌保存登录会话，
+ *            并提供按用户串行化的执行入口。会话与按用户的状态
+ *            都保存在分段加锁的哈希表中，每个用户另有自己的互斥锁，
+ *            不同用户之间不争用同一把锁。
+ */
+
+#pragma once
+#include "ShardedMap.h"
+#include "UserManager.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 登录会话
+ *
+ */
+struct Session {
+    std::string token;     ///< 会话令牌
+    int user_id = -1;      ///< 用户 ID
+    std::string username;  ///< 用户名
+    bool is_admin = false; ///< 是否为管理员
+    std::chrono::steady_clock::time_point last_seen; ///< 最近一次使用的时间
+};
+
+/**
+ * @brief 会话管理类
+ *
+ * 所有方法均可在多个线程上并发调用。
+ */
+class SessionManager {
+  public:
+    // 每个用户最多同时保持的会话数，超出时关闭最早的会话
+    static constexpr size_t MAX_SESSIONS_PER_USER = 8;
+
+  private:
+    // 按用户的状态：该用户打开的会话令牌（按打开顺序），
+    // 以及 with_user 使用的互斥锁（在分段锁内取出，分段锁外加锁）
+    struct UserSlot {
+        std::vector<std::string> tokens;
+        std::shared_ptr<std::mutex> lock;
+    };
+
+    ShardedMap<std::string, Session> sessions; ///< 令牌 -> 会话
+    ShardedMap<int, UserSlot> users;           ///< 用户 ID -> 按用户的状态
+
+    // 辅助函数：用户没有会话且没有线程持有其锁时删除其状态，
+    // 只被 with_user 访问过的用户不会一直留在表中
+    void release_slot(const int user_id);
+
+  public:
+    SessionManager() = default;
+
+    SessionManager(const SessionManager &) = delete;
+    SessionManager &operator=(const SessionManager &) = delete;
+
+    /**
+     * @brief 为已通过验证的用户打开会话
+     *
+     * @param user 用户（通常来自 UserManager::get_current_user）
+     * @return std::string 会话令牌
+     */
+    std::string open(const User &user);
+
+    /**
+     * @brief 查找会话并刷新其最近使用时间
+     *
+     * @param token 会话令牌
+     * @return std::optional<Session> 会话的拷贝，令牌无效时为空
+     */
+    std::optional<Session> find(const std::string &token);
+
+    /**
+     * @brief 关闭会话
+     *
+     * @param token 会话令牌
+     * @return true 会话存在并已关闭
+     * @return false 令牌无效
+     */
+    bool close(const std::string &token);
+
+    /**
+     * @brief 关闭空闲时间超过 idle 的会话
+     *
+     * @param idle 最长空闲时间
+     * @return size_t 关闭的会话数
+     */
+    size_t expire_idle(const std::chrono::seconds idle);
+
+    /**
+     * @brief 在该用户的锁内执行操作
+     *
+     * 同一用户的多步写操作（如结账：写购物车、扣库存、生成订单）
+     * 在此串行执行，互不交错；每个用户有自己的锁，不同用户可以并行。
+     * 回调执行期间不持有分段锁，回调中可以调用本对象的其他方法，
+     * 但不能对同一用户再次调用 with_user。
+     *
+     * @param user_id 用户 ID
+     * @param fn 回调，无参数
+     * @return 回调的返回值
+     */
+    template <typename Fn>
+    decltype(auto) with_user(const int user_id, Fn &&fn) {
+        auto mtx = users.with(user_id, [](UserSlot &slot) {
+            if (!slot.lock)
+                slot.lock = std::make_shared<std::mutex>();
+            return slot.lock;
+        });
+
+        // 离开时（包括异常）先解锁并放下引用，再清理无人使用的状态
+        struct Release {
+            SessionManager *self;
+            int user_id;
+            std::shared_ptr<std::mutex> mtx;
+
+            ~Release() {
+                mtx->unlock();
+                mtx.reset();
+                self->release_slot(user_id);
+            }
+        };
+
+        mtx->lock();
+        Release release{this, user_id, std::move(mtx)};
+        return std::forward<Fn>(fn)();
+    }
+
+    /**
+     * @brief 当前打开的会话数
+     *
+     * @return size_t 会话数
+     */
+    size_t size() const { return sessions.size(); }
+};
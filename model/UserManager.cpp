@@ -1,9 +1,16 @@
 #include "UserManager.h"
 #include "Database.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <ctime>
 #include <fstream>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 
 using std::ifstream;
 using std::nullopt;
@@ -13,23 +20,55 @@ using std::string;
 
 Result UserManager::check_login(const string &username,
                                 const string &input_password) {
-    optional<User> user_opt = get_user_by_name(username);
+    TRACE_SCOPE("model", "UserManager::check_login");
+    optional<User> user = authenticate(username, input_password);
+    if (!user.has_value())
+        return Result::FAILURE;
+
+    active_user = std::make_shared<User>(*user);
+    return Result::SUCCESS;
+}
+
+optional<User> UserManager::authenticate(const string &username,
+                                         const string &input_password) {
+    TRACE_SCOPE("model", "UserManager::authenticate");
+    // 认证路径直接读库（缓存中的用户不含密码哈希）
+    optional<User> user_opt = fetch_user("username", username, true);
 
     if (user_opt.has_value()) {
         User user = user_opt.value();
 
         if (check_password(input_password, string(user.password)) ==
             Result::SUCCESS) {
-            active_user =
-                std::make_shared<User>(user.username, user.password,
-                                       user.is_admin, user.id, user.status);
+            // 存储的哈希为旧格式或成本与当前配置不符时，趁明文可用时重新哈希
+            if (SecurityUtils::needs_rehash(user.password))
+                rehash_password(user.id, input_password, user.password);
+
+            user.password = "";
             Logger::LOG_INFO("用户登录成功，用户名: " + username);
-            return Result::SUCCESS;
+            return user;
         }
     }
 
     Logger::LOG_INFO("用户登录失败，用户名: " + username);
-    return Result::FAILURE;
+    return std::nullopt;
+}
+
+void UserManager::rehash_password(const int user_id,
+                                  const string &input_password,
+                                  string &stored_password) {
+    try {
+        string new_hash = SecurityUtils::hash_password(input_password);
+        Database::sql("UPDATE users SET password = ? WHERE id = ?")
+            .bind(new_hash, user_id)
+            .execute();
+        stored_password = new_hash;
+        LOG_INFO("用户密码哈希已按当前成本更新，用户 ID: " +
+                 std::to_string(user_id));
+    } catch (const mysqlx::Error &e) {
+        // 重算失败不影响本次登录，下次登录会再次尝试
+        LOG_WARNING("更新用户密码哈希失败: " + std::string(e.what()));
+    }
 }
 
 Result UserManager::is_valid_username_format(const string &username,
@@ -69,6 +108,7 @@ Result UserManager::check_register(const string &username,
                                    const string &password,
                                    const string &again_password,
                                    string &error_message) {
+    TRACE_SCOPE("model", "UserManager::check_register");
     if (is_valid_username_format(username, error_message) == Result::FAILURE ||
         is_valid_password_format(password, error_message) == Result::FAILURE)
         return Result::FAILURE;
@@ -92,6 +132,7 @@ Result UserManager::check_register(const string &username,
 }
 
 void UserManager::append_user(const User &new_user) {
+    TRACE_SCOPE("model", "UserManager::append_user");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法添加新用户。");
     }
@@ -101,173 +142,385 @@ void UserManager::append_user(const User &new_user) {
     bool is_admin = new_user.is_admin;
 
     try {
-        Database::get_session()
-            .sql("INSERT INTO users (username, password, is_admin) "
-                 "VALUES(?, ?, ?)")
+        Database::sql("INSERT INTO users (username, password, is_admin) "
+                      "VALUES(?, ?, ?)")
             .bind(username, password, is_admin)
             .execute();
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("添加新用户失败: " + std::string(e.what()));
     }
+
+    invalidate_cache(new_user.id, username);
+}
+
+UserImportReport UserManager::import_users(const string &path,
+                                           const int iterations) {
+    TRACE_SCOPE("model", "UserManager::import_users");
+    UserImportReport report;
+    auto start = std::chrono::steady_clock::now();
+
+    ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("无法打开用户文件: " + path);
+        return report;
+    }
+    if (!Database::is_connected()) {
+        LOG_ERROR("数据库未连接，无法导入用户。");
+        return report;
+    }
+
+    std::unordered_set<string> seen_usernames;
+    std::vector<User> batch;
+    std::vector<string> passwords;
+    batch.reserve(IMPORT_BATCH_SIZE);
+    passwords.reserve(IMPORT_BATCH_SIZE);
+
+    // 并行哈希一批密码后写入数据库
+    auto flush = [&] {
+        if (batch.empty())
+            return;
+        auto hashes = SecurityUtils::hash_passwords(passwords, iterations);
+        for (size_t i = 0; i < batch.size(); i++)
+            batch[i].password = std::move(hashes[i]);
+
+        auto inserted = insert_user_batch(batch);
+        if (inserted.has_value()) {
+            report.imported += *inserted;
+            report.duplicates += batch.size() - *inserted;
+        } else {
+            report.failed += batch.size();
+        }
+
+        batch.clear();
+        passwords.clear();
+    };
+
+    string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        report.total_lines++;
+
+        std::istringstream iss(line);
+        string username, password;
+        int is_admin = 0;
+        iss >> username >> password;
+        if (!(iss >> is_admin))
+            is_admin = 0;
+
+        string error;
+        if (is_valid_username_format(username, error) == Result::FAILURE ||
+            is_valid_password_format(password, error) == Result::FAILURE) {
+            report.invalid++;
+            continue;
+        }
+
+        // 超出列宽的用户名会让整批插入失败（严格模式），入批前按字符数拦下
+        size_t username_chars = std::count_if(
+            username.begin(), username.end(),
+            [](unsigned char c) { return (c & 0xC0) != 0x80; });
+        if (username_chars > USERNAME_COLUMN_SIZE) {
+            report.invalid++;
+            continue;
+        }
+
+        // 文件内重复的用户名直接跳过，数据库中的重复由唯一键检测
+        if (!seen_usernames.insert(username).second) {
+            report.duplicates++;
+            continue;
+        }
+
+        batch.emplace_back(username, "", is_admin != 0);
+        passwords.push_back(std::move(password));
+        if (batch.size() == IMPORT_BATCH_SIZE)
+            flush();
+    }
+    flush();
+
+    report.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    LOG_INFO("用户导入完成: 导入 " + std::to_string(report.imported) +
+             " 个，重复 " + std::to_string(report.duplicates) + " 个，无效 " +
+             std::to_string(report.invalid) + " 个，失败 " +
+             std::to_string(report.failed) + " 个，耗时 " +
+             std::to_string(report.seconds) + " 秒，" +
+             std::to_string(static_cast<long long>(report.users_per_second())) +
+             " 用户/秒");
+    return report;
+}
+
+optional<size_t> UserManager::insert_user_batch(const std::vector<User> &batch) {
+    string sql = "INSERT INTO users (username, password, is_admin) VALUES ";
+    for (size_t i = 0; i < batch.size(); i++)
+        sql += (i == 0 ? "(?, ?, ?)" : ", (?, ?, ?)");
+    // 只把 username 唯一键冲突当作重复跳过；不用 INSERT IGNORE，
+    // 以免其他错误（如超长被截断）被降级为警告
+    sql += " ON DUPLICATE KEY UPDATE id = id";
+
+    try {
+        auto stmt = Database::sql(sql);
+        for (const auto &user : batch)
+            stmt.bind(user.username, user.password, user.is_admin);
+        // 冲突行的 id = id 不修改数据，不计入受影响行数，受影响行数即写入数
+        return stmt.execute().getAffectedItemsCount();
+    } catch (const mysqlx::Error &e) {
+        LOG_ERROR("批量添加用户失败: " + std::string(e.what()));
+    }
+    return nullopt;
 }
 
 void UserManager::update_user(const int id, const string username,
                               const string password, const bool is_admin) {
+    TRACE_SCOPE("model", "UserManager::update_user");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法更新用户。");
     }
 
     try {
-        string hash_password = SecurityUtils::hash_password(password);
-        Database::get_session()
-            .sql("UPDATE users SET username = ?, password = ?, is_admin = ? "
-                 "WHERE id = ?")
-            .bind(username, hash_password, is_admin, id)
-            .execute();
+        if (password.empty()) {
+            // 密码留空表示不修改
+            Database::sql("UPDATE users SET username = ?, is_admin = ? "
+                          "WHERE id = ?")
+                .bind(username, is_admin, id)
+                .execute();
+        } else {
+            string hash_password = SecurityUtils::hash_password(password);
+            Database::sql("UPDATE users SET username = ?, password = ?, "
+                          "is_admin = ? WHERE id = ?")
+                .bind(username, hash_password, is_admin, id)
+                .execute();
+        }
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("更新用户失败: " + std::string(e.what()));
     }
+
+    invalidate_cache(id, username);
 }
 
-optional<User> UserManager::get_user_by_name(const string &username) {
+void UserManager::invalidate_cache(const int user_id, const string &username) {
+    // 先按 id 找到旧用户名（用户名可能已被修改），再清理两份缓存
+    if (user_id >= 0) {
+        if (auto cached = user_cache.get(user_id))
+            username_cache.erase(cached->username);
+        user_cache.erase(user_id);
+    }
+    if (!username.empty())
+        username_cache.erase(username);
+}
+
+template <typename T>
+optional<User> UserManager::fetch_user(const string &column, const T &value,
+                                       const bool with_password) {
     if (!Database::is_connected())
         LOG_ERROR("数据库未连接，无法获取用户信息。");
 
     optional<User> result = nullopt;
 
+    // column 只由本类传入固定列名，不来自用户输入
+    string sql = "SELECT id, username, is_admin, status";
+    if (with_password)
+        sql += ", password";
+    sql += " FROM users WHERE " + column + " = ?";
+
     try {
-        auto res = Database::get_session()
-                       .sql("SELECT id, username, password, is_admin FROM users "
-                            "WHERE username = ?")
-                       .bind(username)
-                       .execute();
+        auto stmt = Database::sql(sql);
+        stmt.bind(value);
+        mysqlx::SqlResult res = stmt.execute();
         auto row = res.fetchOne();
         if (row) {
             User temp;
             temp.id = row[0].get<int>();
             temp.username = row[1].get<std::string>();
-            temp.password = row[2].get<std::string>();
-            temp.is_admin = row[3].get<bool>();
+            temp.is_admin = row[2].get<bool>();
+            temp.status = static_cast<UserStatus>(row[3].get<int>());
+            if (with_password)
+                temp.password = row[4].get<std::string>();
 
             result = temp;
         }
     } catch (const mysqlx::Error &e) {
-        LOG_ERROR("根据用户名获取用户信息失败，" + string(e.what()));
+        LOG_ERROR("根据 " + column + " 获取用户信息失败，" + string(e.what()));
     }
 
     return result;
 }
 
-std::optional<User> UserManager::get_user_by_id(const int user_id) {
-    if (!Database::is_connected())
-        LOG_ERROR("数据库未连接，无法获取用户信息。");
+namespace {
+
+// 按用户名 / ID 查询用户时缓存是否命中
+void record_user_cache(const bool hit) {
+    auto &registry = Metrics::Registry::get_instance();
+    static auto &hits = registry.counter(
+        "shopping_cache_requests_total", "查询缓存的访问次数",
+        {{"cache", "user"}, {"result", "hit"}});
+    static auto &misses = registry.counter(
+        "shopping_cache_requests_total", "查询缓存的访问次数",
+        {{"cache", "user"}, {"result", "miss"}});
+    (hit ? hits : misses).inc();
+}
 
-    optional<User> result = nullopt;
+} // namespace
 
-    try {
-        auto res = Database::get_session()
-                       .sql("SELECT id, username, password, is_admin FROM users "
-                            "WHERE id = ?")
-                       .bind(user_id)
-                       .execute();
-        auto row = res.fetchOne();
-        if (row) {
-            User temp;
-            temp.id = row[0].get<int>();
-            temp.username = row[1].get<std::string>();
-            temp.password = row[2].get<std::string>();
-            temp.is_admin = row[3].get<bool>();
+void UserManager::record_lookup(const bool hit) {
+    (hit ? lookup_hits : lookup_misses)++;
+    record_user_cache(hit);
+}
 
-            result = temp;
+optional<User> UserManager::get_user_by_name(const string &username) {
+    TRACE_SCOPE("model", "UserManager::get_user_by_name");
+    // 先查用户名索引，再查用户缓存
+    if (auto cached_id = username_cache.get(username)) {
+        auto cached = user_cache.get(*cached_id);
+        // 两份缓存各自淘汰，改名后旧用户名的索引可能还在：
+        // 指向的用户已不叫这个名字时丢弃索引，回到数据库查询
+        if (cached && cached->username == username) {
+            record_lookup(true);
+            return cached;
         }
-    } catch (const mysqlx::Error &e) {
-        LOG_ERROR("根据用户 id 获取用户信息失败，" + string(e.what()));
+        if (cached)
+            username_cache.erase(username);
+    }
+    record_lookup(false);
+
+    optional<User> result = fetch_user("username", username, false);
+    if (result.has_value()) {
+        user_cache.put(result->id, *result);
+        username_cache.put(result->username, result->id);
     }
 
     return result;
 }
 
-std::vector<User> UserManager::search_users_list(const string &query) {
-    if (!Database::is_connected())
-        LOG_ERROR("数据库未连接，无法搜索用户列表。");
+std::optional<User> UserManager::get_user_by_id(const int user_id) {
+    TRACE_SCOPE("model", "UserManager::get_user_by_id");
+    if (auto cached = user_cache.get(user_id)) {
+        record_lookup(true);
+        return cached;
+    }
+    record_lookup(false);
 
-    std::vector<User> result;
+    optional<User> result = fetch_user("id", user_id, false);
+    if (result.has_value()) {
+        user_cache.put(result->id, *result);
+        username_cache.put(result->username, result->id);
+    }
 
-    try {
-        auto res = Database::get_session()
-                       .sql("SELECT id, username, password, is_admin, status "
-                            "FROM users")
-                       .execute();
+    return result;
+}
 
-        while (auto row = res.fetchOne()) {
-            User temp;
+CacheStats UserManager::get_cache_stats() const {
+    CacheStats stats = user_cache.stats();
+    stats.hits = lookup_hits;
+    stats.misses = lookup_misses;
+    stats.bytes += username_cache.stats().bytes;
+    return stats;
+}
 
-            if (query.empty()) {
-                temp.id = row[0].get<int>();
-                temp.username = row[1].get<std::string>();
-                temp.password = row[2].get<std::string>();
-                temp.is_admin = row[3].get<bool>();
-                temp.status = static_cast<UserStatus>(row[4].get<int>());
-                result.push_back(temp);
-                continue;
-            }
+string UserManager::escape_like_pattern(const string &text) {
+    string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        if (c == '\\' || c == '%' || c == '_')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
 
-            string low_query = query;
+UserPage UserManager::search_users_page(const string &query,
+                                        const int after_id,
+                                        const int page_size) {
+    TRACE_SCOPE("model", "UserManager::search_users_page");
+    if (!Database::is_connected())
+        LOG_ERROR("数据库未连接，无法搜索用户列表。");
 
-            std::transform(low_query.begin(), low_query.end(),
-                           low_query.begin(), ::tolower);
+    UserPage page;
+    int limit = std::max(page_size, 1);
 
-            temp.id = row[0].get<int>();
-            temp.username = row[1].get<std::string>();
-            temp.password = row[2].get<std::string>();
-            temp.is_admin = row[3].get<bool>();
-            temp.status = static_cast<UserStatus>(row[4].get<int>());
+    // 纯数字的查询词同时按 ID 精确匹配
+    bool is_numeric =
+        !query.empty() && query.size() <= 9 &&
+        std::all_of(query.begin(), query.end(),
+                    [](unsigned char ch) { return std::isdigit(ch); });
 
-            string user_id_str = std::to_string(temp.id);
-            string username_str = string(temp.username);
+    // 按 id 做 keyset 分页，用户名走 idx_username 前缀匹配，不查询密码列
+    string sql = "SELECT id, username, is_admin, status FROM users "
+                 "WHERE id > ? ";
+    if (is_numeric)
+        sql += "AND (id = ? OR username LIKE ?) ";
+    else if (!query.empty())
+        sql += "AND username LIKE ? ";
+    sql += "ORDER BY id LIMIT ?";
 
-            if (user_id_str == low_query) {
-                result.push_back(temp);
+    try {
+        auto stmt = Database::sql(sql);
+        stmt.bind(after_id);
+        if (is_numeric)
+            stmt.bind(std::stoi(query));
+        if (!query.empty())
+            stmt.bind(escape_like_pattern(query) + "%");
+        // 多取一行用于判断是否还有下一页
+        stmt.bind(limit + 1);
+
+        auto res = stmt.execute();
+        while (auto row = res.fetchOne()) {
+            if (static_cast<int>(page.users.size()) == limit) {
+                page.has_more = true;
                 break;
             }
 
-            if (username_str.find(low_query) != string::npos) {
-                result.push_back(temp);
-            }
+            User temp;
+            temp.id = row[0].get<int>();
+            temp.username = row[1].get<std::string>();
+            temp.is_admin = row[2].get<bool>();
+            temp.status = static_cast<UserStatus>(row[3].get<int>());
+            page.users.push_back(temp);
         }
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("搜索用户列表失败，" + string(e.what()));
-    };
-    return result;
+    }
+
+    if (!page.users.empty())
+        page.next_cursor = page.users.back().id;
+
+    return page;
 }
 
 void UserManager::delete_user(const int user_id) {
+    TRACE_SCOPE("model", "UserManager::delete_user");
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法删除用户。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE users SET status = ? WHERE id = ?")
+        Database::sql("UPDATE users SET status = ? WHERE id = ?")
             .bind(static_cast<int>(UserStatus::DELETED), user_id)
             .execute();
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("删除用户失败: " + std::string(e.what()));
     }
+
+    invalidate_cache(user_id);
 }
 
 void UserManager::restore_user(const int user_id) {
+    TRACE_SCOPE("model", "UserManager::restore_user");
 
     if (!Database::is_connected()) {
         LOG_ERROR("数据库未连接，无法恢复用户。");
     }
 
     try {
-        Database::get_session()
-            .sql("UPDATE users SET status = ? WHERE id = ?")
+        Database::sql("UPDATE users SET status = ? WHERE id = ?")
             .bind(0, user_id)
             .execute();
     } catch (const mysqlx::Error &e) {
         LOG_ERROR("恢复用户失败: " + std::string(e.what()));
     }
+
+    invalidate_cache(user_id);
 }
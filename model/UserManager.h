@@ -8,12 +8,15 @@
 #pragma once
 
 #include "Logger.h"
+#include "LruCache.h"
 #include "Result.h"
 #include "SecurityUtils.h"
 #include <Utils.h>
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 /**
  * @brief 用户状态枚举
@@ -39,7 +42,7 @@ class User {
     static constexpr size_t MAX_PASSWORD_SIZE = 16 + 1;
     static constexpr size_t MIN_USERNAME_SIZE = 2 + 1;
     static constexpr size_t MIN_PASSWORD_SIZE = 5 + 1;
-    static constexpr size_t HASH_PASSWORD_SIZE = 97 + 1;
+    static constexpr size_t HASH_PASSWORD_SIZE = 128 + 1;
 
     int id;
 
@@ -60,6 +63,36 @@ class User {
           is_admin(role_opt), status(status) {};
 };
 
+/**
+ * @brief 用户分页查询结果
+ *
+ * 按用户 id 做 keyset 分页，列表中的用户不包含密码哈希
+ *
+ */
+struct UserPage {
+    std::vector<User> users; // 当前页的用户列表
+    int next_cursor = 0;     // 下一页的游标（本页最后一个用户的 id）
+    bool has_more = false;   // 是否还有下一页
+};
+
+/**
+ * @brief 批量导入用户的结果统计
+ *
+ */
+struct UserImportReport {
+    size_t total_lines = 0; // 读取的有效数据行数（不含空行和注释）
+    size_t imported = 0;    // 成功写入的用户数
+    size_t duplicates = 0;  // 用户名重复而跳过的行数（文件内或已存在于数据库）
+    size_t invalid = 0;     // 格式不合法而跳过的行数
+    size_t failed = 0;      // 因数据库错误未能写入的行数
+    double seconds = 0;     // 总耗时（秒）
+
+    // 导入吞吐（用户/秒）
+    double users_per_second() const {
+        return seconds > 0 ? imported / seconds : 0;
+    }
+};
+
 /**
  * @brief 用户管理类
  *
@@ -76,6 +109,50 @@ class UserManager {
     // 当前激活的用户
     std::shared_ptr<User> active_user = nullptr;
 
+    // 用户缓存容量
+    static constexpr size_t USER_CACHE_CAPACITY = 256;
+
+    // 用户缓存：用户 id -> 用户记录（不含密码哈希）
+    LruCache<int, User> user_cache{
+        USER_CACHE_CAPACITY, [](const int &, const User &user) {
+            return sizeof(int) + sizeof(User) + user.username.capacity() +
+                   user.password.capacity();
+        }};
+
+    // 用户名索引缓存：用户名 -> 用户 id
+    LruCache<string, int> username_cache{
+        USER_CACHE_CAPACITY, [](const string &username, const int &) {
+            return sizeof(string) + username.capacity() + sizeof(int);
+        }};
+
+    // 按查询计的命中统计：一次按用户名查询要访问两份缓存，但只计一次
+    std::atomic<size_t> lookup_hits{0};
+    std::atomic<size_t> lookup_misses{0};
+
+    // 辅助函数：记录一次按 id 或用户名查询是否命中缓存
+    void record_lookup(const bool hit);
+
+    // 辅助函数：按指定列从数据库读取单个用户（不经过缓存）
+    template <typename T>
+    std::optional<User> fetch_user(const string &column, const T &value,
+                                   const bool with_password);
+
+    // 批量导入时每条 INSERT 语句包含的行数
+    static constexpr size_t IMPORT_BATCH_SIZE = 1000;
+
+    // users.username 列的长度（VARCHAR(16)，按字符计）
+    static constexpr size_t USERNAME_COLUMN_SIZE = 16;
+
+    // 辅助函数：多行插入一批用户，返回实际写入的行数（重复用户名被忽略），
+    // 数据库出错时返回 nullopt
+    std::optional<size_t> insert_user_batch(const std::vector<User> &batch);
+
+    // 辅助函数：写操作后清理该用户的缓存条目
+    void invalidate_cache(const int user_id, const string &username = "");
+
+    // 辅助函数：转义 LIKE 模式中的通配符（%、_ 和转义符本身）
+    static string escape_like_pattern(const string &text);
+
     // 检查用户名格式
     Result is_valid_username_format(const string &username,
                                     string &error_message);
@@ -89,6 +166,10 @@ class UserManager {
             return Result::FAILURE;
     }
 
+    // 辅助函数：以当前哈希成本重新计算密码并写回数据库（登录成功后调用）
+    void rehash_password(const int user_id, const string &input_password,
+                         string &stored_password);
+
   public:
     /**
      * @brief  初始化类对象
@@ -106,10 +187,24 @@ class UserManager {
      * @param username 待验证的用户名
      * @param password 待验证的密码（明文）
      * @return  Result 成功返回 Result::SUCCESS，失败返回 Result::FAILURE
-     * @note 这里密码是和数据库中存储的哈希加密密码进行比对的
+     * @note 这里密码是和数据库中存储的哈希加密密码进行比对的，
+     *       若存储的哈希为旧格式或迭代次数与当前配置不符，会自动重新哈希
      */
     Result check_login(const string &username, const string &password);
 
+    /**
+     * @brief 校验用户名与密码，不改变当前用户
+     *
+     * 与 check_login 相同的校验（含按当前成本重新哈希），但不写入 active_user，
+     * 多个线程可以用同一个管理器并行校验（HTTP 服务、后台服务的登录）。
+     *
+     * @param username 待验证的用户名
+     * @param password 待验证的密码（明文）
+     * @return optional<User> 校验通过的用户（不含密码哈希），失败时为空
+     */
+    std::optional<User> authenticate(const string &username,
+                                     const string &password);
+
     /**
      * @brief 验证用户注册
      *
@@ -169,6 +264,20 @@ class UserManager {
      */
     void append_user(const User &new_user);
 
+    /**
+     * @brief 从文件批量导入用户
+     *
+     * 逐行读取文件，每行格式为 `用户名 密码 [是否管理员(0/1)]`，
+     * 以 # 开头的行和空行会被跳过。密码在全部硬件线程上并行哈希，
+     * 再以多行 INSERT 分批写入。用户名重复（文件内或数据库中已存在）的行
+     * 被跳过，超出 username 列宽的行计为无效。
+     *
+     * @param path 用户文件路径
+     * @param iterations 哈希迭代次数，测试数据可用较低成本，用户登录时会按当前成本重新哈希
+     * @return UserImportReport 导入结果统计
+     */
+    UserImportReport import_users(const string &path, const int iterations);
+
     /**
      * @brief 更新用户信息
      *
@@ -176,7 +285,7 @@ class UserManager {
      *
      * @param id 用户 id
      * @param username 用户名
-     * @param password 用户密码
+     * @param password 新密码（明文，内部哈希），为空时不修改密码
      * @param is_admin 是否有管理权限
      * @return 无返回值
      */
@@ -188,6 +297,7 @@ class UserManager {
      *
      * @param  username 用户名
      * @return optional<User>  成功：用户对象（），失败：nullopt
+     * @note 结果经过 LRU 缓存，返回的用户对象不包含密码哈希
      */
     std::optional<User> get_user_by_name(const string &username);
 
@@ -196,17 +306,35 @@ class UserManager {
      *
      * @param  user_id  用户 ID
      * @return optional<User>  成功：用户对象（），失败：nullopt
+     * @note 结果经过 LRU 缓存，返回的用户对象不包含密码哈希
      */
     std::optional<User> get_user_by_id(const int user_id);
 
     /**
-     * @brief 根据查询词（用户名或 ID）匹配用户列表（支持 ID
-     * 精确查找和用户名模糊查找）
+     * @brief 获取用户缓存的命中统计
+     *
+     * 命中次数按查询计（按用户名查询经过两级缓存也只计一次），
+     * 条目数与容量为按 id 的用户缓存。
+     *
+     * @return CacheStats 命中/未命中次数及缓存大小
+     */
+    CacheStats get_cache_stats() const;
+
+    // 分页查询默认每页用户数
+    static constexpr int DEFAULT_PAGE_SIZE = 20;
+
+    /**
+     * @brief 分页搜索用户（支持 ID 精确查找和用户名前缀查找）
+     *
+     * 过滤在 SQL 中完成，按 id 做 keyset 分页，耗时与用户总数无关。
      *
-     * @param  query  查询词
-     * @return vector<User> 返回的用户对象列表
+     * @param  query  查询词，为空时列出全部用户
+     * @param  after_id  游标：只返回 id 大于该值的用户，首页传 0
+     * @param  page_size  每页用户数
+     * @return UserPage 当前页用户（不含密码哈希）及下一页游标
      */
-    std::vector<User> search_users_list(const string &query);
+    UserPage search_users_page(const string &query, const int after_id = 0,
+                               const int page_size = DEFAULT_PAGE_SIZE);
 
     /**
      * @brief 根据用户 id，删除用户（添加删除标志）
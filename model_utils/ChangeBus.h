@@ -0,0 +1,149 @@
+/**
+ * @file      ChangeBus.h
+ * @brief     数据变更事件总线
+ * @details   各管理类在写入数据库后发布类型化的变更事件，
+ *            事件在一帧内按类型合并，由 UI 线程统一分发给订阅者，
+ *            订阅者只重新加载受影响的数据，且每类数据只加载一次。
+ */
+
+#pragma once
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 变更事件类型（位标志，可按位或合并）
+ *
+ */
+enum ChangeType : unsigned int {
+    PRODUCT_CHANGED = 1u << 0,       ///< 商品信息或库存变化
+    CART_CHANGED = 1u << 1,          ///< 购物车条目变化
+    ORDER_CHANGED = 1u << 2,         ///< 订单状态、地址或配送方式变化
+    HISTORY_ORDER_CHANGED = 1u << 3, ///< 历史订单变化
+    ALL_CHANGES = PRODUCT_CHANGED | CART_CHANGED | ORDER_CHANGED |
+                  HISTORY_ORDER_CHANGED,
+};
+
+/**
+ * @brief 变更事件总线（单例）
+ *
+ * publish 可在任意线程调用，只记录待分发的类型；
+ * flush 由 UI 线程在每次事件处理结束时调用，把合并后的类型一次性分发出去。
+ */
+class ChangeBus {
+  public:
+    using Handler = std::function<void(unsigned int changes)>;
+
+  private:
+    std::mutex mtx;
+
+    // 尚未分发的变更类型
+    unsigned int pending = 0;
+
+    // 订阅者：订阅 ID -> (关注的类型, 回调)
+    std::map<int, std::pair<unsigned int, Handler>> subscribers;
+    int next_id = 1;
+
+    // 有新的待分发变更时调用（例如请求 UI 处理一次事件）
+    std::function<void()> on_pending;
+
+    ChangeBus() = default;
+
+  public:
+    ChangeBus(const ChangeBus &) = delete;
+    ChangeBus &operator=(const ChangeBus &) = delete;
+
+    /**
+     * @brief 获取全局总线实例
+     *
+     * @return ChangeBus& 总线实例
+     */
+    static ChangeBus &get_instance() {
+        static ChangeBus instance;
+        return instance;
+    }
+
+    /**
+     * @brief 发布变更事件
+     *
+     * 同一帧内的多次发布合并为一次分发；
+     * 从无待分发变更变为有时调用 on_pending 回调。
+     *
+     * @param changes 变更类型（ChangeType 的按位或）
+     */
+    void publish(const unsigned int changes) {
+        std::function<void()> notify;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            bool was_empty = pending == 0;
+            pending |= changes;
+            if (was_empty && changes != 0)
+                notify = on_pending;
+        }
+        // 在锁外回调，避免回调中再次发布导致死锁
+        if (notify)
+            notify();
+    }
+
+    /**
+     * @brief 分发所有待处理的变更
+     *
+     * 每个订阅者最多被调用一次，参数为其关注的类型中实际发生变化的部分。
+     *
+     * @return unsigned int 本次分发的变更类型
+     */
+    unsigned int flush() {
+        unsigned int changes;
+        std::vector<std::pair<unsigned int, Handler>> targets;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            changes = pending;
+            pending = 0;
+            if (changes == 0)
+                return 0;
+            for (const auto &entry : subscribers)
+                targets.push_back(entry.second);
+        }
+
+        for (const auto &[mask, handler] : targets) {
+            if (changes & mask)
+                handler(changes & mask);
+        }
+        return changes;
+    }
+
+    /**
+     * @brief 订阅变更事件
+     *
+     * @param mask 关注的变更类型
+     * @param handler 回调，在调用 flush 的线程中执行
+     * @return int 订阅 ID，用于取消订阅
+     */
+    int subscribe(const unsigned int mask, Handler handler) {
+        std::lock_guard<std::mutex> lock(mtx);
+        int id = next_id++;
+        subscribers[id] = {mask, std::move(handler)};
+        return id;
+    }
+
+    /**
+     * @brief 取消订阅
+     *
+     * @param id subscribe 返回的订阅 ID
+     */
+    void unsubscribe(const int id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        subscribers.erase(id);
+    }
+
+    /**
+     * @brief 设置有新的待分发变更时的回调
+     *
+     * @param callback 回调（可能在任意线程执行）
+     */
+    void set_on_pending(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(mtx);
+        on_pending = std::move(callback);
+    }
+};
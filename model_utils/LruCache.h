@@ -0,0 +1,186 @@
+/**
+ * @file      LruCache.h
+ * @brief     通用 LRU 缓存模板
+ * @details   容量有界、线程安全的最近最少使用缓存，并统计命中率，
+ *            供各管理类缓存数据库查询结果。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief 缓存统计信息
+ *
+ */
+struct CacheStats {
+    size_t hits = 0;     ///< 命中次数
+    size_t misses = 0;   ///< 未命中次数
+    size_t size = 0;     ///< 当前条目数
+    size_t capacity = 0; ///< 容量上限
+    size_t bytes = 0;    ///< 估算占用的内存（字节，未设置估算函数时为 0）
+
+    // 命中率（尚无访问时为 0）
+    double hit_ratio() const {
+        size_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+    }
+
+    CacheStats &operator+=(const CacheStats &other) {
+        hits += other.hits;
+        misses += other.misses;
+        size += other.size;
+        capacity += other.capacity;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+/**
+ * @brief LRU 缓存
+ *
+ * 所有操作由内部互斥锁保护，可在多线程间共享。
+ * 超过容量时淘汰最久未访问的条目。
+ *
+ * @tparam Key   键类型（需可哈希）
+ * @tparam Value 值类型（按值拷贝返回）
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+  public:
+    // 估算单个条目占用的内存（字节）
+    using Weigher = std::function<size_t(const Key &, const Value &)>;
+
+  private:
+    using Entry = std::pair<Key, Value>;
+
+    size_t capacity;
+
+    Weigher weigher;
+
+    // 当前所有条目的估算内存之和
+    size_t bytes = 0;
+
+    // 访问顺序链表：表头为最近访问
+    std::list<Entry> entries;
+
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+
+    mutable std::mutex mtx;
+
+    // 辅助函数：估算条目内存（调用方需持有锁）
+    size_t weigh(const Entry &entry) const {
+        return weigher ? weigher(entry.first, entry.second) : 0;
+    }
+
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+
+  public:
+    /**
+     * @brief 构造函数
+     *
+     * @param capacity 缓存容量上限（至少为 1）
+     * @param weigher 条目内存估算函数（可为空，为空时不统计内存）
+     */
+    explicit LruCache(const size_t capacity, Weigher weigher = nullptr)
+        : capacity(capacity == 0 ? 1 : capacity),
+          weigher(std::move(weigher)) {}
+
+    LruCache(const LruCache &) = delete;
+    LruCache &operator=(const LruCache &) = delete;
+
+    /**
+     * @brief 查询缓存，命中时将条目移到表头
+     *
+     * @param key 键
+     * @return std::optional<Value> 命中返回值的拷贝，否则返回 nullopt
+     */
+    std::optional<Value> get(const Key &key) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            misses++;
+            return std::nullopt;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        hits++;
+        return it->second->second;
+    }
+
+    /**
+     * @brief 写入或覆盖条目，超出容量时淘汰最久未访问的条目
+     *
+     * @param key 键
+     * @param value 值
+     */
+    void put(const Key &key, Value value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            bytes -= weigh(*it->second);
+            it->second->second = std::move(value);
+            bytes += weigh(*it->second);
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+
+        entries.emplace_front(key, std::move(value));
+        index[key] = entries.begin();
+        bytes += weigh(entries.front());
+
+        if (entries.size() > capacity) {
+            bytes -= weigh(entries.back());
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+    /**
+     * @brief 移除指定条目（不存在时忽略）
+     *
+     * @param key 键
+     */
+    void erase(const Key &key) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index.find(key);
+        if (it == index.end())
+            return;
+        bytes -= weigh(*it->second);
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    /**
+     * @brief 清空缓存（统计数据保留）
+     *
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mtx);
+        entries.clear();
+        index.clear();
+        bytes = 0;
+    }
+
+    /**
+     * @brief 获取缓存统计信息
+     *
+     * @return CacheStats 命中/未命中次数及当前大小
+     */
+    CacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        CacheStats s;
+        s.hits = hits.load();
+        s.misses = misses.load();
+        s.size = entries.size();
+        s.capacity = capacity;
+        s.bytes = bytes;
+        return s;
+    }
+};
@@ -1,4 +1,12 @@
 #include "SecurityUtils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+std::atomic<int> SecurityUtils::target_iterations{
+    SecurityUtils::DEFAULT_ITERATIONS};
 
 std::string
 SecurityUtils::bin_to_hex_str(const std::vector<unsigned char> &data) {
@@ -21,15 +29,58 @@ SecurityUtils::hex_str_to_bin(const std::string &hex) {
     return data;
 }
 
+bool SecurityUtils::parse_stored_value(const std::string &stored_value,
+                                       HashParams &params) {
+    std::string prefix = std::string(HASH_SCHEME) + "$";
+
+    // 旧格式：salt$hash，迭代次数固定为 DEFAULT_ITERATIONS
+    if (stored_value.compare(0, prefix.size(), prefix) != 0) {
+        size_t delimiter_pos = stored_value.find('$');
+        if (delimiter_pos == std::string::npos)
+            return false;
+
+        params.iterations = DEFAULT_ITERATIONS;
+        params.salt_hex = stored_value.substr(0, delimiter_pos);
+        params.hash_hex = stored_value.substr(delimiter_pos + 1);
+        params.is_legacy = true;
+        return true;
+    }
+
+    // 新格式：pbkdf2-sha256$iterations$salt$hash
+    size_t iter_pos = prefix.size();
+    size_t salt_pos = stored_value.find('$', iter_pos);
+    if (salt_pos == std::string::npos)
+        return false;
+    size_t hash_pos = stored_value.find('$', salt_pos + 1);
+    if (hash_pos == std::string::npos)
+        return false;
+
+    try {
+        params.iterations =
+            std::stoi(stored_value.substr(iter_pos, salt_pos - iter_pos));
+    } catch (...) {
+        return false;
+    }
+    if (params.iterations < MIN_ITERATIONS ||
+        params.iterations > MAX_ITERATIONS)
+        return false;
+
+    params.salt_hex = stored_value.substr(salt_pos + 1, hash_pos - salt_pos - 1);
+    params.hash_hex = stored_value.substr(hash_pos + 1);
+    params.is_legacy = false;
+    return true;
+}
+
 std::vector<unsigned char>
 SecurityUtils::pbkdf2(const std::string &password,
-                      const std::vector<unsigned char> &salt) {
+                      const std::vector<unsigned char> &salt,
+                      const int iterations) {
     std::vector<unsigned char> hash(KEY_LENGTH);
 
     // 使用 OpenSSL 的 PKCS5_PBKDF2_HMAC 函数
     // 使用 Sha256 算法
     PKCS5_PBKDF2_HMAC(password.c_str(), password.length(), salt.data(),
-                      salt.size(), ITERATIONS, EVP_sha256(), KEY_LENGTH,
+                      salt.size(), iterations, EVP_sha256(), KEY_LENGTH,
                       hash.data());
     return hash;
 }
@@ -48,34 +99,161 @@ bool SecurityUtils::constant_time_compare(const std::vector<unsigned char> &a,
 }
 
 std::string SecurityUtils::hash_password(const std::string &password) {
+    return hash_password(password, get_iterations());
+}
+
+std::string SecurityUtils::hash_password(const std::string &password,
+                                         const int iterations) {
     // 生成随机盐
     std::vector<unsigned char> salt(SALT_LENGTH);
     if (RAND_bytes(salt.data(), SALT_LENGTH) != 1) {
         throw std::runtime_error("OpenSSL random generation failed");
     }
+    return hash_password(password, salt, iterations);
+}
+
+std::string SecurityUtils::hash_password(const std::string &password,
+                                         const std::vector<unsigned char> &salt,
+                                         const int iterations) {
+    if (salt.size() != SALT_LENGTH)
+        throw std::invalid_argument("salt must be SALT_LENGTH bytes");
+    int iter = std::clamp(iterations, MIN_ITERATIONS, MAX_ITERATIONS);
 
     // 计算 hash
-    std::vector<unsigned char> hash = pbkdf2(password, salt);
+    std::vector<unsigned char> hash = pbkdf2(password, salt, iter);
+
+    // 拼接结果（带算法与迭代次数，便于之后调整成本）
+    return std::string(HASH_SCHEME) + "$" + std::to_string(iter) + "$" +
+           bin_to_hex_str(salt) + "$" + bin_to_hex_str(hash);
+}
+
+std::string SecurityUtils::random_token(const size_t bytes) {
+    std::vector<unsigned char> token(bytes);
+    if (RAND_bytes(token.data(), static_cast<int>(bytes)) != 1) {
+        throw std::runtime_error("OpenSSL random generation failed");
+    }
+    return bin_to_hex_str(token);
+}
+
+std::vector<std::string> SecurityUtils::hash_parallel(
+    const size_t count, unsigned int threads,
+    const std::function<std::string(size_t)> &hash_one) {
+    std::vector<std::string> hashes(count);
 
-    // 拼接结果
-    return bin_to_hex_str(salt) + "$" + bin_to_hex_str(hash);
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<size_t>(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++)
+            hashes[i] = hash_one(i);
+        return hashes;
+    }
+
+    // 交错分配下标，各线程只写自己负责的位置，无需加锁
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            try {
+                for (size_t i = t; i < count; i += threads)
+                    hashes[i] = hash_one(i);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    for (auto &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+    return hashes;
+}
+
+std::vector<std::string>
+SecurityUtils::hash_passwords(const std::vector<std::string> &passwords,
+                              const int iterations, unsigned int threads) {
+    return hash_parallel(passwords.size(), threads, [&](size_t i) {
+        return hash_password(passwords[i], iterations);
+    });
+}
+
+std::vector<std::string> SecurityUtils::hash_passwords(
+    const std::vector<std::string> &passwords,
+    const std::vector<std::vector<unsigned char>> &salts, const int iterations,
+    unsigned int threads) {
+    if (salts.size() != passwords.size())
+        throw std::invalid_argument("salts and passwords differ in size");
+    return hash_parallel(passwords.size(), threads, [&](size_t i) {
+        return hash_password(passwords[i], salts[i], iterations);
+    });
 }
 
 bool SecurityUtils::check_password(const std::string &password,
                                    const std::string &stored_value) {
     // 解析字符串
-    size_t delimiter_pos = stored_value.find('$');
-
-    if (delimiter_pos == std::string::npos)
+    HashParams params;
+    if (!parse_stored_value(stored_value, params))
         return false;
 
-    std::string salt_hex = stored_value.substr(0, delimiter_pos);
-    std::string hash_hex = stored_value.substr(delimiter_pos + 1);
+    std::vector<unsigned char> salt = hex_str_to_bin(params.salt_hex);
+    std::vector<unsigned char> stored_hash = hex_str_to_bin(params.hash_hex);
 
-    std::vector<unsigned char> salt = hex_str_to_bin(salt_hex);
-    std::vector<unsigned char> stored_hash = hex_str_to_bin(hash_hex);
-
-    std::vector<unsigned char> new_hash = pbkdf2(password, salt);
+    std::vector<unsigned char> new_hash =
+        pbkdf2(password, salt, params.iterations);
 
     return constant_time_compare(new_hash, stored_hash);
 }
+
+bool SecurityUtils::needs_rehash(const std::string &stored_value) {
+    HashParams params;
+    if (!parse_stored_value(stored_value, params))
+        return false; // 无法解析的值交给 check_password 处理
+
+    if (params.is_legacy)
+        return true;
+
+    // 启动校准存在少量抖动，偏差在容忍度内不重算，避免每次登录都写库
+    long long target = get_iterations();
+    long long diff = std::llabs(params.iterations - target);
+    return diff * 100 > target * REHASH_TOLERANCE_PERCENT;
+}
+
+void SecurityUtils::set_iterations(const int iterations) {
+    target_iterations = std::clamp(iterations, MIN_ITERATIONS, MAX_ITERATIONS);
+}
+
+int SecurityUtils::calibrate_iterations(
+    const std::chrono::milliseconds target_cost) {
+    using clock = std::chrono::steady_clock;
+
+    // 用少量迭代探测单次迭代耗时，取三次中最快的一次以排除调度干扰
+    constexpr int PROBE_ITERATIONS = 20000;
+    std::vector<unsigned char> salt(SALT_LENGTH, 0x5a);
+
+    double best_ns = 0;
+    for (int i = 0; i < 3; i++) {
+        auto start = clock::now();
+        pbkdf2("calibration", salt, PROBE_ITERATIONS);
+        double ns = std::chrono::duration<double, std::nano>(clock::now() -
+                                                             start)
+                        .count();
+        if (i == 0 || ns < best_ns)
+            best_ns = ns;
+    }
+
+    double ns_per_iteration = std::max(best_ns / PROBE_ITERATIONS, 1.0);
+    double target_ns =
+        std::chrono::duration<double, std::nano>(target_cost).count();
+
+    // 取整到千位，减少不同次启动之间的抖动
+    long long iterations =
+        static_cast<long long>(target_ns / ns_per_iteration) / 1000 * 1000;
+    iterations = std::clamp<long long>(iterations, DEFAULT_ITERATIONS,
+                                       MAX_ITERATIONS);
+
+    set_iterations(static_cast<int>(iterations));
+    return get_iterations();
+}
@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <openssl/evp.h>
@@ -10,11 +13,29 @@
 #include <vector>
 
 class SecurityUtils {
-  private:
+  public:
     // 相关常量
-    static constexpr int ITERATIONS = 100000; // 迭代次数
-    static constexpr int KEY_LENGTH = 32;     // 生成的 Hash 长度（256 bit）
-    static constexpr int SALT_LENGTH = 16;    // 盐的长度（128 bit）
+    static constexpr int DEFAULT_ITERATIONS = 100000; // 默认（旧格式）迭代次数
+    static constexpr int MIN_ITERATIONS = 1000;       // 允许设置的最小迭代次数
+    static constexpr int MAX_ITERATIONS = 10000000;   // 允许设置的最大迭代次数
+    static constexpr int DEFAULT_TARGET_MS = 100; // 启动校准默认的单次哈希耗时
+    static constexpr int REHASH_TOLERANCE_PERCENT = 10; // 迭代次数偏差容忍度
+    static constexpr const char *HASH_SCHEME = "pbkdf2-sha256"; // 算法标识
+    static constexpr int SALT_LENGTH = 16; // 盐的长度（128 bit）
+
+  private:
+    static constexpr int KEY_LENGTH = 32; // 生成的 Hash 长度（256 bit）
+
+    // 当前目标迭代次数（新生成的哈希使用该值）
+    static std::atomic<int> target_iterations;
+
+    // 解析后的存储哈希参数
+    struct HashParams {
+        int iterations;
+        std::string salt_hex;
+        std::string hash_hex;
+        bool is_legacy; // 是否为不带版本信息的旧格式 salt$hash
+    };
 
     // 辅助函数：二进制转十六进制字符串
     static std::string bin_to_hex_str(const std::vector<unsigned char> &data);
@@ -22,18 +43,66 @@ class SecurityUtils {
     // 辅助函数：十六进制字符转二进制
     static std::vector<unsigned char> hex_str_to_bin(const std::string &hex);
 
+    // 辅助函数：解析存储的哈希字符串（兼容新旧两种格式）
+    static bool parse_stored_value(const std::string &stored_value,
+                                   HashParams &params);
+
     // 执行 PBKDF2 算法
     static std::vector<unsigned char>
-    pbkdf2(const std::string &password, const std::vector<unsigned char> &salt);
+    pbkdf2(const std::string &password, const std::vector<unsigned char> &salt,
+           const int iterations);
+
+    // 辅助函数：把 count 个哈希任务交错分配到多个线程，结果按下标返回
+    static std::vector<std::string>
+    hash_parallel(const size_t count, unsigned int threads,
+                  const std::function<std::string(size_t)> &hash_one);
 
     // 恒定时间比较函数(防止时序攻击)
     static bool constant_time_compare(const std::vector<unsigned char> &a,
                                       const std::vector<unsigned char> &b);
 
   public:
-    // 加密密码（注册时使用）
+    // 加密密码（注册时使用），使用当前目标迭代次数
+    // 格式: pbkdf2-sha256$迭代次数$盐$哈希
     static std::string hash_password(const std::string &password);
 
+    // 加密密码，显式指定迭代次数
+    static std::string hash_password(const std::string &password,
+                                     const int iterations);
+
+    // 加密密码，显式指定盐（长度须为 SALT_LENGTH）；相同输入得到相同结果，
+    // 仅用于生成可复现的测试数据，业务代码应使用随机盐的版本
+    static std::string hash_password(const std::string &password,
+                                     const std::vector<unsigned char> &salt,
+                                     const int iterations);
+
+    // 批量加密密码：在多个线程间并行计算，结果与输入一一对应
+    // threads 为 0 时使用全部硬件线程
+    static std::vector<std::string>
+    hash_passwords(const std::vector<std::string> &passwords,
+                   const int iterations, unsigned int threads = 0);
+
+    // 批量加密密码，salts 与 passwords 一一对应（见上方显式盐的版本）
+    static std::vector<std::string>
+    hash_passwords(const std::vector<std::string> &passwords,
+                   const std::vector<std::vector<unsigned char>> &salts,
+                   const int iterations, unsigned int threads = 0);
+
     static bool check_password(const std::string &password,
                                const std::string &stored_value);
+
+    // 生成随机令牌（十六进制，长度为 bytes 的两倍），用于会话标识
+    static std::string random_token(const size_t bytes = 16);
+
+    // 判断存储的哈希是否需要按当前成本重新计算（旧格式或迭代次数偏差过大）
+    static bool needs_rehash(const std::string &stored_value);
+
+    // 设置 / 获取目标迭代次数（超出范围时自动截断）
+    static void set_iterations(const int iterations);
+
+    static int get_iterations() { return target_iterations.load(); }
+
+    // 微基准校准：测量本机 PBKDF2 速度，使单次哈希耗时接近 target_cost，
+    // 结果不低于 DEFAULT_ITERATIONS，并写入目标迭代次数
+    static int calibrate_iterations(const std::chrono::milliseconds target_cost);
 };
@@ -0,0 +1,184 @@
+/**
+ * @file      ShardedMap.h
+ * @brief     分段加锁的并发哈希表
+ * @details   按键的哈希值把条目分散到固定数量的分段，每段各有一把锁，
+ *            不同分段上的操作互不阻塞。用于保存按用户、按会话划分的状态，
+ *            多个用户同时访问时不需要一把全局锁。
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief 分段加锁的哈希表
+ *
+ * 所有操作只锁住键所在的分段。with 在持有分段锁期间执行回调，
+ * 可用于对同一键的“读取-修改-写回”。分段锁会挡住同一分段的其他键，
+ * 只应短暂持有；需要长时间持有的按键锁应保存在值中（如
+ * std::shared_ptr<std::mutex>），在分段锁内取出、分段锁外加锁。
+ *
+ * @tparam Key        键类型（需可哈希）
+ * @tparam Value      值类型（需可默认构造）
+ * @tparam ShardCount 分段数
+ * @tparam Hash       哈希函数
+ */
+template <typename Key, typename Value, size_t ShardCount = 64,
+          typename Hash = std::hash<Key>>
+class ShardedMap {
+  private:
+    // 每段独占一条缓存行，避免相邻分段的锁互相干扰（伪共享）
+    struct alignas(64) Shard {
+        mutable std::mutex mtx;
+        std::unordered_map<Key, Value, Hash> entries;
+    };
+
+    std::array<Shard, ShardCount> shards;
+    Hash hasher;
+
+    Shard &shard_for(const Key &key) {
+        return shards[hasher(key) % ShardCount];
+    }
+
+    const Shard &shard_for(const Key &key) const {
+        return shards[hasher(key) % ShardCount];
+    }
+
+  public:
+    ShardedMap() = default;
+
+    ShardedMap(const ShardedMap &) = delete;
+    ShardedMap &operator=(const ShardedMap &) = delete;
+
+    /**
+     * @brief 在持有分段锁时访问键对应的值（不存在时默认构造）
+     *
+     * 回调中不能再访问同一个表，否则可能死锁。
+     *
+     * @param key 键
+     * @param fn 回调，参数为 Value&
+     * @return 回调的返回值
+     */
+    template <typename Fn> decltype(auto) with(const Key &key, Fn &&fn) {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        return std::forward<Fn>(fn)(shard.entries[key]);
+    }
+
+    /**
+     * @brief 键存在时在持有分段锁时访问其值
+     *
+     * @param key 键
+     * @param fn 回调，参数为 Value&
+     * @return true 键存在，已执行回调
+     * @return false 键不存在
+     */
+    template <typename Fn> bool visit(const Key &key, Fn &&fn) {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end())
+            return false;
+        std::forward<Fn>(fn)(it->second);
+        return true;
+    }
+
+    /**
+     * @brief 读取键对应的值
+     *
+     * @param key 键
+     * @return std::optional<Value> 值的拷贝，不存在时为空
+     */
+    std::optional<Value> get(const Key &key) const {
+        const Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    /**
+     * @brief 写入键值（已存在时覆盖）
+     *
+     * @param key 键
+     * @param value 值
+     */
+    void set(const Key &key, Value value) {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.entries.insert_or_assign(key, std::move(value));
+    }
+
+    /**
+     * @brief 删除键
+     *
+     * @param key 键
+     * @return true 键存在并已删除
+     * @return false 键不存在
+     */
+    bool erase(const Key &key) {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        return shard.entries.erase(key) > 0;
+    }
+
+    /**
+     * @brief 键存在且其值满足条件时删除
+     *
+     * @param key 键
+     * @param pred 条件，参数为 const Value&
+     * @return true 已删除
+     * @return false 键不存在或不满足条件
+     */
+    template <typename Pred> bool erase_if(const Key &key, Pred pred) {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end() || !pred(it->second))
+            return false;
+        shard.entries.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief 删除满足条件的所有条目（逐段加锁）
+     *
+     * @param pred 条件，参数为 (const Key&, const Value&)
+     * @return size_t 删除的条目数
+     */
+    template <typename Pred> size_t erase_if(Pred pred) {
+        size_t erased = 0;
+        for (auto &shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                if (pred(it->first, it->second)) {
+                    it = shard.entries.erase(it);
+                    erased++;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return erased;
+    }
+
+    /**
+     * @brief 条目总数（逐段加锁累加，并发修改时只是近似值）
+     *
+     * @return size_t 条目数
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (const auto &shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+};
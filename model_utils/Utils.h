@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace Utils {
 
@@ -10,4 +11,99 @@ inline std::string get_database_path(const std::string &filename) {
     return std::string(DATA_PATH) + "/" + filename;
 }
 
+// 统计 UTF-8 字符串的字符（码点）数，非法编码时返回 std::string::npos
+inline size_t utf8_length(const std::string &text) {
+    size_t count = 0;
+    for (size_t i = 0; i < text.size(); count++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        // 由首字节判断该字符占用的字节数
+        size_t len = 0;
+        if (c < 0x80)
+            len = 1;
+        else if ((c >> 5) == 0x6)
+            len = 2;
+        else if ((c >> 4) == 0xE)
+            len = 3;
+        else if ((c >> 3) == 0x1E)
+            len = 4;
+
+        if (len == 0 || i + len > text.size())
+            return std::string::npos;
+        for (size_t k = 1; k < len; k++) {
+            if ((static_cast<unsigned char>(text[i + k]) >> 6) != 0x2)
+                return std::string::npos;
+        }
+        i += len;
+    }
+    return count;
+}
+
+// 拆分一行分隔文本
+// 制表符分隔时按 LOAD DATA 的规则反转义（\t、\n、\\），
+// 逗号分隔时按 CSV 规则处理双引号包裹的字段
+inline std::vector<std::string> split_delimited_line(const std::string &line,
+                                                     const char delimiter) {
+    std::vector<std::string> fields(1);
+    bool in_quotes = false;
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (delimiter == '\t' && c == '\\' && i + 1 < line.size()) {
+            char next = line[++i];
+            if (next == 't')
+                fields.back() += '\t';
+            else if (next == 'n')
+                fields.back() += '\n';
+            else if (next == 'N')
+                fields.back() += "\\N"; // 保留 NULL 标记，由调用方判断
+            else
+                fields.back() += next;
+        } else if (delimiter != '\t' && c == '"') {
+            if (in_quotes && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else {
+                in_quotes = !in_quotes;
+            }
+        } else if (c == delimiter && !in_quotes) {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// 转义单个字段，使其可被 split_delimited_line 还原
+inline std::string escape_delimited_field(const std::string &field,
+                                          const char delimiter) {
+    std::string result;
+    if (delimiter == '\t') {
+        for (char c : field) {
+            if (c == '\t')
+                result += "\\t";
+            else if (c == '\n')
+                result += "\\n";
+            else if (c == '\\')
+                result += "\\\\";
+            else
+                result += c;
+        }
+        return result;
+    }
+
+    if (field.find_first_of(std::string(1, delimiter) + "\"\n") ==
+        std::string::npos)
+        return field;
+
+    result += '"';
+    for (char c : field) {
+        if (c == '"')
+            result += '"';
+        result += c;
+    }
+    result += '"';
+    return result;
+}
+
 } // namespace Utils
@@ -0,0 +1,172 @@
+#include "Codec.h"
+
+namespace Rpc {
+
+void encode(WireWriter &out, const Product &product) {
+    out.str(product.product_name);
+    out.svarint(product.product_id);
+    out.f64(product.price);
+    out.svarint(product.stock);
+    out.svarint(static_cast<int>(product.status));
+}
+
+void decode(WireReader &in, Product &product) {
+    product.product_name = in.str();
+    product.product_id = static_cast<int>(in.svarint());
+    product.price = in.f64();
+    product.stock = static_cast<int>(in.svarint());
+    product.status = static_cast<ProductStatus>(in.svarint());
+}
+
+void encode(WireWriter &out, const CartItem &item) {
+    out.svarint(item.id);
+    out.svarint(item.product_id);
+    out.svarint(item.count);
+    out.svarint(static_cast<int>(item.status));
+    out.svarint(item.delivery_selection);
+}
+
+void decode(WireReader &in, CartItem &item) {
+    item.id = static_cast<int>(in.svarint());
+    item.product_id = static_cast<int>(in.svarint());
+    item.count = static_cast<int>(in.svarint());
+    item.status = static_cast<CartItemStatus>(in.svarint());
+    item.delivery_selection = static_cast<int>(in.svarint());
+}
+
+void encode(WireWriter &out, const OrderItem &item) {
+    out.svarint(item.id);
+    out.svarint(item.product_id);
+    out.svarint(item.order_id);
+    out.svarint(item.count);
+    out.svarint(item.order_time);
+    out.svarint(item.delivery_selection);
+    out.str(item.address);
+    out.svarint(static_cast<int>(item.status));
+}
+
+void decode(WireReader &in, OrderItem &item) {
+    item.id = static_cast<int>(in.svarint());
+    item.product_id = static_cast<int>(in.svarint());
+    item.order_id = in.svarint();
+    item.count = static_cast<int>(in.svarint());
+    item.order_time = static_cast<time_t>(in.svarint());
+    item.delivery_selection = static_cast<int>(in.svarint());
+    item.address = in.str();
+    item.status = static_cast<FullOrderStatus>(in.svarint());
+}
+
+void encode(WireWriter &out, const FullOrder &order) {
+    out.svarint(order.order_id);
+    out.f64(order.total_price);
+    out.svarint(order.order_time);
+    encode(out, order.items);
+    out.str(order.address);
+    out.svarint(static_cast<int>(order.status));
+}
+
+void decode(WireReader &in, FullOrder &order) {
+    order.order_id = in.svarint();
+    order.total_price = in.f64();
+    order.order_time = static_cast<time_t>(in.svarint());
+    decode(in, order.items);
+    order.address = in.str();
+    order.status = static_cast<FullOrderStatus>(in.svarint());
+}
+
+void encode(WireWriter &out, const HistoryOrderItem &item) {
+    out.svarint(item.id);
+    out.str(item.product_name);
+    out.f64(item.price);
+    out.svarint(item.order_id);
+    out.svarint(item.count);
+    out.svarint(item.order_time);
+    out.svarint(item.delivery_selection);
+    out.str(item.address);
+    out.svarint(static_cast<int>(item.status));
+}
+
+void decode(WireReader &in, HistoryOrderItem &item) {
+    item.id = static_cast<int>(in.svarint());
+    item.product_name = in.str();
+    item.price = in.f64();
+    item.order_id = in.svarint();
+    item.count = static_cast<int>(in.svarint());
+    item.order_time = static_cast<time_t>(in.svarint());
+    item.delivery_selection = static_cast<int>(in.svarint());
+    item.address = in.str();
+    item.status = static_cast<FullOrderStatus>(in.svarint());
+}
+
+void encode(WireWriter &out, const HistoryFullOrder &order) {
+    out.svarint(order.order_id);
+    out.f64(order.total_price);
+    out.svarint(order.order_time);
+    encode(out, order.items);
+    out.str(order.address);
+    out.svarint(static_cast<int>(order.status));
+}
+
+void decode(WireReader &in, HistoryFullOrder &order) {
+    order.order_id = in.svarint();
+    order.total_price = in.f64();
+    order.order_time = static_cast<time_t>(in.svarint());
+    decode(in, order.items);
+    order.address = in.str();
+    order.status = static_cast<FullOrderStatus>(in.svarint());
+}
+
+void encode(WireWriter &out, const User &user) {
+    out.svarint(user.id);
+    out.str(user.username);
+    out.boolean(user.is_admin);
+    out.svarint(static_cast<int>(user.status));
+}
+
+void decode(WireReader &in, User &user) {
+    user.id = static_cast<int>(in.svarint());
+    user.username = in.str();
+    user.password = "";
+    user.is_admin = in.boolean();
+    user.status = static_cast<UserStatus>(in.svarint());
+}
+
+void encode(WireWriter &out, const ProductPageQuery &query) {
+    out.u8(static_cast<uint8_t>(query.sort_key));
+    out.boolean(query.descending);
+    out.u8(static_cast<uint8_t>(query.status));
+    out.svarint(query.page_size);
+}
+
+void decode(WireReader &in, ProductPageQuery &query) {
+    query.sort_key = static_cast<ProductSortKey>(in.u8());
+    query.descending = in.boolean();
+    query.status = static_cast<ProductStatusFilter>(in.u8());
+    query.page_size = static_cast<int>(in.svarint());
+}
+
+void encode(WireWriter &out, const ProductPageCursor &cursor) {
+    out.boolean(cursor.at_start);
+    if (!cursor.at_start)
+        encode(out, cursor.last);
+}
+
+void decode(WireReader &in, ProductPageCursor &cursor) {
+    cursor.at_start = in.boolean();
+    if (!cursor.at_start)
+        decode(in, cursor.last);
+}
+
+void encode(WireWriter &out, const ProductPage &page) {
+    encode(out, page.products);
+    encode(out, page.next_cursor);
+    out.boolean(page.has_more);
+}
+
+void decode(WireReader &in, ProductPage &page) {
+    decode(in, page.products);
+    decode(in, page.next_cursor);
+    page.has_more = in.boolean();
+}
+
+} // namespace Rpc
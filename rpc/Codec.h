@@ -0,0 +1,107 @@
+/**
+ * @file      Codec.h
+ * @brief     模型类型的协议编解码
+ * @details   为各管理类使用的数据结构提供 encode / decode 重载，
+ *            服务端与客户端共用，保证两端字段顺序一致。
+ *            用户信息不含密码哈希。
+ */
+
+#pragma once
+#include "HistoryOrderManager.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include "Protocol.h"
+#include "UserManager.h"
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace Rpc {
+
+void encode(WireWriter &out, const Product &product);
+void decode(WireReader &in, Product &product);
+
+void encode(WireWriter &out, const CartItem &item);
+void decode(WireReader &in, CartItem &item);
+
+void encode(WireWriter &out, const OrderItem &item);
+void decode(WireReader &in, OrderItem &item);
+
+void encode(WireWriter &out, const FullOrder &order);
+void decode(WireReader &in, FullOrder &order);
+
+void encode(WireWriter &out, const HistoryOrderItem &item);
+void decode(WireReader &in, HistoryOrderItem &item);
+
+void encode(WireWriter &out, const HistoryFullOrder &order);
+void decode(WireReader &in, HistoryFullOrder &order);
+
+void encode(WireWriter &out, const User &user);
+void decode(WireReader &in, User &user);
+
+void encode(WireWriter &out, const ProductPageQuery &query);
+void decode(WireReader &in, ProductPageQuery &query);
+
+void encode(WireWriter &out, const ProductPageCursor &cursor);
+void decode(WireReader &in, ProductPageCursor &cursor);
+
+void encode(WireWriter &out, const ProductPage &page);
+void decode(WireReader &in, ProductPage &page);
+
+// --- 容器 ---
+
+template <typename T>
+void encode(WireWriter &out, const std::vector<T> &items) {
+    out.varint(items.size());
+    for (const auto &item : items)
+        encode(out, item);
+}
+
+template <typename T> void decode(WireReader &in, std::vector<T> &items) {
+    size_t size = in.count();
+    items.clear();
+    items.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        T item{};
+        decode(in, item);
+        items.push_back(std::move(item));
+    }
+}
+
+// 订单号 -> 订单（值中已含订单号，只编码值）
+template <typename T>
+void encode(WireWriter &out, const std::map<long long, T> &orders) {
+    out.varint(orders.size());
+    for (const auto &entry : orders)
+        encode(out, entry.second);
+}
+
+template <typename T>
+void decode(WireReader &in, std::map<long long, T> &orders) {
+    size_t size = in.count();
+    orders.clear();
+    for (size_t i = 0; i < size; i++) {
+        T order{};
+        decode(in, order);
+        long long order_id = order.order_id;
+        orders.emplace(order_id, std::move(order));
+    }
+}
+
+template <typename T>
+void encode(WireWriter &out, const std::optional<T> &value) {
+    out.boolean(value.has_value());
+    if (value)
+        encode(out, *value);
+}
+
+template <typename T> void decode(WireReader &in, std::optional<T> &value) {
+    value.reset();
+    if (in.boolean()) {
+        T item{};
+        decode(in, item);
+        value = std::move(item);
+    }
+}
+
+} // namespace Rpc
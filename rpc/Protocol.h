@@ -0,0 +1,242 @@
+/**
+ * @file      Protocol.h
+ * @brief     后台服务的二进制通信协议
+ * @details   客户端与守护进程之间通过 Unix 域套接字交换帧。
+ *
+ *            请求帧: [u32 帧长][u32 请求 ID][u16 方法][负载]
+ *            响应帧: [u32 帧长][u32 请求 ID][u8 状态][u8 变更类型][负载]
+ *
+ *            帧长不含自身的 4 字节，定长字段均为小端序；负载中的整数使用
+ *            varint（有符号数先做 zigzag 编码），字符串与数组以 varint
+ *            长度开头。客户端可以不等响应连续发送多个请求（流水线），
+ *            服务端按同一连接上的请求顺序执行并按顺序返回响应。
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace Rpc {
+
+// 协议版本，握手（PING）时返回；负载格式变化时递增
+constexpr uint32_t PROTOCOL_VERSION = 3;
+
+// 单帧最大长度，超过时视为协议错误并断开连接
+constexpr uint32_t MAX_FRAME_SIZE = 16u << 20;
+
+// 商品搜索每页的默认条数与上限：结果分页返回，单个响应帧不随目录增大
+constexpr uint32_t DEFAULT_SEARCH_LIMIT = 50;
+constexpr uint32_t MAX_SEARCH_LIMIT = 500;
+
+// 帧头长度（含 4 字节帧长）
+constexpr size_t REQUEST_HEADER_SIZE = 4 + 4 + 2;
+constexpr size_t RESPONSE_HEADER_SIZE = 4 + 4 + 1 + 1;
+
+// 默认的套接字路径
+constexpr const char *DEFAULT_SOCKET_PATH = "/tmp/shopping_app.sock";
+
+/**
+ * @brief 远程调用的方法，与各管理类的接口一一对应
+ *
+ */
+enum class Method : uint16_t {
+    PING = 0, ///< 握手，返回协议版本
+
+    USER_LOGIN = 10,    ///< UserManager::check_login（成功后绑定到该连接）
+    USER_REGISTER = 11, ///< UserManager::check_register
+    USER_LOGOUT = 12,   ///< 解除该连接上的登录
+
+    PRODUCT_SEARCH = 20, ///< ProductManager::search_product（分页）
+    PRODUCT_GET = 21,    ///< ProductManager::get_product
+    PRODUCT_PAGE = 22,   ///< ProductManager::list_products_page
+    PRODUCT_UPDATE = 23, ///< ProductManager::update_product
+    PRODUCT_STOCK = 24,  ///< ProductManager::adjust_stock
+
+    CART_FETCH = 30,    ///< CartManager::fetch_cart
+    CART_ADD = 31,      ///< CartManager::add_item
+    CART_UPDATE = 32,   ///< CartManager::update_item
+    CART_DELETE = 33,   ///< CartManager::delete_item
+    CART_CHECKOUT = 34, ///< CartManager::checkout
+    CART_PURCHASE = 35, ///< 扣库存、结算选中商品并生成订单（服务端一次完成）
+
+    ORDER_FETCH = 40,       ///< OrderManager::fetch_full_orders
+    ORDER_ADD = 41,         ///< OrderManager::add_order
+    ORDER_CANCEL = 42,      ///< OrderManager::cancel_order
+    ORDER_UPDATE_INFO = 43, ///< OrderManager::update_order_info
+
+    HISTORY_FETCH = 50,       ///< HistoryOrderManager::fetch_history_orders
+    HISTORY_ADD = 51,         ///< HistoryOrderManager::add_history_order
+    HISTORY_CANCEL = 52,      ///< HistoryOrderManager::cancel_history_order
+    HISTORY_UPDATE_INFO = 53, ///< HistoryOrderManager::update_history_order_info
+    HISTORY_CLEAR = 54,       ///< HistoryOrderManager::delete_all_history_orders
+};
+
+/**
+ * @brief 响应状态
+ *
+ */
+enum class Status : uint8_t {
+    OK = 0,             ///< 成功，负载为返回值
+    ERROR = 1,          ///< 服务端执行失败，负载为错误信息
+    UNKNOWN_METHOD = 2, ///< 不支持的方法
+    BAD_REQUEST = 3,    ///< 请求负载无法解析
+    UNAUTHORIZED = 4,   ///< 连接未登录，或无权访问该用户的数据
+};
+
+/**
+ * @brief 协议数据格式错误（负载截断、长度越界等）
+ *
+ */
+class WireError : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief 负载编码器
+ *
+ */
+class WireWriter {
+  private:
+    std::string buffer;
+
+  public:
+    // 定长小端整数（用于帧头）
+    void fixed32(const uint32_t value) {
+        for (int i = 0; i < 4; i++)
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void fixed16(const uint16_t value) {
+        buffer.push_back(static_cast<char>(value & 0xFF));
+        buffer.push_back(static_cast<char>(value >> 8));
+    }
+
+    void u8(const uint8_t value) { buffer.push_back(static_cast<char>(value)); }
+
+    void boolean(const bool value) { u8(value ? 1 : 0); }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    // 有符号整数：zigzag 编码后按 varint 写出，小的负数也只占一两个字节
+    void svarint(const int64_t value) {
+        varint((static_cast<uint64_t>(value) << 1) ^
+               static_cast<uint64_t>(value >> 63));
+    }
+
+    void f64(const double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; i++)
+            buffer.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+
+    void str(const std::string_view text) {
+        varint(text.size());
+        buffer.append(text);
+    }
+
+    void raw(const std::string_view bytes) { buffer.append(bytes); }
+
+    const std::string &data() const { return buffer; }
+
+    size_t size() const { return buffer.size(); }
+};
+
+/**
+ * @brief 负载解码器（数据不足时抛出 WireError）
+ *
+ */
+class WireReader {
+  private:
+    const unsigned char *cursor;
+    const unsigned char *end;
+
+    void require(const size_t n) const {
+        if (static_cast<size_t>(end - cursor) < n)
+            throw WireError("负载长度不足");
+    }
+
+  public:
+    explicit WireReader(const std::string_view bytes)
+        : cursor(reinterpret_cast<const unsigned char *>(bytes.data())),
+          end(cursor + bytes.size()) {}
+
+    uint32_t fixed32() {
+        require(4);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(cursor[i]) << (8 * i);
+        cursor += 4;
+        return value;
+    }
+
+    uint16_t fixed16() {
+        require(2);
+        uint16_t value = cursor[0] | (cursor[1] << 8);
+        cursor += 2;
+        return value;
+    }
+
+    uint8_t u8() {
+        require(1);
+        return *cursor++;
+    }
+
+    bool boolean() { return u8() != 0; }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        throw WireError("varint 过长");
+    }
+
+    int64_t svarint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    double f64() {
+        require(8);
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++)
+            bits |= static_cast<uint64_t>(cursor[i]) << (8 * i);
+        cursor += 8;
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string str() {
+        uint64_t size = varint();
+        require(size);
+        std::string text(reinterpret_cast<const char *>(cursor), size);
+        cursor += size;
+        return text;
+    }
+
+    // 数组长度：每个元素至少占一个字节，超过剩余字节数时视为格式错误
+    size_t count() {
+        uint64_t size = varint();
+        require(size);
+        return static_cast<size_t>(size);
+    }
+
+    bool at_end() const { return cursor == end; }
+};
+
+} // namespace Rpc
@@ -0,0 +1,261 @@
+#include "RpcServer.h"
+#include "ChangeBus.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace Rpc;
+
+RpcServer::RpcServer(ShoppingService &service, const unsigned int worker_count)
+    : service(service), executor(worker_count) {}
+
+RpcServer::~RpcServer() {
+    stop();
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        ::unlink(socket_path.c_str());
+    }
+}
+
+bool RpcServer::start(const std::string &path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("套接字路径过长: " + path);
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // 上次异常退出可能留下套接字文件：能连上说明服务仍在运行，不能删除；
+    // 同名的普通文件也不删除
+    struct stat st {};
+    if (::lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            LOG_ERROR(path + " 已存在且不是套接字");
+            return false;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 &&
+                    ::connect(probe, reinterpret_cast<sockaddr *>(&addr),
+                              sizeof(addr)) == 0;
+        if (probe >= 0)
+            ::close(probe);
+        if (live) {
+            LOG_ERROR("已有后台服务在 " + path + " 上监听");
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        LOG_ERROR("创建套接字失败: " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    // 在 listen 之前收紧权限，其他用户的进程无法连接
+    if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) <
+            0 ||
+        ::chmod(path.c_str(), S_IRUSR | S_IWUSR) < 0 ||
+        ::listen(listen_fd, SOMAXCONN) < 0) {
+        LOG_ERROR("监听 " + path + " 失败: " + std::strerror(errno));
+        ::close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    socket_path = path;
+
+    // 写入在工作线程上发生，发布后立即分发，把变更类型记到每个连接上，
+    // 随各连接的下一个响应发给客户端
+    auto &bus = ChangeBus::get_instance();
+    bus.set_on_pending([&bus] { bus.flush(); });
+    subscription_id = bus.subscribe(ALL_CHANGES, [this](unsigned int changes) {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &conn : connections)
+            conn->changes |= changes;
+    });
+
+    running = true;
+    LOG_INFO("后台服务已在 " + path + " 上监听");
+    return true;
+}
+
+void RpcServer::run() {
+    while (running) {
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (running)
+                LOG_ERROR("接受连接失败: " + std::string(std::strerror(errno)));
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        prune_connections();
+        auto conn = std::make_unique<Connection>();
+        conn->fd = fd;
+        Connection *raw = conn.get();
+        connections.push_back(std::move(conn));
+        raw->thread = std::thread([this, raw] { serve(*raw); });
+    }
+
+    // 先断开所有连接并等待 I/O 线程退出，再停止工作线程
+    std::list<std::unique_ptr<Connection>> closing;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &conn : connections)
+            ::shutdown(conn->fd, SHUT_RDWR);
+        closing.swap(connections);
+    }
+    for (auto &conn : closing) {
+        if (conn->thread.joinable())
+            conn->thread.join();
+        ::close(conn->fd);
+    }
+    executor.shutdown();
+
+    auto &bus = ChangeBus::get_instance();
+    bus.unsubscribe(subscription_id);
+    bus.set_on_pending(nullptr);
+    LOG_INFO("后台服务已停止");
+}
+
+void RpcServer::stop() {
+    // 关闭监听套接字的读端使阻塞中的 accept 返回
+    if (running.exchange(false) && listen_fd >= 0)
+        ::shutdown(listen_fd, SHUT_RDWR);
+}
+
+void RpcServer::prune_connections() {
+    for (auto it = connections.begin(); it != connections.end();) {
+        if ((*it)->done) {
+            (*it)->thread.join();
+            ::close((*it)->fd);
+            it = connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void RpcServer::serve(Connection &conn) {
+    std::string inbox;
+    char chunk[64 * 1024];
+
+    while (true) {
+        ssize_t n = ::recv(conn.fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        inbox.append(chunk, static_cast<size_t>(n));
+
+        // 取出缓冲区中所有完整的请求帧，作为一批执行
+        std::vector<std::string> batch;
+        size_t offset = 0;
+        bool malformed = false;
+        while (inbox.size() - offset >= 4) {
+            uint32_t length = WireReader(std::string_view(inbox).substr(offset))
+                                  .fixed32();
+            if (length < REQUEST_HEADER_SIZE - 4 || length > MAX_FRAME_SIZE) {
+                malformed = true;
+                break;
+            }
+            if (inbox.size() - offset - 4 < length)
+                break;
+            batch.push_back(inbox.substr(offset + 4, length));
+            offset += 4 + length;
+        }
+        if (malformed) {
+            LOG_WARNING("收到非法的请求帧，断开连接");
+            break;
+        }
+        inbox.erase(0, offset);
+        if (batch.empty())
+            continue;
+
+        std::string out = execute(conn, std::move(batch));
+        if (out.empty() || !send_all(conn.fd, out))
+            break;
+    }
+
+    conn.done = true;
+}
+
+std::string RpcServer::execute(Connection &conn,
+                               std::vector<std::string> batch) {
+    // promise 只由任务持有：执行器已停止而丢弃任务时 get 抛出 future_error
+    auto done = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> result = done->get_future();
+
+    executor.submit([this, &conn, done, batch = std::move(batch)] {
+        WireWriter out;
+        for (const auto &frame : batch) {
+            WireReader header(frame);
+            uint32_t id = header.fixed32();
+            auto method = static_cast<Method>(header.fixed16());
+            WireReader request(
+                std::string_view(frame).substr(REQUEST_HEADER_SIZE - 4));
+
+            WireWriter response;
+            Status status;
+            try {
+                status =
+                    service.handle(method, request, response, conn.session);
+            } catch (const WireError &e) {
+                status = Status::BAD_REQUEST;
+                response = WireWriter();
+                response.str(e.what());
+            } catch (const std::exception &e) {
+                LOG_ERROR("远程调用执行失败: " + std::string(e.what()));
+                status = Status::ERROR;
+                response = WireWriter();
+                response.str(e.what());
+            }
+            if (status == Status::UNKNOWN_METHOD)
+                response.str("不支持的方法");
+
+            // 超过单帧上限的响应会被客户端当作协议错误而断开连接，改为返回错误
+            if (response.size() > MAX_FRAME_SIZE - (RESPONSE_HEADER_SIZE - 4)) {
+                LOG_WARNING("远程调用的响应过大（" +
+                            std::to_string(response.size()) +
+                            " 字节），已改为返回错误");
+                status = Status::ERROR;
+                response = WireWriter();
+                response.str("响应超过单帧上限，请缩小请求范围");
+            }
+
+            out.fixed32(static_cast<uint32_t>(RESPONSE_HEADER_SIZE - 4 +
+                                              response.size()));
+            out.fixed32(id);
+            out.u8(static_cast<uint8_t>(status));
+            out.u8(static_cast<uint8_t>(conn.changes.exchange(0)));
+            out.raw(response.data());
+        }
+        done->set_value(out.data());
+    });
+
+    try {
+        return result.get();
+    } catch (const std::future_error &) {
+        return "";
+    }
+}
+
+bool RpcServer::send_all(const int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file      RpcServer.h
+ * @brief     后台守护进程的套接字服务端
+ * @details   监听 Unix 域套接字，每个客户端连接由一个 I/O 线程负责收发；
+ *            连接上一次读到的所有完整请求作为一批交给工作线程池执行，
+ *            执行完后按请求顺序一次写回。工作线程数即数据库会话数上限，
+ *            客户端再多也不会压垮数据库。
+ *
+ *            数据变更通过 ChangeBus 收集，附带在之后发给每个连接的
+ *            响应帧头中，客户端据此刷新对应的数据。
+ */
+
+#pragma once
+#include "Executor.h"
+#include "ShoppingService.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 远程调用服务端
+ *
+ * 用法：start 绑定套接字后调用 run 进入接受循环，
+ * 在其他线程（如信号处理线程）调用 stop 使 run 返回。
+ */
+class RpcServer {
+  private:
+    /**
+     * @brief 一个客户端连接
+     *
+     */
+    struct Connection {
+        int fd = -1;                          ///< 套接字
+        std::thread thread;                   ///< 负责该连接的 I/O 线程
+        std::atomic<unsigned int> changes{0}; ///< 尚未通知该连接的变更类型
+        std::atomic<bool> done{false};        ///< I/O 线程已退出
+        ShoppingService::Session session;     ///< 该连接的登录状态
+    };
+
+    ShoppingService &service;
+    Executor executor;
+
+    std::string socket_path;
+    int listen_fd = -1;
+    std::atomic<bool> running{false};
+
+    std::mutex mtx;
+    std::list<std::unique_ptr<Connection>> connections;
+
+    int subscription_id = 0;
+
+    // 连接 I/O 线程的主循环
+    void serve(Connection &conn);
+
+    // 在工作线程上执行一批请求，返回按顺序拼接好的响应帧
+    std::string execute(Connection &conn, std::vector<std::string> batch);
+
+    // 回收已经断开的连接（调用方持有 mtx）
+    void prune_connections();
+
+    static bool send_all(const int fd, std::string_view data);
+
+  public:
+    /**
+     * @brief 构造服务端
+     *
+     * @param service 请求分发（生命周期需长于服务端）
+     * @param worker_count 工作线程数（即数据库会话数）
+     */
+    RpcServer(ShoppingService &service, const unsigned int worker_count);
+
+    RpcServer(const RpcServer &) = delete;
+    RpcServer &operator=(const RpcServer &) = delete;
+
+    ~RpcServer();
+
+    /**
+     * @brief 绑定并监听套接字，套接字文件只允许本用户访问 (0600)
+     *
+     * 已有服务在同一路径上监听时启动失败；异常退出留下的套接字文件会被删除。
+     *
+     * @param path 套接字路径
+     * @return true 成功
+     * @return false 失败（错误已写入日志）
+     */
+    bool start(const std::string &path);
+
+    /**
+     * @brief 接受连接直到 stop 被调用，返回前关闭所有连接
+     *
+     */
+    void run();
+
+    /**
+     * @brief 请求停止服务（可在任意线程调用）
+     *
+     */
+    void stop();
+};
@@ -0,0 +1,445 @@
+#include "ShoppingClient.h"
+#include "ChangeBus.h"
+#include "Codec.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace Rpc;
+
+namespace {
+
+// 解码函数：按返回类型调用对应的 decode
+template <typename T> T decode_as(WireReader &reader) {
+    T value{};
+    decode(reader, value);
+    return value;
+}
+
+bool ok(WireReader &) { return true; }
+
+} // namespace
+
+bool ShoppingClient::connect(const std::string &path) {
+    disconnect();
+
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("套接字路径过长: " + path);
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 ||
+        ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        LOG_ERROR("无法连接后台服务 " + path + ": " + std::strerror(errno));
+        disconnect();
+        return false;
+    }
+
+    Pending<uint64_t> version(
+        this, send(Method::PING, WireWriter()),
+        [](WireReader &reader) { return reader.varint(); });
+    if (version.get() != PROTOCOL_VERSION) {
+        LOG_ERROR("后台服务的协议版本不一致");
+        disconnect();
+        return false;
+    }
+
+    LOG_INFO("已连接后台服务 " + path);
+    return true;
+}
+
+void ShoppingClient::disconnect() {
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    outbox.clear();
+    inbox.clear();
+    arrived.clear();
+}
+
+uint32_t ShoppingClient::send(const Method method, const WireWriter &payload) {
+    if (fd < 0)
+        return 0;
+
+    uint32_t id = next_id++;
+    if (next_id == 0)
+        next_id = 1;
+
+    WireWriter frame;
+    frame.fixed32(static_cast<uint32_t>(REQUEST_HEADER_SIZE - 4 +
+                                        payload.size()));
+    frame.fixed32(id);
+    frame.fixed16(static_cast<uint16_t>(method));
+    frame.raw(payload.data());
+    outbox += frame.data();
+
+    // 缓冲区过大时先发出去，避免批量请求占用过多内存
+    if (outbox.size() >= 64 * 1024)
+        flush();
+    return id;
+}
+
+void ShoppingClient::flush() {
+    std::string_view data(outbox);
+    while (fd >= 0 && !data.empty()) {
+        ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            LOG_ERROR("发送请求失败: " + std::string(std::strerror(errno)));
+            disconnect();
+            return;
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    outbox.clear();
+}
+
+bool ShoppingClient::receive() {
+    char chunk[64 * 1024];
+    bool got_frame = false;
+
+    while (!got_frame) {
+        if (fd < 0)
+            return false;
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            disconnect();
+            return false;
+        }
+        inbox.append(chunk, static_cast<size_t>(n));
+
+        size_t offset = 0;
+        while (inbox.size() - offset >= 4) {
+            WireReader header(std::string_view(inbox).substr(offset));
+            uint32_t length = header.fixed32();
+            if (length < RESPONSE_HEADER_SIZE - 4 || length > MAX_FRAME_SIZE) {
+                LOG_ERROR("收到非法的响应帧，断开连接");
+                disconnect();
+                return false;
+            }
+            if (inbox.size() - offset - 4 < length)
+                break;
+
+            uint32_t id = header.fixed32();
+            auto status = static_cast<Status>(header.u8());
+            unsigned int changes = header.u8();
+            arrived[id] = {status, inbox.substr(offset + RESPONSE_HEADER_SIZE,
+                                                length + 4 -
+                                                    RESPONSE_HEADER_SIZE)};
+            offset += 4 + length;
+            got_frame = true;
+
+            // 其他客户端（或本次请求）造成的变更，交给本地订阅者刷新
+            if (changes != 0)
+                ChangeBus::get_instance().publish(changes);
+        }
+        inbox.erase(0, offset);
+    }
+    return true;
+}
+
+std::optional<ShoppingClient::Response>
+ShoppingClient::wait(const uint32_t id) {
+    flush();
+    while (true) {
+        auto it = arrived.find(id);
+        if (it != arrived.end()) {
+            Response response = std::move(it->second);
+            arrived.erase(it);
+            return response;
+        }
+        if (!receive())
+            return std::nullopt;
+    }
+}
+
+Pending<bool> ShoppingClient::call(const Method method,
+                                   const WireWriter &payload) {
+    return Pending<bool>(this, send(method, payload), ok);
+}
+
+// --- 用户 ---
+
+Result ShoppingClient::check_login(const std::string &username,
+                                   const std::string &password) {
+    WireWriter payload;
+    payload.str(username);
+    payload.str(password);
+
+    auto user = Pending<std::optional<User>>(
+                    this, send(Method::USER_LOGIN, payload),
+                    [](WireReader &reader) -> std::optional<User> {
+                        if (!reader.boolean())
+                            return std::nullopt;
+                        return decode_as<User>(reader);
+                    })
+                    .get();
+    if (!user)
+        return Result::FAILURE;
+
+    active_user = std::make_shared<User>(*user);
+    return Result::SUCCESS;
+}
+
+void ShoppingClient::logout() {
+    active_user = nullptr;
+    if (is_connected())
+        call(Method::USER_LOGOUT, WireWriter()).get();
+}
+
+Result ShoppingClient::check_register(const std::string &username,
+                                      const std::string &password,
+                                      const std::string &again_password,
+                                      std::string &error_message) {
+    WireWriter payload;
+    payload.str(username);
+    payload.str(password);
+    payload.str(again_password);
+
+    auto reply = Pending<std::pair<Result, std::string>>(
+                     this, send(Method::USER_REGISTER, payload),
+                     [](WireReader &reader) {
+                         Result result = reader.boolean() ? Result::SUCCESS
+                                                          : Result::FAILURE;
+                         return std::make_pair(result, reader.str());
+                     })
+                     .get();
+    error_message = reply.second;
+    return reply.first;
+}
+
+// --- 商品 ---
+
+Pending<ProductSearchPage>
+ShoppingClient::search_product_async(const std::string &query,
+                                     const bool include_deleted,
+                                     const size_t offset, const size_t limit) {
+    WireWriter payload;
+    payload.str(query);
+    payload.boolean(include_deleted);
+    payload.varint(offset);
+    payload.varint(limit);
+
+    // 服务端只返回本页命中的商品，在本地组成一个只含这些商品的目录快照，
+    // 结果的用法与本地搜索相同
+    return Pending<ProductSearchPage>(
+        this, send(Method::PRODUCT_SEARCH, payload),
+        [offset](WireReader &reader) {
+            uint64_t version = reader.varint();
+            size_t total = static_cast<size_t>(reader.varint());
+            size_t size = reader.count();
+            std::vector<Product> products(size);
+            auto match = std::make_shared<ProductSearchMatch>();
+            match->indices.reserve(size);
+            match->positions.reserve(size);
+            for (size_t i = 0; i < size; i++) {
+                decode(reader, products[i]);
+                uint64_t pos = reader.varint();
+                match->indices.push_back(i);
+                match->positions.push_back(pos == 0
+                                               ? std::string::npos
+                                               : static_cast<size_t>(pos - 1));
+            }
+            auto catalog =
+                std::make_shared<const Catalog>(std::move(products), version);
+            return ProductSearchPage{ProductSearchResult(catalog, match), total,
+                                     offset};
+        });
+}
+
+Pending<std::optional<Product>>
+ShoppingClient::get_product_async(const int product_id) {
+    WireWriter payload;
+    payload.svarint(product_id);
+    return Pending<std::optional<Product>>(
+        this, send(Method::PRODUCT_GET, payload),
+        decode_as<std::optional<Product>>);
+}
+
+Pending<ProductPage>
+ShoppingClient::list_products_page_async(const ProductPageQuery &query,
+                                         const ProductPageCursor &after) {
+    WireWriter payload;
+    encode(payload, query);
+    encode(payload, after);
+    return Pending<ProductPage>(this, send(Method::PRODUCT_PAGE, payload),
+                                decode_as<ProductPage>);
+}
+
+Pending<bool> ShoppingClient::update_product_async(
+    const std::string &product_name, const int product_id, const double price,
+    const int stock) {
+    WireWriter payload;
+    payload.str(product_name);
+    payload.svarint(product_id);
+    payload.f64(price);
+    payload.svarint(stock);
+    return call(Method::PRODUCT_UPDATE, payload);
+}
+
+Pending<bool> ShoppingClient::adjust_stock_async(const int product_id,
+                                                 const int delta) {
+    WireWriter payload;
+    payload.svarint(product_id);
+    payload.svarint(delta);
+    return Pending<bool>(this, send(Method::PRODUCT_STOCK, payload),
+                         [](WireReader &reader) { return reader.boolean(); });
+}
+
+// --- 购物车 ---
+
+Pending<std::vector<CartItem>>
+ShoppingClient::fetch_cart_async(const int user_id) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    return Pending<std::vector<CartItem>>(
+        this, send(Method::CART_FETCH, payload),
+        decode_as<std::vector<CartItem>>);
+}
+
+Pending<bool> ShoppingClient::add_item_async(const int user_id,
+                                             const int product_id,
+                                             const int count) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    payload.svarint(product_id);
+    payload.svarint(count);
+    return call(Method::CART_ADD, payload);
+}
+
+Pending<bool> ShoppingClient::update_item_async(const int user_id,
+                                                const int product_id,
+                                                const int count,
+                                                const int delivery_selection) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    payload.svarint(product_id);
+    payload.svarint(count);
+    payload.svarint(delivery_selection);
+    return call(Method::CART_UPDATE, payload);
+}
+
+Pending<bool> ShoppingClient::delete_item_async(const int user_id,
+                                                const int product_id) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    payload.svarint(product_id);
+    return call(Method::CART_DELETE, payload);
+}
+
+Pending<std::vector<CartItem>>
+ShoppingClient::checkout_async(const int user_id) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    return Pending<std::vector<CartItem>>(
+        this, send(Method::CART_CHECKOUT, payload),
+        decode_as<std::vector<CartItem>>);
+}
+
+Pending<std::vector<CartItem>>
+ShoppingClient::purchase_async(const int user_id,
+                               const std::vector<CartItem> &selected,
+                               const std::string &address) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    encode(payload, selected);
+    payload.str(address);
+    return Pending<std::vector<CartItem>>(
+        this, send(Method::CART_PURCHASE, payload),
+        decode_as<std::vector<CartItem>>);
+}
+
+// --- 订单 ---
+
+Pending<std::map<long long, FullOrder>>
+ShoppingClient::fetch_full_orders_async(const int user_id) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    return Pending<std::map<long long, FullOrder>>(
+        this, send(Method::ORDER_FETCH, payload),
+        decode_as<std::map<long long, FullOrder>>);
+}
+
+Pending<bool>
+ShoppingClient::add_order_async(const int user_id,
+                                const std::vector<CartItem> &cart_lists,
+                                const std::string &address) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    encode(payload, cart_lists);
+    payload.str(address);
+    return call(Method::ORDER_ADD, payload);
+}
+
+Pending<bool> ShoppingClient::cancel_order_async(const long long order_id) {
+    WireWriter payload;
+    payload.svarint(order_id);
+    return Pending<bool>(this, send(Method::ORDER_CANCEL, payload),
+                         [](WireReader &reader) { return reader.boolean(); });
+}
+
+Pending<bool>
+ShoppingClient::update_order_info_async(const long long order_id,
+                                        const std::string &new_address,
+                                        const int new_delivery_selection) {
+    WireWriter payload;
+    payload.svarint(order_id);
+    payload.str(new_address);
+    payload.svarint(new_delivery_selection);
+    return call(Method::ORDER_UPDATE_INFO, payload);
+}
+
+// --- 历史订单 ---
+
+Pending<std::map<long long, HistoryFullOrder>>
+ShoppingClient::fetch_history_orders_async(const int user_id) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    return Pending<std::map<long long, HistoryFullOrder>>(
+        this, send(Method::HISTORY_FETCH, payload),
+        decode_as<std::map<long long, HistoryFullOrder>>);
+}
+
+Pending<bool>
+ShoppingClient::add_history_order_async(const int user_id,
+                                        const std::vector<CartItem> &cart_lists,
+                                        const std::string &address) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    encode(payload, cart_lists);
+    payload.str(address);
+    return call(Method::HISTORY_ADD, payload);
+}
+
+Pending<bool>
+ShoppingClient::cancel_history_order_async(const long long order_id) {
+    WireWriter payload;
+    payload.svarint(order_id);
+    return call(Method::HISTORY_CANCEL, payload);
+}
+
+Pending<bool> ShoppingClient::update_history_order_info_async(
+    const long long order_id, const std::string &new_address,
+    const int new_delivery_selection) {
+    WireWriter payload;
+    payload.svarint(order_id);
+    payload.str(new_address);
+    payload.svarint(new_delivery_selection);
+    return call(Method::HISTORY_UPDATE_INFO, payload);
+}
+
+Pending<bool>
+ShoppingClient::delete_all_history_orders_async(const int user_id) {
+    WireWriter payload;
+    payload.svarint(user_id);
+    return call(Method::HISTORY_CLEAR, payload);
+}
@@ -0,0 +1,378 @@
+/**
+ * @file      ShoppingClient.h
+ * @brief     后台守护进程的客户端
+ * @details   接口与各管理类一致，调用转为远程请求发给守护进程。
+ *            每个方法都有 *_async 版本：只把请求放入发送缓冲区并返回
+ *            Pending，多个请求可以一次 flush 发出（批量），
+ *            在 Pending::get 时才等待响应；同步版本即 *_async(...).get()。
+ *
+ *            响应帧携带的数据变更类型会发布到本进程的 ChangeBus，
+ *            界面照常订阅即可感知其他客户端造成的变更。
+ */
+
+#pragma once
+#include "CartManager.h"
+#include "HistoryOrderManager.h"
+#include "Logger.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include "Protocol.h"
+#include "UserManager.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ShoppingClient;
+
+/**
+ * @brief 远程商品搜索的一页结果
+ *
+ */
+struct ProductSearchPage {
+    ProductSearchResult result; ///< 本页命中的商品
+    size_t total = 0;           ///< 命中的商品总数
+    size_t offset = 0;          ///< 本页第一个商品在全部结果中的位置
+};
+
+/**
+ * @brief 尚未返回的远程调用结果
+ *
+ * 调用失败（断线、服务端错误、响应无法解析）时写入日志并返回 T 的默认值，
+ * 与管理类在数据库出错时的行为一致。
+ */
+template <typename T> class Pending {
+  private:
+    ShoppingClient *client = nullptr;
+    uint32_t id = 0; ///< 请求 ID，0 表示请求未能发出
+    std::function<T(Rpc::WireReader &)> decoder;
+
+  public:
+    Pending() = default;
+
+    Pending(ShoppingClient *client, const uint32_t id,
+            std::function<T(Rpc::WireReader &)> decoder)
+        : client(client), id(id), decoder(std::move(decoder)) {}
+
+    /**
+     * @brief 等待并取得结果（每个 Pending 只能调用一次）
+     *
+     * @return T 结果
+     */
+    T get();
+};
+
+/**
+ * @brief 购物服务客户端
+ *
+ * 不是线程安全的：每个线程使用自己的客户端（与数据库会话相同）。
+ */
+class ShoppingClient {
+  public:
+    /**
+     * @brief 收到的响应
+     *
+     */
+    struct Response {
+        Rpc::Status status;  ///< 响应状态
+        std::string payload; ///< 负载
+    };
+
+  private:
+    int fd = -1;
+    uint32_t next_id = 1;
+
+    std::string outbox; ///< 尚未发出的请求帧
+    std::string inbox;  ///< 尚未解析完的响应数据
+
+    // 已收到但还没有被取走的响应：请求 ID -> 响应
+    std::unordered_map<uint32_t, Response> arrived;
+
+    std::shared_ptr<User> active_user;
+
+    // 把请求放入发送缓冲区，返回请求 ID（未连接时返回 0）
+    uint32_t send(const Rpc::Method method, const Rpc::WireWriter &payload);
+
+    // 至少读入一个完整的响应帧，连接断开时返回 false
+    bool receive();
+
+    void disconnect();
+
+    // 不关心返回值的调用：成功即为 true
+    Pending<bool> call(const Rpc::Method method,
+                       const Rpc::WireWriter &payload);
+
+  public:
+    ShoppingClient() = default;
+
+    ShoppingClient(const ShoppingClient &) = delete;
+    ShoppingClient &operator=(const ShoppingClient &) = delete;
+
+    ~ShoppingClient() { disconnect(); }
+
+    /**
+     * @brief 连接守护进程并握手
+     *
+     * @param path 套接字路径
+     * @return true 连接成功且协议版本一致
+     * @return false 失败（错误已写入日志）
+     */
+    bool connect(const std::string &path = Rpc::DEFAULT_SOCKET_PATH);
+
+    bool is_connected() const { return fd >= 0; }
+
+    /**
+     * @brief 发出缓冲区中的所有请求
+     *
+     */
+    void flush();
+
+    /**
+     * @brief 等待指定请求的响应
+     *
+     * @param id 请求 ID
+     * @return std::optional<Response> 连接断开时为空
+     */
+    std::optional<Response> wait(const uint32_t id);
+
+    // --- 用户 ---
+
+    /**
+     * @brief 验证用户登录，成功后记录为当前用户
+     *
+     * 服务端把登录状态绑定到该连接：之后的调用只能访问该用户的数据
+     * （管理员不限），登录失败时连接回到未登录状态。
+     *
+     * @param username 用户名
+     * @param password 密码（明文）
+     * @return Result 成功返回 Result::SUCCESS
+     */
+    Result check_login(const std::string &username,
+                       const std::string &password);
+
+    /**
+     * @brief 验证并注册用户
+     *
+     * @param username 用户名
+     * @param password 密码（明文）
+     * @param again_password 再次输入的密码
+     * @param error_message 失败时的错误信息
+     * @return Result 成功返回 Result::SUCCESS
+     */
+    Result check_register(const std::string &username,
+                          const std::string &password,
+                          const std::string &again_password,
+                          std::string &error_message);
+
+    std::shared_ptr<User> get_current_user() const { return active_user; }
+
+    // 清除当前用户并解除连接上的登录
+    void logout();
+
+    // --- 商品 ---
+
+    // 结果分页返回，每页最多 Rpc::MAX_SEARCH_LIMIT 个商品
+    Pending<ProductSearchPage>
+    search_product_async(const std::string &query,
+                         const bool include_deleted = false,
+                         const size_t offset = 0,
+                         const size_t limit = Rpc::DEFAULT_SEARCH_LIMIT);
+
+    Pending<std::optional<Product>> get_product_async(const int product_id);
+
+    Pending<ProductPage>
+    list_products_page_async(const ProductPageQuery &query,
+                             const ProductPageCursor &after);
+
+    Pending<bool> update_product_async(const std::string &product_name,
+                                       const int product_id,
+                                       const double price, const int stock);
+
+    // 原子调整库存（见 ProductManager::adjust_stock），多个客户端同时修改
+    // 同一商品的库存不会互相覆盖
+    Pending<bool> adjust_stock_async(const int product_id, const int delta);
+
+    // 只返回第一页，更多结果用 search_product_async 指定 offset 获取
+    ProductSearchResult search_product(const std::string &query) {
+        return search_product_async(query).get().result;
+    }
+
+    ProductSearchResult search_all_product(const std::string &query) {
+        return search_product_async(query, true).get().result;
+    }
+
+    std::optional<Product> get_product(const int product_id) {
+        return get_product_async(product_id).get();
+    }
+
+    ProductPage list_products_page(const ProductPageQuery &query,
+                                   const ProductPageCursor &after) {
+        return list_products_page_async(query, after).get();
+    }
+
+    void update_product(const std::string &product_name, const int product_id,
+                        const double price, const int stock) {
+        update_product_async(product_name, product_id, price, stock).get();
+    }
+
+    bool adjust_stock(const int product_id, const int delta) {
+        return adjust_stock_async(product_id, delta).get();
+    }
+
+    // --- 购物车 ---
+
+    Pending<std::vector<CartItem>> fetch_cart_async(const int user_id);
+
+    Pending<bool> add_item_async(const int user_id, const int product_id,
+                                 const int count);
+
+    Pending<bool> update_item_async(const int user_id, const int product_id,
+                                    const int count,
+                                    const int delivery_selection);
+
+    Pending<bool> delete_item_async(const int user_id, const int product_id);
+
+    Pending<std::vector<CartItem>> checkout_async(const int user_id);
+
+    // 结算选中的商品（同 DataStore::checkout）：扣减库存、移出购物车、
+    // 生成订单及历史订单在服务端一次完成，返回实际下单的商品
+    Pending<std::vector<CartItem>>
+    purchase_async(const int user_id, const std::vector<CartItem> &selected,
+                   const std::string &address);
+
+    std::vector<CartItem> fetch_cart(const int user_id) {
+        return fetch_cart_async(user_id).get();
+    }
+
+    void add_item(const int user_id, const int product_id, const int count) {
+        add_item_async(user_id, product_id, count).get();
+    }
+
+    void update_item(const int user_id, const int product_id, const int count,
+                     const int delivery_selection) {
+        update_item_async(user_id, product_id, count, delivery_selection).get();
+    }
+
+    void delete_item(const int user_id, const int product_id) {
+        delete_item_async(user_id, product_id).get();
+    }
+
+    std::vector<CartItem> checkout(const int user_id) {
+        return checkout_async(user_id).get();
+    }
+
+    std::vector<CartItem> purchase(const int user_id,
+                                   const std::vector<CartItem> &selected,
+                                   const std::string &address) {
+        return purchase_async(user_id, selected, address).get();
+    }
+
+    // --- 订单 ---
+
+    Pending<std::map<long long, FullOrder>>
+    fetch_full_orders_async(const int user_id);
+
+    Pending<bool> add_order_async(const int user_id,
+                                  const std::vector<CartItem> &cart_lists,
+                                  const std::string &address);
+
+    // 返回值同 OrderManager::cancel_order：本次调用是否取消了订单
+    Pending<bool> cancel_order_async(const long long order_id);
+
+    Pending<bool> update_order_info_async(const long long order_id,
+                                          const std::string &new_address,
+                                          const int new_delivery_selection);
+
+    std::map<long long, FullOrder> fetch_full_orders(const int user_id) {
+        return fetch_full_orders_async(user_id).get();
+    }
+
+    void add_order(const int user_id, const std::vector<CartItem> &cart_lists,
+                   const std::string &address) {
+        add_order_async(user_id, cart_lists, address).get();
+    }
+
+    bool cancel_order(const long long order_id) {
+        return cancel_order_async(order_id).get();
+    }
+
+    void update_order_info(const long long order_id,
+                           const std::string &new_address,
+                           const int new_delivery_selection) {
+        update_order_info_async(order_id, new_address, new_delivery_selection)
+            .get();
+    }
+
+    // --- 历史订单 ---
+
+    Pending<std::map<long long, HistoryFullOrder>>
+    fetch_history_orders_async(const int user_id);
+
+    Pending<bool> add_history_order_async(
+        const int user_id, const std::vector<CartItem> &cart_lists,
+        const std::string &address);
+
+    Pending<bool> cancel_history_order_async(const long long order_id);
+
+    Pending<bool>
+    update_history_order_info_async(const long long order_id,
+                                    const std::string &new_address,
+                                    const int new_delivery_selection);
+
+    Pending<bool> delete_all_history_orders_async(const int user_id);
+
+    std::map<long long, HistoryFullOrder>
+    fetch_history_orders(const int user_id) {
+        return fetch_history_orders_async(user_id).get();
+    }
+
+    void add_history_order(const int user_id,
+                           const std::vector<CartItem> &cart_lists,
+                           const std::string &address) {
+        add_history_order_async(user_id, cart_lists, address).get();
+    }
+
+    void cancel_history_order(const long long order_id) {
+        cancel_history_order_async(order_id).get();
+    }
+
+    void update_history_order_info(const long long order_id,
+                                   const std::string &new_address,
+                                   const int new_delivery_selection) {
+        update_history_order_info_async(order_id, new_address,
+                                        new_delivery_selection)
+            .get();
+    }
+
+    void delete_all_history_orders(const int user_id) {
+        delete_all_history_orders_async(user_id).get();
+    }
+};
+
+template <typename T> T Pending<T>::get() {
+    if (!client || id == 0) {
+        LOG_ERROR("未连接到后台服务");
+        return T{};
+    }
+
+    auto response = client->wait(id);
+    if (!response) {
+        LOG_ERROR("与后台服务的连接已断开");
+        return T{};
+    }
+
+    try {
+        Rpc::WireReader reader(response->payload);
+        if (response->status != Rpc::Status::OK) {
+            LOG_ERROR("远程调用失败: " + reader.str());
+            return T{};
+        }
+        return decoder(reader);
+    } catch (const Rpc::WireError &e) {
+        LOG_ERROR("无法解析后台服务的响应: " + std::string(e.what()));
+        return T{};
+    }
+}
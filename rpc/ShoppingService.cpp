@@ -0,0 +1,301 @@
+#include "ShoppingService.h"
+#include "Codec.h"
+#include "Logger.h"
+#include <algorithm>
+#include <string>
+
+using namespace Rpc;
+
+namespace {
+
+// 拒绝未登录或越权的调用
+Status unauthorized(WireWriter &response) {
+    response.str("未登录或无权访问");
+    return Status::UNAUTHORIZED;
+}
+
+} // namespace
+
+bool ShoppingService::can_access(const Session &session, const int user_id) {
+    return session.user &&
+           (session.user->id == user_id || session.user->is_admin);
+}
+
+bool ShoppingService::owns_order(const Session &session,
+                                 const long long order_id) {
+    if (!session.user)
+        return false;
+    if (session.user->is_admin)
+        return true;
+    return order_manager.fetch_full_orders(session.user->id, product_manager)
+        .count(order_id);
+}
+
+bool ShoppingService::owns_history_order(const Session &session,
+                                         const long long order_id) {
+    if (!session.user)
+        return false;
+    if (session.user->is_admin)
+        return true;
+    return history_order_manager
+        .fetch_history_orders(session.user->id, product_manager)
+        .count(order_id);
+}
+
+Status ShoppingService::handle(const Method method, WireReader &request,
+                               WireWriter &response, Session &session) {
+    switch (method) {
+    case Method::PING:
+        response.varint(PROTOCOL_VERSION);
+        return Status::OK;
+
+    // --- 用户 ---
+    case Method::USER_LOGIN: {
+        std::string username = request.str();
+        std::string password = request.str();
+
+        // 登录结果（含失败）绑定到该连接
+        session.user = user_manager.authenticate(username, password);
+        response.boolean(session.user.has_value());
+        if (session.user)
+            encode(response, *session.user);
+        return Status::OK;
+    }
+
+    case Method::USER_LOGOUT:
+        session.user.reset();
+        return Status::OK;
+
+    case Method::USER_REGISTER: {
+        std::string username = request.str();
+        std::string password = request.str();
+        std::string again_password = request.str();
+        std::string error_message;
+        Result result = user_manager.check_register(username, password,
+                                                    again_password,
+                                                    error_message);
+        response.boolean(result == Result::SUCCESS);
+        response.str(error_message);
+        return Status::OK;
+    }
+
+    // --- 商品 ---
+    case Method::PRODUCT_SEARCH: {
+        std::string query = request.str();
+        bool include_deleted = request.boolean();
+        uint64_t offset = request.varint();
+        uint64_t limit = std::min<uint64_t>(request.varint(), MAX_SEARCH_LIMIT);
+        if (include_deleted && !is_admin(session))
+            return unauthorized(response);
+        auto result = include_deleted
+                          ? product_manager.search_all_product(query)
+                          : product_manager.search_product(query);
+
+        // 只传输本页命中的商品，关键词位置 +1 编码（0 表示 npos）
+        size_t begin = std::min<uint64_t>(offset, result.size());
+        size_t end = std::min<uint64_t>(begin + limit, result.size());
+        response.varint(result.get_catalog() ? result.get_catalog()->version
+                                              : 0);
+        response.varint(result.size());
+        response.varint(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            encode(response, result[i]);
+            size_t pos = result.match_position(i);
+            response.varint(pos == std::string::npos ? 0 : pos + 1);
+        }
+        return Status::OK;
+    }
+
+    case Method::PRODUCT_GET: {
+        int product_id = static_cast<int>(request.svarint());
+        encode(response, product_manager.get_product(product_id));
+        return Status::OK;
+    }
+
+    case Method::PRODUCT_PAGE: {
+        ProductPageQuery query;
+        ProductPageCursor after;
+        decode(request, query);
+        decode(request, after);
+        encode(response, product_manager.list_products_page(query, after));
+        return Status::OK;
+    }
+
+    case Method::PRODUCT_UPDATE: {
+        std::string name = request.str();
+        int product_id = static_cast<int>(request.svarint());
+        double price = request.f64();
+        int stock = static_cast<int>(request.svarint());
+        if (!is_admin(session))
+            return unauthorized(response);
+        product_manager.update_product(name, product_id, price, stock);
+        return Status::OK;
+    }
+
+    case Method::PRODUCT_STOCK: {
+        int product_id = static_cast<int>(request.svarint());
+        int delta = static_cast<int>(request.svarint());
+        if (!is_admin(session))
+            return unauthorized(response);
+        response.boolean(product_manager.adjust_stock(product_id, delta));
+        return Status::OK;
+    }
+
+    // --- 购物车 ---
+    case Method::CART_FETCH: {
+        int user_id = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        encode(response, cart_manager.fetch_cart(user_id));
+        return Status::OK;
+    }
+
+    case Method::CART_ADD: {
+        int user_id = static_cast<int>(request.svarint());
+        int product_id = static_cast<int>(request.svarint());
+        int count = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        cart_manager.add_item(user_id, product_id, count);
+        return Status::OK;
+    }
+
+    case Method::CART_UPDATE: {
+        int user_id = static_cast<int>(request.svarint());
+        int product_id = static_cast<int>(request.svarint());
+        int count = static_cast<int>(request.svarint());
+        int delivery_selection = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        cart_manager.update_item(user_id, product_id, count,
+                                 delivery_selection);
+        return Status::OK;
+    }
+
+    case Method::CART_DELETE: {
+        int user_id = static_cast<int>(request.svarint());
+        int product_id = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        cart_manager.delete_item(user_id, product_id);
+        return Status::OK;
+    }
+
+    case Method::CART_CHECKOUT: {
+        int user_id = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        encode(response, cart_manager.checkout(user_id));
+        return Status::OK;
+    }
+
+    case Method::CART_PURCHASE: {
+        int user_id = static_cast<int>(request.svarint());
+        std::vector<CartItem> selected;
+        decode(request, selected);
+        std::string address = request.str();
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        encode(response,
+               order_manager
+                   .purchase(user_id, selected, address, cart_manager,
+                             product_manager, history_order_manager, "rpc")
+                   .ordered);
+        return Status::OK;
+    }
+
+    // --- 订单 ---
+    case Method::ORDER_FETCH: {
+        int user_id = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        encode(response,
+               order_manager.fetch_full_orders(user_id, product_manager));
+        return Status::OK;
+    }
+
+    case Method::ORDER_ADD: {
+        int user_id = static_cast<int>(request.svarint());
+        std::vector<CartItem> items;
+        decode(request, items);
+        std::string address = request.str();
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        order_manager.add_order(user_id, items, address);
+        return Status::OK;
+    }
+
+    case Method::ORDER_CANCEL: {
+        long long order_id = request.svarint();
+        if (!owns_order(session, order_id))
+            return unauthorized(response);
+        response.boolean(order_manager.cancel_order(order_id, product_manager));
+        return Status::OK;
+    }
+
+    case Method::ORDER_UPDATE_INFO: {
+        long long order_id = request.svarint();
+        std::string address = request.str();
+        int delivery_selection = static_cast<int>(request.svarint());
+        if (!owns_order(session, order_id))
+            return unauthorized(response);
+        order_manager.update_order_info(order_id, address,
+                                        delivery_selection);
+        return Status::OK;
+    }
+
+    // --- 历史订单 ---
+    case Method::HISTORY_FETCH: {
+        int user_id = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        encode(response, history_order_manager.fetch_history_orders(
+                             user_id, product_manager));
+        return Status::OK;
+    }
+
+    case Method::HISTORY_ADD: {
+        int user_id = static_cast<int>(request.svarint());
+        std::vector<CartItem> items;
+        decode(request, items);
+        std::string address = request.str();
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        history_order_manager.add_history_order(user_id, product_manager,
+                                                items, address);
+        return Status::OK;
+    }
+
+    case Method::HISTORY_CANCEL: {
+        long long order_id = request.svarint();
+        if (!owns_history_order(session, order_id))
+            return unauthorized(response);
+        history_order_manager.cancel_history_order(order_id,
+                                                   product_manager);
+        return Status::OK;
+    }
+
+    case Method::HISTORY_UPDATE_INFO: {
+        long long order_id = request.svarint();
+        std::string address = request.str();
+        int delivery_selection = static_cast<int>(request.svarint());
+        if (!owns_history_order(session, order_id))
+            return unauthorized(response);
+        history_order_manager.update_history_order_info(order_id, address,
+                                                        delivery_selection);
+        return Status::OK;
+    }
+
+    case Method::HISTORY_CLEAR: {
+        int user_id = static_cast<int>(request.svarint());
+        if (!can_access(session, user_id))
+            return unauthorized(response);
+        history_order_manager.delete_all_history_orders(user_id);
+        return Status::OK;
+    }
+    }
+
+    LOG_WARNING("未知的远程调用方法: " +
+                std::to_string(static_cast<int>(method)));
+    return Status::UNKNOWN_METHOD;
+}
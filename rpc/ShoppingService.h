@@ -0,0 +1,81 @@
+/**
+ * @file      ShoppingService.h
+ * @brief     后台服务的请求分发
+ * @details   持有唯一一份管理类（及其商品目录与缓存），
+ *            把解码后的远程调用转发给对应的管理类并编码返回值。
+ */
+
+#pragma once
+#include "CartManager.h"
+#include "HistoryOrderManager.h"
+#include "OrderManager.h"
+#include "ProductManager.h"
+#include "Protocol.h"
+#include "UserManager.h"
+#include <optional>
+
+/**
+ * @brief 购物服务：远程调用到管理类的分发
+ *
+ * handle 可在多个工作线程上并发调用，管理类本身可跨线程使用，
+ * 数据库访问使用各工作线程自己的会话。
+ *
+ * 请求中的 user_id 不可信：除握手、登录、注册与商品查询外，调用都要求
+ * 连接已登录，且只能访问自己的数据；修改商品与库存需要管理员权限。
+ */
+class ShoppingService {
+  public:
+    /**
+     * @brief 一个连接的登录状态（由服务端按连接保存，同一连接的请求串行执行）
+     *
+     */
+    struct Session {
+        std::optional<User> user; ///< 已登录的用户，未登录为空
+    };
+
+  private:
+    UserManager user_manager;
+    ProductManager product_manager;
+    CartManager cart_manager;
+    OrderManager order_manager;
+    HistoryOrderManager history_order_manager;
+
+    // 辅助函数：连接可以访问 user_id 的数据（本人或管理员）
+    static bool can_access(const Session &session, const int user_id);
+
+    static bool is_admin(const Session &session) {
+        return session.user && session.user->is_admin;
+    }
+
+    // 辅助函数：订单 / 历史订单属于已登录的用户（管理员不限）
+    bool owns_order(const Session &session, const long long order_id);
+
+    bool owns_history_order(const Session &session, const long long order_id);
+
+  public:
+    ShoppingService() = default;
+
+    ShoppingService(const ShoppingService &) = delete;
+    ShoppingService &operator=(const ShoppingService &) = delete;
+
+    /**
+     * @brief 执行一次远程调用
+     *
+     * @param method 方法
+     * @param request 请求负载
+     * @param response 写入返回值（失败时写入错误信息）
+     * @param session 发起请求的连接的登录状态（登录、登出时更新）
+     * @return Rpc::Status 响应状态
+     */
+    Rpc::Status handle(const Rpc::Method method, Rpc::WireReader &request,
+                       Rpc::WireWriter &response, Session &session);
+
+    /**
+     * @brief 获取商品搜索缓存的命中统计
+     *
+     * @return CacheStats 统计信息
+     */
+    CacheStats get_search_cache_stats() const {
+        return product_manager.get_search_cache_stats();
+    }
+};
@@ -0,0 +1,94 @@
+#include "HttpService.h"
+#include "Logger.h"
+#include "Startup.h"
+#include <csignal>
+#include <cstdlib>
+#include <httplib.h>
+#include <iostream>
+#include <pthread.h>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using std::string;
+using std::string_view;
+
+// 用法: shopping_server [--host <地址>] [--port <端口>] [--threads <线程数>]
+int main(int argc, char *argv[]) {
+    string host = "127.0.0.1";
+    int port = 8080;
+    unsigned int threads = 8;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (string_view(argv[i]) == "--host") {
+            host = argv[i + 1];
+        } else if (string_view(argv[i]) == "--port") {
+            port = std::atoi(argv[i + 1]);
+        } else if (string_view(argv[i]) == "--threads") {
+            threads = static_cast<unsigned int>(std::atoi(argv[i + 1]));
+        } else {
+            std::cerr << "用法: " << argv[0]
+                      << " [--host <地址>] [--port <端口>] [--threads <线程数>]"
+                      << std::endl;
+            return -1;
+        }
+    }
+    if (threads == 0)
+        threads = 1;
+
+    // 配置日志系统
+    auto &logger = Logger::get_instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_log_file(string(DATA_PATH) + "/shopping_server.log");
+    logger.set_console_output(true);
+    logger.set_file_output(true);
+
+    LOG_INFO("Shopping HTTP 服务启动中...");
+
+    // 与 shopping_app 相同的密码哈希成本与数据库配置
+    Startup::configure_kdf_from_env();
+    if (!Startup::connect_database_from_env())
+        return -1;
+
+    // 在创建任何线程之前屏蔽退出信号，由专门的线程同步等待
+    sigset_t signals = Startup::block_exit_signals();
+
+    // 设置 TRACE_FILE 时记录调用追踪，退出时以 Chrome 追踪事件格式写入该文件
+    auto trace_file = Startup::enable_trace_from_env();
+
+    HttpService service;
+    httplib::Server server;
+
+    // 固定大小的线程池：每个线程持有自己的数据库会话
+    server.new_task_queue = [threads] {
+        return new httplib::ThreadPool(threads);
+    };
+    // 保持连接：同一客户端的连续请求复用一个 TCP 连接
+    server.set_keep_alive_max_count(1000);
+    server.set_keep_alive_timeout(5);
+    server.set_read_timeout(5);
+
+    service.register_routes(server);
+
+    std::thread signal_thread([&] {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        LOG_INFO("收到信号 " + std::to_string(signal) + "，正在停止 HTTP 服务");
+        server.stop();
+    });
+
+    LOG_INFO("HTTP 服务监听 " + host + ":" + std::to_string(port) + "，" +
+             std::to_string(threads) + " 个工作线程");
+    bool ok = server.listen(host, port);
+    if (!ok)
+        LOG_ERROR("无法监听 " + host + ":" + std::to_string(port));
+
+    // listen 也可能因绑定失败而返回，此时给信号线程发一个信号让它退出
+    pthread_kill(signal_thread.native_handle(), SIGTERM);
+    signal_thread.join();
+
+    if (trace_file)
+        Startup::write_trace(*trace_file);
+
+    Startup::log_cache_stats("商品搜索", service.get_search_cache_stats());
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,81 @@
+#include "Startup.h"
+#include "Logger.h"
+#include "SecurityUtils.h"
+#include "Trace.h"
+#include <chrono>
+#include <cstdlib>
+#include <pthread.h>
+
+namespace Startup {
+
+void configure_kdf_from_env() {
+    if (const char *kdf_iterations = std::getenv("KDF_ITERATIONS")) {
+        SecurityUtils::set_iterations(std::atoi(kdf_iterations));
+    } else {
+        const char *kdf_target_ms = std::getenv("KDF_TARGET_MS");
+        int target_ms = kdf_target_ms ? std::atoi(kdf_target_ms)
+                                      : SecurityUtils::DEFAULT_TARGET_MS;
+        SecurityUtils::calibrate_iterations(
+            std::chrono::milliseconds(target_ms));
+    }
+    LOG_INFO("密码哈希迭代次数: " +
+             std::to_string(SecurityUtils::get_iterations()));
+}
+
+std::optional<DbConfig> db_config_from_env() {
+    const char *db_pass = std::getenv("DB_PASSWORD");
+    if (!db_pass) {
+        LOG_ERROR("未找到环境变量 DB_PASSWORD");
+        return std::nullopt;
+    }
+
+    DbConfig config;
+    config.password = db_pass;
+    config.database = "ShoppingApp";
+    return config;
+}
+
+bool connect_database_from_env() {
+    auto config = db_config_from_env();
+    if (!config)
+        return false;
+    if (!Database::connect(*config)) {
+        LOG_ERROR("无法连接到数据库，程序终止。");
+        return false;
+    }
+    return true;
+}
+
+sigset_t block_exit_signals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    return signals;
+}
+
+std::optional<std::string> enable_trace_from_env() {
+    const char *trace_file = std::getenv("TRACE_FILE");
+    if (!trace_file)
+        return std::nullopt;
+    Trace::Recorder::get_instance().enable();
+    return std::string(trace_file);
+}
+
+void write_trace(const std::string &path) {
+    if (Trace::Recorder::get_instance().dump(path))
+        LOG_INFO("追踪记录已写入 " + path);
+    else
+        LOG_ERROR("无法写入追踪记录 " + path);
+}
+
+void log_cache_stats(const std::string &name, const CacheStats &stats) {
+    LOG_INFO(name + "缓存: 命中 " + std::to_string(stats.hits) +
+             " 次，未命中 " + std::to_string(stats.misses) + " 次，命中率 " +
+             std::to_string(stats.hit_ratio() * 100) + "%，条目 " +
+             std::to_string(stats.size) + "/" + std::to_string(stats.capacity) +
+             "，约 " + std::to_string(stats.bytes) + " 字节");
+}
+
+} // namespace Startup
@@ -0,0 +1,73 @@
+/**
+ * @file      Startup.h
+ * @brief     各可执行程序共用的启动与退出步骤
+ * @details   shopping_app、shopping_server 与 shopping_daemon 都从环境变量
+ *            读取密码哈希成本、数据库密码与追踪文件，退出时报告缓存效果；
+ *            两个服务进程还需要在创建线程之前屏蔽退出信号。
+ */
+
+#pragma once
+#include "Database.h"
+#include "LruCache.h"
+#include <csignal>
+#include <optional>
+#include <string>
+
+namespace Startup {
+
+/**
+ * @brief 配置密码哈希成本
+ *
+ * KDF_ITERATIONS 指定固定迭代次数，否则按 KDF_TARGET_MS（默认 100 毫秒）
+ * 在本机校准；结果写入日志。
+ */
+void configure_kdf_from_env();
+
+/**
+ * @brief 从环境变量 DB_PASSWORD 生成数据库连接配置
+ *
+ * @return std::optional<DbConfig> 未设置 DB_PASSWORD 时为空（已写入日志）
+ */
+std::optional<DbConfig> db_config_from_env();
+
+/**
+ * @brief 按 db_config_from_env 的配置连接数据库
+ *
+ * @return true 连接成功
+ * @return false 失败（错误已写入日志）
+ */
+bool connect_database_from_env();
+
+/**
+ * @brief 在当前线程屏蔽 SIGINT / SIGTERM
+ *
+ * 须在创建任何线程之前调用，之后创建的线程继承该屏蔽字，
+ * 由专门的线程用 sigwait 同步等待返回的信号集。
+ *
+ * @return sigset_t 被屏蔽的信号集
+ */
+sigset_t block_exit_signals();
+
+/**
+ * @brief 设置 TRACE_FILE 时开始记录调用追踪
+ *
+ * @return std::optional<std::string> 追踪文件路径，未设置时为空
+ */
+std::optional<std::string> enable_trace_from_env();
+
+/**
+ * @brief 以 Chrome 追踪事件格式写出追踪记录（结果写入日志）
+ *
+ * @param path 追踪文件路径
+ */
+void write_trace(const std::string &path);
+
+/**
+ * @brief 把一个缓存的命中统计写入日志
+ *
+ * @param name 缓存名称，如 "商品搜索"
+ * @param stats 统计信息
+ */
+void log_cache_stats(const std::string &name, const CacheStats &stats);
+
+} // namespace Startup
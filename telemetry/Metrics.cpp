@@ -0,0 +1,266 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace Metrics {
+
+namespace {
+
+// 在浮点原子量上做加法（std::atomic<double> 在 C++17 中没有 fetch_add）
+void atomic_add(std::atomic<double> &target, const double delta) {
+    double expected = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(expected, expected + delta,
+                                         std::memory_order_relaxed))
+        ;
+}
+
+// 标签值中的反斜杠、双引号与换行需要转义
+std::string escape_label(const std::string &value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string format_labels(const Labels &labels) {
+    if (labels.empty())
+        return "";
+    std::string text = "{";
+    for (size_t i = 0; i < labels.size(); i++) {
+        if (i > 0)
+            text += ',';
+        text += labels[i].first + "=\"" + escape_label(labels[i].second) + "\"";
+    }
+    return text + "}";
+}
+
+// 在已有标签后追加一个标签（直方图的 le）
+std::string with_label(const std::string &labels, const std::string &extra) {
+    if (labels.empty())
+        return "{" + extra + "}";
+    return labels.substr(0, labels.size() - 1) + "," + extra + "}";
+}
+
+std::string format_number(const double value) {
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+    if (std::isnan(value))
+        return "NaN";
+    // 优先用 15 位有效数字（0.005 而不是 0.0050000000000000001），
+    // 不能精确还原时再用 17 位
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    if (std::strtod(buffer, nullptr) != value)
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+} // namespace
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto &stripe : stripes)
+        total += stripe.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Gauge::add(const double delta) { atomic_add(current, delta); }
+
+Histogram::Histogram(std::vector<double> bounds) : bounds(std::move(bounds)) {
+    for (auto &stripe : stripes)
+        stripe.buckets =
+            std::vector<std::atomic<uint64_t>>(this->bounds.size() + 1);
+}
+
+void Histogram::observe(const double value) {
+    // 桶数很少（十几个），顺序查找比二分更快
+    size_t bucket = 0;
+    while (bucket < bounds.size() && value > bounds[bucket])
+        bucket++;
+
+    Stripe &stripe = stripes[stripe_index()];
+    stripe.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    stripe.count.fetch_add(1, std::memory_order_relaxed);
+    atomic_add(stripe.sum, value);
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot result;
+    result.buckets.assign(bounds.size() + 1, 0);
+    for (const auto &stripe : stripes) {
+        for (size_t i = 0; i < stripe.buckets.size(); i++)
+            result.buckets[i] +=
+                stripe.buckets[i].load(std::memory_order_relaxed);
+        result.count += stripe.count.load(std::memory_order_relaxed);
+        result.sum += stripe.sum.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot &other) {
+    if (buckets.size() < other.buckets.size())
+        buckets.resize(other.buckets.size(), 0);
+    for (size_t i = 0; i < other.buckets.size(); i++)
+        buckets[i] += other.buckets[i];
+    count += other.count;
+    sum += other.sum;
+}
+
+HistogramSnapshot
+HistogramSnapshot::since(const HistogramSnapshot &earlier) const {
+    HistogramSnapshot delta = *this;
+    for (size_t i = 0; i < earlier.buckets.size() && i < buckets.size(); i++)
+        delta.buckets[i] -= std::min(earlier.buckets[i], buckets[i]);
+    delta.count -= std::min(earlier.count, count);
+    delta.sum = std::max(0.0, sum - earlier.sum);
+    return delta;
+}
+
+double HistogramSnapshot::quantile(const std::vector<double> &bounds,
+                                   const double q) const {
+    uint64_t total = 0;
+    for (uint64_t n : buckets)
+        total += n;
+    if (total == 0 || bounds.empty())
+        return 0;
+
+    double rank = q * static_cast<double>(total);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        if (buckets[i] == 0 ||
+            static_cast<double>(cumulative + buckets[i]) < rank) {
+            cumulative += buckets[i];
+            continue;
+        }
+        if (i >= bounds.size())
+            return bounds.back();
+        double lower = i == 0 ? 0 : bounds[i - 1];
+        double fraction =
+            (rank - static_cast<double>(cumulative)) / buckets[i];
+        return lower + (bounds[i] - lower) * std::max(0.0, fraction);
+    }
+    return bounds.back();
+}
+
+const std::vector<double> &latency_buckets() {
+    static const std::vector<double> bounds = {
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+        0.025,  0.05,    0.1,    0.25,  0.5,    1,     2.5, 5};
+    return bounds;
+}
+
+Registry &Registry::get_instance() {
+    static Registry instance;
+    return instance;
+}
+
+Registry::Series &Registry::find_or_add(const std::string &name,
+                                        const std::string &help,
+                                        const Type type, const Labels &labels) {
+    auto [it, inserted] = families.try_emplace(name);
+    Family &family = it->second;
+    if (inserted) {
+        family.help = help;
+        family.type = type;
+    } else if (family.type != type) {
+        throw std::logic_error("指标 " + name + " 已以其他类型注册");
+    }
+
+    std::string formatted = format_labels(labels);
+    for (auto &series : family.series) {
+        if (series->labels == formatted)
+            return *series;
+    }
+    family.series.push_back(std::make_unique<Series>());
+    family.series.back()->labels = std::move(formatted);
+    return *family.series.back();
+}
+
+Counter &Registry::counter(const std::string &name, const std::string &help,
+                           const Labels &labels) {
+    std::lock_guard<std::mutex> lock(mtx);
+    Series &series = find_or_add(name, help, Type::COUNTER, labels);
+    if (!series.counter)
+        series.counter = std::make_unique<Counter>();
+    return *series.counter;
+}
+
+Gauge &Registry::gauge(const std::string &name, const std::string &help,
+                       const Labels &labels) {
+    std::lock_guard<std::mutex> lock(mtx);
+    Series &series = find_or_add(name, help, Type::GAUGE, labels);
+    if (!series.gauge)
+        series.gauge = std::make_unique<Gauge>();
+    return *series.gauge;
+}
+
+Histogram &Registry::histogram(const std::string &name,
+                               const std::string &help, const Labels &labels,
+                               const std::vector<double> &bounds) {
+    std::lock_guard<std::mutex> lock(mtx);
+    Series &series = find_or_add(name, help, Type::HISTOGRAM, labels);
+    if (!series.histogram)
+        series.histogram = std::make_unique<Histogram>(bounds);
+    return *series.histogram;
+}
+
+std::string Registry::render() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string out;
+
+    for (const auto &[name, family] : families) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        switch (family.type) {
+        case Type::COUNTER:
+            out += "# TYPE " + name + " counter\n";
+            for (const auto &series : family.series)
+                out += name + series->labels + " " +
+                       std::to_string(series->counter->value()) + "\n";
+            break;
+        case Type::GAUGE:
+            out += "# TYPE " + name + " gauge\n";
+            for (const auto &series : family.series)
+                out += name + series->labels + " " +
+                       format_number(series->gauge->value()) + "\n";
+            break;
+        case Type::HISTOGRAM:
+            out += "# TYPE " + name + " histogram\n";
+            for (const auto &series : family.series) {
+                const Histogram &histogram = *series->histogram;
+                HistogramSnapshot snap = histogram.snapshot();
+                const auto &bounds = histogram.get_bounds();
+
+                // Prometheus 的桶是累计计数，末尾的 +Inf 桶等于总数
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < snap.buckets.size(); i++) {
+                    cumulative += snap.buckets[i];
+                    std::string le =
+                        i < bounds.size() ? format_number(bounds[i]) : "+Inf";
+                    out += name + "_bucket" +
+                           with_label(series->labels, "le=\"" + le + "\"") +
+                           " " + std::to_string(cumulative) + "\n";
+                }
+                out += name + "_sum" + series->labels + " " +
+                       format_number(snap.sum) + "\n";
+                out += name + "_count" + series->labels + " " +
+                       std::to_string(cumulative) + "\n";
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+} // namespace Metrics
@@ -0,0 +1,266 @@
+/**
+ * @file      Metrics.h
+ * @brief     进程内指标注册表
+ * @details   提供计数器、仪表与直方图三类指标，按名称与标签注册到全局
+ *            注册表，由 MetricsServer 以 Prometheus 文本格式导出。
+ *            计数器与直方图按线程分条累加：每个线程固定写入其中一条，
+ *            各条独占缓存行，记录时只做一次无锁的原子加法，导出时再汇总。
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Metrics {
+
+// 累加分条数；线程数超过时多个线程共用一条，仍然无锁
+constexpr size_t STRIPES = 16;
+
+// 标签，如 {{"cache", "user"}, {"result", "hit"}}
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief 当前线程使用的分条下标（线程首次调用时轮流分配）
+ *
+ * @return size_t 下标，小于 STRIPES
+ */
+inline size_t stripe_index() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index =
+        next.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+    return index;
+}
+
+/**
+ * @brief 单调递增的计数器
+ *
+ */
+class Counter {
+  private:
+    struct alignas(64) Stripe {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Stripe, STRIPES> stripes;
+
+  public:
+    void inc(const uint64_t n = 1) {
+        stripes[stripe_index()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+};
+
+/**
+ * @brief 可增可减的仪表（如当前会话数）
+ *
+ * 仪表的值可以被直接设置，不分条。
+ */
+class Gauge {
+  private:
+    std::atomic<double> current{0};
+
+  public:
+    void set(const double value) {
+        current.store(value, std::memory_order_relaxed);
+    }
+
+    void add(const double delta);
+
+    double value() const { return current.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief 直方图的汇总结果
+ *
+ */
+struct HistogramSnapshot {
+    std::vector<uint64_t> buckets; ///< 各桶计数（不累计），末尾为溢出桶
+    uint64_t count = 0;            ///< 观测次数
+    double sum = 0;                ///< 观测值之和
+
+    /**
+     * @brief 合并另一个快照（桶上界须相同）
+     *
+     * @param other 快照
+     */
+    void merge(const HistogramSnapshot &other);
+
+    /**
+     * @brief 计算自较早的快照以来新增的观测，用于统计一段时间窗口
+     *
+     * @param earlier 同一直方图较早的快照（可以为空快照）
+     * @return HistogramSnapshot 窗口内的观测
+     */
+    HistogramSnapshot since(const HistogramSnapshot &earlier) const;
+
+    /**
+     * @brief 估算分位数（在所在的桶内线性插值，与 Prometheus 的
+     *        histogram_quantile 一致）
+     *
+     * @param bounds 桶上界
+     * @param q 分位，如 0.99
+     * @return double 估算值；没有观测时为 0，落在溢出桶时为最大的上界
+     */
+    double quantile(const std::vector<double> &bounds, const double q) const;
+};
+
+/**
+ * @brief 按固定桶上界统计分布的直方图
+ *
+ */
+class Histogram {
+  private:
+    struct alignas(64) Stripe {
+        std::vector<std::atomic<uint64_t>> buckets;
+        std::atomic<uint64_t> count{0};
+        std::atomic<double> sum{0};
+    };
+
+    std::vector<double> bounds; ///< 各桶上界（升序）
+    std::array<Stripe, STRIPES> stripes;
+
+  public:
+    /**
+     * @brief 构造直方图
+     *
+     * @param bounds 各桶上界（升序），超过最后一个上界的计入溢出桶
+     */
+    explicit Histogram(std::vector<double> bounds);
+
+    /**
+     * @brief 记录一次观测值
+     *
+     * @param value 观测值（耗时类指标以秒为单位）
+     */
+    void observe(const double value);
+
+    /**
+     * @brief 记录一次耗时（换算为秒）
+     *
+     * @param elapsed 耗时
+     */
+    void observe(const std::chrono::nanoseconds elapsed) {
+        observe(std::chrono::duration<double>(elapsed).count());
+    }
+
+    const std::vector<double> &get_bounds() const { return bounds; }
+
+    HistogramSnapshot snapshot() const;
+};
+
+// 耗时类直方图的默认桶上界（秒）：0.1 毫秒到 5 秒
+const std::vector<double> &latency_buckets();
+
+/**
+ * @brief 作用域计时：析构时把经过的时间记入直方图
+ *
+ */
+class ScopedTimer {
+  private:
+    Histogram &histogram;
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+  public:
+    explicit ScopedTimer(Histogram &histogram) : histogram(histogram) {}
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    ~ScopedTimer() {
+        histogram.observe(std::chrono::steady_clock::now() - start);
+    }
+};
+
+/**
+ * @brief 全局指标注册表（单例）
+ *
+ * 注册时加锁，返回的引用在进程生命周期内有效；调用方应保存引用
+ * （如函数内的 static 变量），在热路径上只做记录。
+ * 同名同标签重复注册时返回同一个指标。
+ */
+class Registry {
+  private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Series {
+        std::string labels; ///< 已格式化的标签，如 {cache="user"}
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        std::string help;
+        Type type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    mutable std::mutex mtx;
+    std::map<std::string, Family> families; ///< 按名称排序，导出顺序稳定
+
+    Registry() = default;
+
+    // 查找或创建序列；类型与已注册的不一致时抛出 std::logic_error
+    Series &find_or_add(const std::string &name, const std::string &help,
+                        const Type type, const Labels &labels);
+
+  public:
+    Registry(const Registry &) = delete;
+    Registry &operator=(const Registry &) = delete;
+
+    static Registry &get_instance();
+
+    /**
+     * @brief 注册计数器
+     *
+     * @param name 指标名，如 "shopping_cache_requests_total"
+     * @param help 说明
+     * @param labels 标签
+     * @return Counter& 计数器
+     */
+    Counter &counter(const std::string &name, const std::string &help,
+                     const Labels &labels = {});
+
+    /**
+     * @brief 注册仪表
+     *
+     * @param name 指标名
+     * @param help 说明
+     * @param labels 标签
+     * @return Gauge& 仪表
+     */
+    Gauge &gauge(const std::string &name, const std::string &help,
+                 const Labels &labels = {});
+
+    /**
+     * @brief 注册直方图
+     *
+     * @param name 指标名，耗时类以 _seconds 结尾
+     * @param help 说明
+     * @param labels 标签
+     * @param bounds 桶上界，默认为 latency_buckets()
+     * @return Histogram& 直方图
+     */
+    Histogram &histogram(const std::string &name, const std::string &help,
+                         const Labels &labels = {},
+                         const std::vector<double> &bounds = latency_buckets());
+
+    /**
+     * @brief 以 Prometheus 文本格式（0.0.4）导出所有指标
+     *
+     * @return std::string 文本
+     */
+    std::string render() const;
+};
+
+} // namespace Metrics
@@ -0,0 +1,31 @@
+#include "MetricsServer.h"
+#include "Metrics.h"
+
+bool MetricsServer::start(const int port, const std::string &host) {
+    stop();
+
+    server = std::make_unique<httplib::Server>();
+    // httplib 默认按硬件线程数建线程池；抓取频率很低，一个工作线程足够
+    server->new_task_queue = [] { return new httplib::ThreadPool(1); };
+    server->Get("/metrics", [](const httplib::Request &,
+                               httplib::Response &res) {
+        res.set_content(Metrics::Registry::get_instance().render(),
+                        "text/plain; version=0.0.4; charset=utf-8");
+    });
+
+    // 先在当前线程绑定，端口被占用时立即返回失败
+    if (!server->bind_to_port(host, port)) {
+        server.reset();
+        return false;
+    }
+    thread = std::thread([this] { server->listen_after_bind(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (server)
+        server->stop();
+    if (thread.joinable())
+        thread.join();
+    server.reset();
+}
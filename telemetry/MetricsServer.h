@@ -0,0 +1,48 @@
+/**
+ * @file      MetricsServer.h
+ * @brief     指标导出服务
+ * @details   在回环地址上启动一个单线程的小型 HTTP 服务，
+ *            GET /metrics 以 Prometheus 文本格式返回全局注册表中的指标，
+ *            供本机的采集程序定期抓取。
+ */
+
+#pragma once
+#include <httplib.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * @brief 指标导出服务
+ *
+ * start 成功后在后台线程上处理请求，stop 或析构时停止。
+ */
+class MetricsServer {
+  private:
+    std::unique_ptr<httplib::Server> server;
+    std::thread thread;
+
+  public:
+    MetricsServer() = default;
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    ~MetricsServer() { stop(); }
+
+    /**
+     * @brief 绑定端口并在后台线程上开始服务
+     *
+     * @param port 端口
+     * @param host 监听地址，默认只监听回环地址
+     * @return true 绑定成功
+     * @return false 绑定失败（如端口被占用）
+     */
+    bool start(const int port, const std::string &host = "127.0.0.1");
+
+    /**
+     * @brief 停止服务并等待后台线程退出
+     *
+     */
+    void stop();
+};
@@ -0,0 +1,169 @@
+#include "Trace.h"
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace Trace {
+
+namespace {
+
+// 当前线程最内层的 span
+thread_local Span *current_span = nullptr;
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+uint32_t thread_index() {
+    static std::atomic<uint32_t> next{0};
+    thread_local uint32_t index = next.fetch_add(1) + 1;
+    return index;
+}
+
+Recorder &Recorder::get_instance() {
+    static Recorder instance;
+    return instance;
+}
+
+void Recorder::enable(const size_t capacity) {
+    std::lock_guard<std::mutex> lock(mtx);
+    this->capacity = capacity == 0 ? 1 : capacity;
+    ring.clear();
+    ring.reserve(this->capacity);
+    next = 0;
+    recorded = 0;
+    origin_ns.store(steady_now_ns(), std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+uint64_t Recorder::now_us() const {
+    int64_t elapsed =
+        steady_now_ns() - origin_ns.load(std::memory_order_relaxed);
+    return elapsed > 0 ? static_cast<uint64_t>(elapsed / 1000) : 0;
+}
+
+void Recorder::record(Event event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (ring.size() < capacity) {
+        ring.push_back(std::move(event));
+    } else {
+        ring[next] = std::move(event);
+    }
+    next = (next + 1) % capacity;
+    recorded++;
+}
+
+void Recorder::set_thread_name(const std::string &name) {
+    uint32_t thread = thread_index();
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto &entry : thread_names) {
+        if (entry.first == thread) {
+            entry.second = name;
+            return;
+        }
+    }
+    thread_names.emplace_back(thread, name);
+}
+
+std::vector<Event> Recorder::snapshot() const {
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        events = ring;
+    }
+    // 外层 span 晚于内层结束、晚于内层写入，按开始时间重新排序；
+    // 开始时间相同时外层（耗时更长）在前
+    std::sort(events.begin(), events.end(),
+              [](const Event &a, const Event &b) {
+                  if (a.start_us != b.start_us)
+                      return a.start_us < b.start_us;
+                  return a.duration_us > b.duration_us;
+              });
+    return events;
+}
+
+std::string Recorder::to_chrome_json() const {
+    json events = json::array();
+
+    uint64_t total = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        total = recorded;
+        for (const auto &[thread, name] : thread_names)
+            events.push_back({{"name", "thread_name"},
+                              {"ph", "M"},
+                              {"pid", 1},
+                              {"tid", thread},
+                              {"args", {{"name", name}}}});
+    }
+
+    std::vector<Event> spans = snapshot();
+    for (const auto &span : spans) {
+        json args = {{"id", span.id}, {"parent", span.parent}};
+        if (!span.detail.empty())
+            args["detail"] = span.detail;
+        // "X" 为完整事件：开始时间加持续时间，单位均为微秒
+        events.push_back({{"name", span.name},
+                          {"cat", span.category},
+                          {"ph", "X"},
+                          {"ts", span.start_us},
+                          {"dur", span.duration_us},
+                          {"pid", 1},
+                          {"tid", span.thread},
+                          {"args", std::move(args)}});
+    }
+
+    json trace = {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"},
+        {"otherData",
+         {{"recorded", total}, {"dropped", total - spans.size()}}}};
+    // SQL 语句或商品名中可能有不完整的 UTF-8 序列，替换而不是抛出异常
+    return trace.dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+bool Recorder::dump(const std::string &path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+        return false;
+    out << to_chrome_json();
+    return static_cast<bool>(out);
+}
+
+Span::Span(const char *category, std::string_view name) {
+    Recorder &recorder = Recorder::get_instance();
+    if (!recorder.is_enabled())
+        return;
+
+    active = true;
+    event.name = std::string(name);
+    event.category = category;
+    event.id = recorder.new_id();
+    event.thread = thread_index();
+
+    outer = current_span;
+    if (outer && outer->active)
+        event.parent = outer->event.id;
+    current_span = this;
+
+    event.start_us = recorder.now_us();
+}
+
+Span::~Span() {
+    if (!active)
+        return;
+
+    Recorder &recorder = Recorder::get_instance();
+    uint64_t end_us = recorder.now_us();
+    event.duration_us = end_us > event.start_us ? end_us - event.start_us : 0;
+    current_span = outer;
+    recorder.record(std::move(event));
+}
+
+} // namespace Trace
@@ -0,0 +1,192 @@
+/**
+ * @file      Trace.h
+ * @brief     轻量级调用追踪
+ * @details   用 RAII 作用域记录一段代码的开始时间与耗时（span），
+ *            同一线程上嵌套的 span 通过线程局部的上下文记录父子关系。
+ *            结束的 span 写入有界的环形缓冲区，写满后覆盖最早的记录，
+ *            可导出为 Chrome 追踪事件格式的 JSON，
+ *            用 chrome://tracing 或 Perfetto 打开查看火焰图。
+ *
+ *            未启用时构造 span 只读取一次原子标志，不记录时间也不分配内存。
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Trace {
+
+/**
+ * @brief 一条已结束的 span
+ *
+ */
+struct Event {
+    std::string name;          ///< 名称，如 "CartManager::checkout"
+    const char *category = ""; ///< 类别，如 "ui"、"model"、"sql"
+    std::string detail;        ///< 附加信息（如 SQL 语句）
+    uint64_t id = 0;           ///< span 编号
+    uint64_t parent = 0;       ///< 同一线程上外层 span 的编号，0 为无
+    uint32_t thread = 0;       ///< 线程编号（按首次记录的顺序分配）
+    uint64_t start_us = 0;     ///< 开始时间（相对追踪启用时刻，微秒）
+    uint64_t duration_us = 0;  ///< 耗时（微秒）
+};
+
+/**
+ * @brief span 记录器（单例）
+ *
+ */
+class Recorder {
+  public:
+    // 默认保留最近的 65536 条 span
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+  private:
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> next_id{0};
+
+    mutable std::mutex mtx;
+    std::vector<Event> ring; ///< 环形缓冲区
+    size_t capacity = DEFAULT_CAPACITY;
+    size_t next = 0;         ///< 下一条写入的位置
+    uint64_t recorded = 0;   ///< 累计记录的条数（含被覆盖的）
+    std::vector<std::pair<uint32_t, std::string>> thread_names;
+
+    // 启用时刻（steady_clock 的纳秒数），重新启用时更新
+    std::atomic<int64_t> origin_ns{0};
+
+    Recorder() = default;
+
+  public:
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+
+    static Recorder &get_instance();
+
+    /**
+     * @brief 开始记录（清空已有记录）
+     *
+     * @param capacity 缓冲区最多保留的 span 数
+     */
+    void enable(const size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief 停止记录（已记录的 span 保留，仍可导出）
+     *
+     */
+    void disable() { enabled.store(false, std::memory_order_relaxed); }
+
+    bool is_enabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // 分配 span 编号
+    uint64_t new_id() {
+        return next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // 相对启用时刻的微秒数
+    uint64_t now_us() const;
+
+    /**
+     * @brief 写入一条已结束的 span
+     *
+     * @param event span
+     */
+    void record(Event event);
+
+    /**
+     * @brief 为当前线程命名（显示在追踪视图的线程标题上）
+     *
+     * @param name 线程名，如 "ui"
+     */
+    void set_thread_name(const std::string &name);
+
+    /**
+     * @brief 按开始时间顺序取出缓冲区中的 span
+     *
+     * @return std::vector<Event> span 列表
+     */
+    std::vector<Event> snapshot() const;
+
+    /**
+     * @brief 导出为 Chrome 追踪事件格式
+     *
+     * @return std::string JSON 文本
+     */
+    std::string to_chrome_json() const;
+
+    /**
+     * @brief 导出到文件
+     *
+     * @param path 文件路径
+     * @return true 写入成功
+     * @return false 无法写入
+     */
+    bool dump(const std::string &path) const;
+};
+
+/**
+ * @brief 当前线程的编号
+ *
+ * @return uint32_t 编号，从 1 开始
+ */
+uint32_t thread_index();
+
+/**
+ * @brief RAII 作用域：构造时开始，析构时结束并写入记录器
+ *
+ * 名称在构造时复制，可以传入临时字符串。
+ */
+class Span {
+  private:
+    Span *outer = nullptr; ///< 同一线程上的外层 span
+    bool active = false;
+    Event event;
+
+  public:
+    Span(const char *category, std::string_view name);
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+    ~Span();
+
+    /**
+     * @brief 修改名称（未启用时忽略）
+     *
+     * 名称需要额外计算时，可先以固定名称构造，is_active 为真时再设置。
+     *
+     * @param name 名称
+     */
+    void set_name(std::string name) {
+        if (active)
+            event.name = std::move(name);
+    }
+
+    /**
+     * @brief 设置附加信息（未启用时忽略）
+     *
+     * @param detail 附加信息
+     */
+    void set_detail(std::string detail) {
+        if (active)
+            event.detail = std::move(detail);
+    }
+
+    bool is_active() const { return active; }
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+// 在当前作用域内记录一个 span：TRACE_SCOPE("model", "CartManager::checkout");
+#define TRACE_SCOPE(category, name)                                            \
+    Trace::Span TRACE_CONCAT(trace_span_, __LINE__)(category, name)
@@ -11,36 +11,29 @@ ShopAppUI::ShopAppUI(AppContext &context) : ctx(context) {
             register_layout->clear();
     };
 
-    refresh_shop_page = [this] {
-        shop_layout->refresh(ctx, on_checkout, add_cart);
-        shop_container_slot->DetachAllChildren();
-        shop_container_slot->Add(shop_layout->get_component());
-    };
-
-    refresh_cart_page = [this] {
-        cart_layout->refresh(ctx, on_shopping, on_orders_info,
-                             delete_item_success, checkout_success);
-
-        cart_container_slot->DetachAllChildren();
-        cart_container_slot->Add(cart_layout->get_component());
-    };
-
-    refresh_order_page = [this] {
-        order_layout->refresh(ctx, on_checkout, on_shopping,
-                              on_history_orders_info, on_orders_update,
-                              on_orders_delete);
-
-        order_container_slot->DetachAllChildren();
-        order_container_slot->Add(order_layout->get_component());
-    };
-
-    refresh_history_order_page = [this] {
-        history_order_layout->refresh(ctx, on_orders_info, on_shopping,
-                                      refresh_history_order_page);
-        history_order_container_slot->DetachAllChildren();
-        history_order_container_slot->Add(
-            history_order_layout->get_component());
-    };
+    // 页面组件保持不变，只按新数据协调列表中变化的行
+    refresh_shop_page = [this] { shop_layout->reload(ctx); };
+
+    refresh_cart_page = [this] { cart_layout->reload(ctx); };
+
+    refresh_order_page = [this] { order_layout->reload(ctx); };
+
+    refresh_history_order_page = [this] { history_order_layout->reload(ctx); };
+
+    // 数据变更只标记受影响的页面，同一帧内的多次变更只重建一次
+    change_subscription = ChangeBus::get_instance().subscribe(
+        ALL_CHANGES, [this](unsigned int changes) {
+            unsigned int regions = 0;
+            if (changes & PRODUCT_CHANGED)
+                regions |= SHOP_PAGE;
+            if (changes & CART_CHANGED)
+                regions |= CART_PAGE;
+            if (changes & ORDER_CHANGED)
+                regions |= ORDER_PAGE;
+            if (changes & HISTORY_ORDER_CHANGED)
+                regions |= HISTORY_ORDER_PAGE;
+            render_scheduler.invalidate(regions);
+        });
 
     on_login = [this] {
         refresh_login_page();
@@ -66,7 +59,8 @@ ShopAppUI::ShopAppUI(AppContext &context) : ctx(context) {
             history_order_container_slot->DetachAllChildren();
             history_order_layout.reset();
         }
-        // 用户登出
+        // 用户登出，丢弃数据仓库中该用户的购物车与订单
+        ctx.store.clear_user_data();
         ctx.current_user = nullptr;
         ctx.user_manager.logout();
         tab_index = 0; // 注销成功跳转登入页面
@@ -76,6 +70,11 @@ ShopAppUI::ShopAppUI(AppContext &context) : ctx(context) {
         if (!ctx.current_user)
             return;
 
+        // 页面全部新建，丢弃上一位用户遗留的变更与脏标记
+        ChangeBus::get_instance().flush();
+        render_scheduler.consume(SHOP_PAGE | CART_PAGE | ORDER_PAGE |
+                                 HISTORY_ORDER_PAGE);
+
         if (ctx.current_user->is_admin) {
             admin_layout = std::make_shared<AdminPortal>(ctx);
             admin_container_slot->DetachAllChildren();
@@ -83,24 +82,21 @@ ShopAppUI::ShopAppUI(AppContext &context) : ctx(context) {
             tab_index = 6; // 管理员门户
         } else {
             // 初始化商品页面
-            shop_layout =
-                std::make_shared<ShopLayOut>(ctx, on_checkout, add_cart);
+            shop_layout = std::make_shared<ShopLayOut>(ctx, on_checkout);
             shop_container_slot->Add(shop_layout->get_component());
 
             // 初始化购物车页面
 
-            cart_layout = std::make_shared<CartLayOut>(
-                ctx, on_shopping, on_orders_info, delete_item_success,
-                checkout_success);
+            cart_layout =
+                std::make_shared<CartLayOut>(ctx, on_shopping, on_orders_info);
 
             // 初始化订单页面
             order_layout = std::make_shared<OrderLayOut>(
-                ctx, on_checkout, on_shopping, on_history_orders_info,
-                on_orders_update, on_orders_delete);
+                ctx, on_checkout, on_shopping, on_history_orders_info);
 
             // 初始化历史订单页面
             history_order_layout = std::make_shared<HistoryOrderLayOut>(
-                ctx, on_orders_info, on_shopping, refresh_history_order_page);
+                ctx, on_orders_info, on_shopping);
 
             // 加载用户内容
             cart_container_slot->DetachAllChildren();
@@ -134,27 +130,35 @@ ShopAppUI::ShopAppUI(AppContext &context) : ctx(context) {
         tab_index = 2; // 跳转到商城页面
     };
 
-    add_cart = [this] { refresh_cart_page(); };
-
     on_orders_info = [this] {
         tab_index = 4; // 跳转到订单详情页面
     };
 
-    delete_item_success = [this] { refresh_cart_page(); };
-
-    checkout_success = [this] {
-        refresh_shop_page();
-        refresh_cart_page();
-        refresh_order_page();
-    };
-
-    on_orders_update = [this] { refresh_order_page(); };
-
-    on_orders_delete = [this] {
-        refresh_shop_page();
-        refresh_order_page();
-        refresh_history_order_page();
-    };
-
     on_history_orders_info = [this] { tab_index = 5; };
 }
+
+void ShopAppUI::flush_dirty_pages() {
+    ChangeBus::get_instance().flush();
+
+    switch (tab_index) {
+    case 2:
+        if (shop_layout && render_scheduler.consume(SHOP_PAGE))
+            refresh_shop_page();
+        break;
+    case 3:
+        if (cart_layout && render_scheduler.consume(CART_PAGE))
+            refresh_cart_page();
+        break;
+    case 4:
+        if (order_layout && render_scheduler.consume(ORDER_PAGE))
+            refresh_order_page();
+        break;
+    case 5:
+        if (history_order_layout &&
+            render_scheduler.consume(HISTORY_ORDER_PAGE))
+            refresh_history_order_page();
+        break;
+    default:
+        break;
+    }
+}
@@ -2,18 +2,22 @@
 #include "AdminPortal.h"
 #include "AppContext.h"
 #include "CartPage.h"
+#include "ChangeBus.h"
+#include "FrameOverlay.h"
 #include "HistoryOrderPage.h"
 #include "LoginPage.h"
+#include "Metrics.h"
 #include "OrderPage.h"
 #include "RegisterPage.h"
+#include "RenderScheduler.h"
 #include "SharedComponent.h"
 #include "ShopPage.h"
+#include "Trace.h"
 
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/screen_interactive.hpp"
-#include <atomic>
+#include <cstdlib>
 #include <ftxui/dom/elements.hpp>
-#include <thread>
 
 using namespace ftxui;
 
@@ -47,8 +51,24 @@ class ShopAppUI {
     Component main_container; // 整个 App 的主容器
     Component tab_container;  // 页面切换容器
 
-    // 原子布尔值，用来控制后台线程何时停止
-    std::atomic<bool> refresh_thread_running = false;
+    // 脏区域调度：时钟按秒标记，数据变化只标记受影响的页面
+    RenderScheduler render_scheduler;
+
+    // 导航栏时钟文本（仅在时钟区域被标记时重新格式化）
+    std::string clock_text;
+
+    // 帧耗时与输入延迟统计（F2 浮层，F3 录制）
+    FrameProfiler frame_profiler;
+
+    // 帧统计的默认录制文件（可用环境变量 FRAME_STATS_FILE 指定）
+    static constexpr const char *FRAME_STATS_FILE = "data/frame_stats.csv";
+
+    // 变更事件总线的订阅 ID
+    int change_subscription = 0;
+
+    // 分发本次事件中合并的数据变更，并重建当前显示且被标记为脏的页面，
+    // 未显示的页面等切换过去时再重建
+    void flush_dirty_pages();
 
     // 全部的 lambda 回调函数
 
@@ -69,14 +89,7 @@ class ShopAppUI {
     std::function<void()> on_shopping;         // 前往商品页
     std::function<void()> on_checkout;         // 前往购物车
     std::function<void()> on_orders_info;      // 前往订单页
-    std::function<void()> add_cart;            // 添加购物车商品时刷新 cart_page
-    std::function<void()> delete_item_success; // 删除购物车商品刷新 cart_page
-    std::function<void()> checkout_success; // 结账刷新  shop_page(更新库存)、
-                                            // cart_page 和 order_page
     std::function<void()> on_history_orders_info; // 前往历史订单页
-    std::function<void()> on_orders_update;       // 修改订单刷新 orderpage
-    std::function<void()> on_orders_delete; //  删除订单刷新 shop_page(更新库存)
-                                            //  、order_page 和 history_page
   public:
     explicit ShopAppUI(AppContext &context);
 
@@ -89,6 +102,18 @@ class ShopAppUI {
         // 任何持有 ctx 的页面都可以通过调用 ctx.request_repaint() 来刷新屏幕
         ctx.request_repaint = [&screen] { screen.Post(Event::Custom); };
 
+        // 后台加载的结果投递回 UI 线程应用，随后触发一次重绘
+        ctx.post_to_ui = [&screen](std::function<void()> task) {
+            screen.Post(std::move(task));
+            screen.Post(Event::Custom);
+        };
+
+        // 其他线程发布的数据变更也需要一次事件来分发
+        ChangeBus::get_instance().set_on_pending(
+            [&screen] { screen.Post(Event::Custom); });
+        render_scheduler.set_post_repaint(
+            [&screen] { screen.Post(Event::Custom); });
+
         // 创建页面实例(shop_layout、 cart_layout、order_layout、
         // history_order_layout 都需要登录后创建)
         login_layout =
@@ -113,17 +138,35 @@ class ShopAppUI {
 
         auto final_content = Container::Vertical({tab_content, logout_logic});
 
+        // 每帧构建元素树与每个事件（含重建页面）的耗时
+        auto &registry = Metrics::Registry::get_instance();
+        auto &frame_seconds = registry.histogram(
+            "shopping_ui_frame_seconds", "界面构建一帧元素树的耗时");
+        auto &event_seconds = registry.histogram(
+            "shopping_ui_event_seconds",
+            "界面处理一个事件（含重建页面）的耗时");
+
         //  全局导航栏 (只有登录后才显示)
         auto layout = Renderer(final_content, [&] {
+            TRACE_SCOPE("ui", "ShopAppUI::render");
+            Metrics::ScopedTimer frame_timer(frame_seconds);
+            render_scheduler.begin_frame();
+            render_scheduler.set_header_visible(ctx.current_user != nullptr);
+
             Element page = tab_content->Render();
 
             if (ctx.current_user == nullptr) {
                 return page;
             }
 
+            // 时钟只在整秒被标记时重新格式化
+            if (render_scheduler.consume(HEADER_CLOCK) || clock_text.empty())
+                clock_text = Utils::get_current_time();
+
             // 通用元素
             auto clock_element =
-                SharedComponents::get_clock_element() | color(Color::White);
+                SharedComponents::get_clock_element(clock_text) |
+                color(Color::White);
             auto user_element = text(ctx.current_user->username + "") | bold |
                                 color(Color::Gold1);
             // 分支渲染
@@ -187,42 +230,73 @@ class ShopAppUI {
             return vbox({header, page | flex});
         });
 
+        // 帧统计包在整个界面外层，浮层叠加在右上角
+        auto profiled = Renderer(layout, [&] {
+            frame_profiler.begin_frame();
+            Element frame = layout->Render();
+            frame_profiler.end_frame();
+
+            if (!frame_profiler.is_overlay_visible())
+                return frame;
+            return dbox({frame, vbox({hbox({filler(),
+                                            frame_profiler.render_overlay()}),
+                                      filler()})});
+        });
+
         // 全局按键捕获 (Global Event Handler)
-        // 处理导航快捷键, 提供按 “q” 退出
-        auto main_logic = CatchEvent(layout, [&, this](Event event) {
+        // 处理导航快捷键, 提供按 “q” 退出, F2 显示帧统计, F3 录制帧统计
+        auto main_logic = CatchEvent(profiled, [&, this](Event event) {
             if (event == Event::Character('q')) {
                 screen.Exit();
                 return true;
             }
 
-            return false;
-            // if (event == Event::Character('1')) {
-            //     tab_index = 2;
-            // }
-            // return false;
-        });
-
-        // 启动一个后台线程，每秒触发一次刷新
-        refresh_thread_running = true;
-        std::thread refresh_thread([&] {
-            while (refresh_thread_running) {
-                using namespace std::chrono_literals;
-                std::this_thread::sleep_for(1s); // 等待 1 秒
+            if (event == Event::F2) {
+                frame_profiler.toggle_overlay();
+                return true;
+            }
 
-                // 刷新页面
-                ctx.request_repaint();
+            if (event == Event::F3) {
+                if (frame_profiler.is_recording()) {
+                    frame_profiler.stop_recording();
+                } else {
+                    const char *path = std::getenv("FRAME_STATS_FILE");
+                    frame_profiler.start_recording(path ? path
+                                                        : FRAME_STATS_FILE);
+                }
+                return true;
             }
+
+            // 先交给页面处理，再统一重建本次事件中被标记的可见页面，
+            // 一次事件里的多次数据变化只重建一次
+            TRACE_SCOPE("ui", "ShopAppUI::event");
+            Metrics::ScopedTimer event_timer(event_seconds);
+            frame_profiler.begin_event(event != Event::Custom);
+            layout->OnEvent(event);
+            flush_dirty_pages();
+            frame_profiler.end_event();
+            return true;
         });
 
+        // 时钟线程：仅在导航栏可见时按整秒触发重绘
+        render_scheduler.start_clock();
+
+        Trace::Recorder::get_instance().set_thread_name("ui");
+
         //  启动主循环
         screen.Loop(main_logic);
 
-        //  退出后清理线程
-        refresh_thread_running = false;
-        if (refresh_thread.joinable()) {
-            refresh_thread.join();
-        }
+        //  退出后停止时钟线程、管理员监控线程和后台加载线程
+        //  （screen 随后销毁，不能再被投递）
+        render_scheduler.stop_clock();
+        admin_container_slot->DetachAllChildren();
+        admin_layout.reset();
+        frame_profiler.stop_recording();
+        ctx.executor.shutdown();
+        ChangeBus::get_instance().set_on_pending(nullptr);
     }
 
-    ~ShopAppUI() {};
+    ~ShopAppUI() {
+        ChangeBus::get_instance().unsubscribe(change_subscription);
+    };
 };
@@ -2,11 +2,28 @@
 
 AdminPortal::AdminPortal(AppContext &context) : ctx(context) {
     // 回调函数定义
-    back_dashboard = [this] { admin_tab_index = 0; };
+    // 仪表盘与监控页都显示监控数据，离开后不再请求重绘
+    back_dashboard = [this] {
+        admin_tab_index = 0;
+        perf_monitor->set_visible(true);
+        perf_monitor->set_arrivals_enabled(false);
+    };
 
-    on_user_manage_page = [this] { admin_tab_index = 1; };
+    on_user_manage_page = [this] {
+        admin_tab_index = 1;
+        perf_monitor->set_visible(false);
+    };
 
-    on_inventory_page = [this] { admin_tab_index = 2; };
+    on_inventory_page = [this] {
+        admin_tab_index = 2;
+        perf_monitor->set_visible(false);
+    };
+
+    on_monitor_page = [this] {
+        admin_tab_index = 3;
+        perf_monitor->set_visible(true);
+        perf_monitor->set_arrivals_enabled(true);
+    };
 
     refresh_inventory_page = [this] {
         inventory_layout->refresh(ctx, back_dashboard, refresh_inventory_page);
@@ -21,9 +38,17 @@ AdminPortal::AdminPortal(AppContext &context) : ctx(context) {
         user_manage_container_slot->Add(user_manage_layout->get_component());
     };
 
-    // 初始化子页面(其中仪表盘是不涉及数据修改，这里不套壳)
+    // 监控采样从进入管理员界面开始，初始停留在仪表盘
+    perf_monitor = std::make_shared<PerfMonitor>(ctx);
+    perf_monitor->set_visible(true);
+    perf_monitor->start();
+
+    // 初始化子页面(其中仪表盘和监控页不涉及数据修改，这里不套壳)
     auto dashboard_page =
-        DashboradLayOut::Create(on_inventory_page, on_user_manage_page);
+        DashboradLayOut::Create(on_inventory_page, on_user_manage_page,
+                                on_monitor_page, perf_monitor);
+
+    auto monitor_page = MonitorLayOut::Create(perf_monitor, back_dashboard);
 
     inventory_layout = std::make_shared<InventoryLayOut>(
         ctx, back_dashboard, refresh_inventory_page);
@@ -40,6 +65,7 @@ AdminPortal::AdminPortal(AppContext &context) : ctx(context) {
             dashboard_page,
             user_manage_container_slot,
             inventory_container_slot,
+            monitor_page,
         },
         &admin_tab_index);
 }
@@ -1,6 +1,8 @@
 #include "AppContext.h"
 #include "DashboardPage.h"
 #include "InventoryPage.h"
+#include "MonitorPage.h"
+#include "PerfMonitor.h"
 #include "SharedComponent.h"
 #include "UserManagePage.h"
 
@@ -12,7 +14,11 @@ class AdminPortal {
   private:
     AppContext &ctx;
 
-    int admin_tab_index = 0; // 管理管理员页面 0-仪表盘 1-用户管理 2-商品管理
+    // 管理管理员页面 0-仪表盘 1-用户管理 2-商品管理 3-运行监控
+    int admin_tab_index = 0;
+
+    // 运行监控的采样器（仪表盘卡片与监控页共用）
+    std::shared_ptr<PerfMonitor> perf_monitor;
 
     // 管理页面智能指针
     std::shared_ptr<InventoryLayOut> inventory_layout;
@@ -28,11 +34,15 @@ class AdminPortal {
     std::function<void()> back_dashboard;           // 回到仪表盘
     std::function<void()> on_inventory_page;        // 前往商品管理
     std::function<void()> on_user_manage_page;      // 前往用户管理
+    std::function<void()> on_monitor_page;          // 前往运行监控
     std::function<void()> refresh_inventory_page;   // 刷新商品管理页
     std::function<void()> refresh_user_manage_page; // 刷新用户管理页
   public:
     explicit AdminPortal(AppContext &context);
 
+    // 停止监控采样线程（其间会请求重绘，须先于屏幕销毁）
+    ~AdminPortal() { perf_monitor->stop(); }
+
     // 获取当前管理员页面
     Component get_component() { return tab_container; }
 };
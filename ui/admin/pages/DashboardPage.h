@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PerfMonitor.h"
+#include "Utils.h"
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/screen_interactive.hpp"
 #include <ftxui/dom/elements.hpp>
@@ -10,15 +12,19 @@ class DashboradLayOut {
   private:
   public:
     static Component Create(std::function<void()> on_inventory_page,
-                            std::function<void()> on_usermanage_page) {
-        // 定义跳转商品管理和用户管理页面的按钮
+                            std::function<void()> on_usermanage_page,
+                            std::function<void()> on_monitor_page,
+                            std::shared_ptr<PerfMonitor> monitor) {
+        // 定义跳转商品管理、用户管理和运行监控页面的按钮
         auto option = ButtonOption::Animated(Color::Red);
 
         auto btn_inventory = Button("进入商品管理", on_inventory_page, option);
         auto btn_users = Button("进入用户管理", on_usermanage_page, option);
+        auto btn_monitor = Button("进入运行监控", on_monitor_page, option);
 
         // 按钮布局
-        auto container = Container::Horizontal({btn_inventory, btn_users});
+        auto container =
+            Container::Horizontal({btn_inventory, btn_users, btn_monitor});
 
         // 渲染逻辑
         return Renderer(container, [=] {
@@ -46,12 +52,22 @@ class DashboradLayOut {
                              btn->Render() | center, // 按钮放在底部
                              filler()}) |
                        borderRounded | color(border_c) |
-                       flex; // 让两个卡片平分宽度
+                       flex; // 让卡片平分宽度
             };
 
             // 检查当前焦点在哪里，以便高亮对应的卡片
             bool inv_focused = btn_inventory->Focused();
             bool user_focused = btn_users->Focused();
+            bool monitor_focused = btn_monitor->Focused();
+
+            // 监控卡片显示最近一次采样的摘要（只读快照，不查询数据库）
+            PerfSnapshot perf = monitor->snapshot();
+            std::string perf_desc =
+                perf.has_window
+                    ? "SQL " + Utils::format_fixed(perf.db_qps) +
+                          " QPS / p99 " + Utils::format_fixed(perf.db_p99_ms) +
+                          " ms"
+                    : "正在采样...";
 
             // 构建主视图
             return vbox({// --- 顶部标题栏 (风格参考 ShopPage) ---
@@ -74,10 +90,16 @@ class DashboradLayOut {
                                // 中间加一点间距
                                text("  "),
 
-                               // 右侧：用户管理卡片
+                               // 中间：用户管理卡片
                                make_card("用户与权限", "👥",
                                          "查看列表 / 封禁账户 / 审计",
-                                         btn_users, user_focused)}) |
+                                         btn_users, user_focused),
+
+                               text("  "),
+
+                               // 右侧：运行监控卡片
+                               make_card("运行监控", "📈", perf_desc,
+                                         btn_monitor, monitor_focused)}) |
                              flex, // 增加内边距让卡片不贴边
 
                          // --- 底部状态栏 ---
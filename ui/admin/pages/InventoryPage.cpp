@@ -5,9 +5,6 @@
 void InventoryLayOut::init_page(AppContext &ctx,
                                 std::function<void()> back_dashboard,
                                 std::function<void()> refresh_inventory_page) {
-    // 加载商品数据
-    ctx.product_manager.load_all_product();
-
     //  定义UI组件容器
     auto list_container = Container::Vertical({});
 
@@ -21,7 +18,8 @@ void InventoryLayOut::init_page(AppContext &ctx,
                    [this, &ctx, list_container, back_dashboard](Event event) {
                        if (event == Event::Return) {
 
-                           refresh_list(ctx, list_container, back_dashboard);
+                           search_from_first_page(ctx, list_container,
+                                                  back_dashboard);
                            return true; // 消费事件，不传入 Input，防止换行
                        }
                        return false;
@@ -31,10 +29,38 @@ void InventoryLayOut::init_page(AppContext &ctx,
     auto btn_search = Button(
         "🔍 搜索",
         [this, &ctx, list_container, back_dashboard] {
-            refresh_list(ctx, list_container, back_dashboard);
+            search_from_first_page(ctx, list_container, back_dashboard);
         },
         ButtonOption::Animated(Color::Gold1));
 
+    // 排序方式切换，切换后回到第一页
+    auto sort_option = MenuOption::Horizontal();
+    sort_option.on_change = [this, &ctx, list_container, back_dashboard] {
+        search_from_first_page(ctx, list_container, back_dashboard);
+    };
+    auto sort_menu = Menu(&sort_choices, &sort_selection, sort_option);
+
+    // 翻页按钮
+    auto btn_prev_page = Button(
+        "◀ 上一页",
+        [this, &ctx, list_container, back_dashboard] {
+            if (page_cursors.size() <= 1)
+                return;
+            page_cursors.pop_back();
+            refresh_list(ctx, list_container, back_dashboard);
+        },
+        ButtonOption::Ascii());
+
+    auto btn_next_page = Button(
+        "下一页 ▶",
+        [this, &ctx, list_container, back_dashboard] {
+            if (!has_next_page)
+                return;
+            page_cursors.push_back(next_cursor);
+            refresh_list(ctx, list_container, back_dashboard);
+        },
+        ButtonOption::Ascii());
+
     // 添加商品按钮
     auto btn_add_new = Button(
         "➕ 添加商品",
@@ -161,8 +187,10 @@ void InventoryLayOut::init_page(AppContext &ctx,
         {search_input_logic | flex, btn_search, btn_add_new});
     // 支持鼠标滚动进度条
     auto scroller = SharedComponents::Scroller(list_container);
-    auto final_logic_content =
-        Container::Vertical({top_bar, scroller | flex, btn_back});
+    auto bottom_bar =
+        Container::Horizontal({btn_prev_page, btn_back, btn_next_page});
+    auto final_logic_content = Container::Vertical(
+        {top_bar, sort_menu, scroller | flex, bottom_bar});
 
     auto final_main_layout =
         SharedComponents::allow_scroll_action(final_logic_content);
@@ -198,6 +226,10 @@ void InventoryLayOut::init_page(AppContext &ctx,
                    btn_search->Render(), text("  "), btn_add_new->Render()}) |
                  size(HEIGHT, EQUAL, 3),
 
+             // 排序方式（仅浏览全部商品时生效）
+             hbox({text(" 排序: ") | dim, sort_menu->Render(),
+                   filler()}),
+
              separator(),
 
              // 列表区域
@@ -207,9 +239,15 @@ void InventoryLayOut::init_page(AppContext &ctx,
 
              // 底部按钮
              hbox({
+                 btn_prev_page->Render() | center |
+                     (page_cursors.size() > 1 ? nothing : dim),
                  filler(),
                  btn_back->Render() | center | size(HEIGHT, EQUAL, 3),
                  filler(),
+                 text("第 " + std::to_string(page_cursors.size()) + " 页 ") |
+                     center | dim,
+                 btn_next_page->Render() | center |
+                     (has_next_page ? nothing : dim),
              })});
 
         // 统一的弹窗样式生成器
@@ -276,8 +314,25 @@ void InventoryLayOut::refresh_list(AppContext &ctx, Component list_container,
                                    std::function<void()> on_back) {
     list_container->DetachAllChildren();
 
-    //  获取搜索结果
-    auto products = ctx.product_manager.search_all_product(search_query);
+    //  未输入关键词时按排序方式分页浏览，只读取当前页；
+    //  输入关键词时在商品目录中搜索，结果不分页
+    std::vector<Product> products;
+    if (search_query.empty()) {
+        ProductPageQuery query;
+        query.sort_key = static_cast<ProductSortKey>(sort_selection);
+        query.status = ProductStatusFilter::ALL;
+
+        auto page =
+            ctx.product_manager.list_products_page(query, page_cursors.back());
+        next_cursor = page.next_cursor;
+        has_next_page = page.has_more;
+        products = std::move(page.products);
+    } else {
+        next_cursor = ProductPageCursor{};
+        has_next_page = false;
+        products =
+            ctx.product_manager.search_all_product(search_query).to_vector();
+    }
 
     if (products.empty()) {
         list_container->Add(Renderer([] {
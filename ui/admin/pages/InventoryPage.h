@@ -36,6 +36,17 @@ class InventoryLayOut {
     // 错误/提示信息
     std::string status_msg;
 
+    // 排序方式（对应 ProductSortKey）
+    int sort_selection = 0;
+    std::vector<std::string> sort_choices = {"ID", "名称", "价格", "库存"};
+
+    // 分页状态：每一页的起始游标（末尾为当前页），用于返回上一页
+    std::vector<ProductPageCursor> page_cursors = {ProductPageCursor{}};
+
+    // 下一页的起始游标及是否存在下一页
+    ProductPageCursor next_cursor;
+    bool has_next_page = false;
+
   public:
     InventoryLayOut(AppContext &ctx, std::function<void()> back_dashboard,
                     std::function<void()> refresh_inventory_page) {
@@ -45,16 +56,26 @@ class InventoryLayOut {
     void init_page(AppContext &ctx, std::function<void()> back_dashboard,
                    std::function<void()> refresh_inventory_page);
 
-    // 刷新列表逻辑
+    // 刷新列表逻辑（重新加载当前页）
     void refresh_list(AppContext &ctx, Component list_container,
                       std::function<void()> back_dashboard);
 
+    // 以新的搜索条件或排序方式从第一页开始加载
+    void search_from_first_page(AppContext &ctx, Component list_container,
+                                std::function<void()> back_dashboard) {
+        page_cursors = {ProductPageCursor{}};
+        refresh_list(ctx, list_container, back_dashboard);
+    }
+
     Component get_component() { return component; }
 
     void refresh(AppContext &ctx, std::function<void()> back_dashboard,
                  std::function<void()> refresh_inventory_page) {
         search_query = "";
         status_msg = "";
+        page_cursors = {ProductPageCursor{}};
+        next_cursor = ProductPageCursor{};
+        has_next_page = false;
         init_page(ctx, back_dashboard, refresh_inventory_page);
     }
 };
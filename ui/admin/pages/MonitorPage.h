@@ -0,0 +1,144 @@
+#pragma once
+
+#include "PerfMonitor.h"
+#include "Utils.h"
+#include "ftxui/component/component.hpp"
+#include "ftxui/component/screen_interactive.hpp"
+#include <ftxui/dom/elements.hpp>
+
+using namespace ftxui;
+
+// 运行监控页：展示 PerfMonitor 最近一次采样的快照，采样线程每秒请求重绘
+class MonitorLayOut {
+  private:
+  public:
+    static Component Create(std::shared_ptr<PerfMonitor> monitor,
+                            std::function<void()> back_dashboard) {
+        auto btn_back = Button("返回控制台", back_dashboard,
+                               ButtonOption::Animated(Color::RedLight));
+
+        return Renderer(btn_back, [=] {
+            using Utils::format_fixed;
+
+            // 辅助函数：一行指标，label: 名称, value: 数值
+            auto row = [](std::string label, std::string value) {
+                return hbox({text(label) | dim | size(WIDTH, EQUAL, 18),
+                             text(value) | bold});
+            };
+
+            // 辅助函数：一个指标分组
+            auto section = [](std::string title, Elements rows) {
+                return window(text(" " + title + " ") | bold, vbox(rows)) |
+                       flex;
+            };
+
+            // 辅助函数：命中率条
+            auto ratio_row = [](std::string label, const CacheStats &stats) {
+                double ratio = stats.hit_ratio();
+                Color c = ratio >= 0.8   ? static_cast<Color>(Color::Green)
+                          : ratio >= 0.5 ? static_cast<Color>(Color::Yellow)
+                                         : static_cast<Color>(Color::Red);
+                return hbox({text(label) | dim | size(WIDTH, EQUAL, 18),
+                             gauge(static_cast<float>(ratio)) | color(c) |
+                                 size(WIDTH, EQUAL, 20),
+                             text(" " + format_fixed(ratio * 100) + "%") |
+                                 bold});
+            };
+
+            PerfSnapshot perf = monitor->snapshot();
+            std::string window_tip =
+                perf.has_window
+                    ? "最近 " + format_fixed(perf.window_seconds, 0) + " 秒"
+                    : "正在采样...";
+
+            // 待送达订单积压由后台定期统计，显示统计时刻
+            std::string arrivals_age = "统计中...";
+            std::string in_transit = "-";
+            std::string overdue = "-";
+            if (perf.arrivals) {
+                auto age = std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::steady_clock::now() - perf.arrivals_at);
+                arrivals_age = std::to_string(age.count()) + " 秒前";
+                in_transit = std::to_string(perf.arrivals->in_transit);
+                overdue = std::to_string(perf.arrivals->overdue);
+            }
+
+            auto database = section(
+                "数据库",
+                {row("SQL 每秒执行", format_fixed(perf.db_qps) + " 次"),
+                 row("耗时 p50", format_fixed(perf.db_p50_ms, 2) + " ms"),
+                 row("耗时 p99", format_fixed(perf.db_p99_ms, 2) + " ms"),
+                 row("失败语句", std::to_string(perf.db_errors)) |
+                     color(perf.db_errors > 0
+                               ? static_cast<Color>(Color::Red)
+                               : static_cast<Color>(Color::Default))});
+
+            auto caches = section(
+                "缓存",
+                {ratio_row("商品搜索命中率", perf.search_cache),
+                 ratio_row("用户命中率", perf.user_cache),
+                 row("商品搜索条目",
+                     std::to_string(perf.search_cache.size) + " / " +
+                         std::to_string(perf.search_cache.capacity)),
+                 row("用户条目", std::to_string(perf.user_cache.size) + " / " +
+                                     std::to_string(perf.user_cache.capacity)),
+                 row("商品目录", Utils::format_bytes(perf.catalog_bytes)),
+                 row("占用内存",
+                     Utils::format_bytes(perf.catalog_bytes +
+                                         perf.search_cache.bytes +
+                                         perf.user_cache.bytes))});
+
+            auto checkout = section(
+                "结账",
+                {row("每分钟结账",
+                     format_fixed(perf.checkouts_per_min) + " 次"),
+                 row("耗时 p99",
+                     format_fixed(perf.checkout_p99_ms, 2) + " ms"),
+                 row("累计结账",
+                     std::to_string(perf.checkouts_total) + " 次")});
+
+            auto arrivals = section("待送达订单", {row("运输中", in_transit),
+                                                   row("已到期未更新", overdue),
+                                                   row("统计于",
+                                                       arrivals_age)});
+
+            auto logging = section(
+                "日志",
+                {row("排队写入", std::to_string(perf.log.pending) + " (峰值 " +
+                                     std::to_string(perf.log.peak_pending) +
+                                     ")"),
+                 row("每秒写出", format_fixed(perf.log_lines_per_sec) + " 条"),
+                 row("累计写出", std::to_string(perf.log.lines) + " 条")});
+
+            auto frame = section(
+                "界面", {row("一帧耗时 p99",
+                             format_fixed(perf.ui_frame_p99_ms, 2) + " ms")});
+
+            return vbox(
+                {vbox({
+                     text(" ") | size(HEIGHT, EQUAL, 1),
+                     text(" 运   行   监   控 ") | bold | center |
+                         color(Color::Red),
+                     text(" —— LIVE PERFORMANCE MONITOR —— ") | dim | center |
+                         color(Color::GrayLight),
+                     text(" ") | size(HEIGHT, EQUAL, 1),
+                 }) | borderDouble |
+                     color(Color::Red),
+
+                 hbox({database, caches, checkout}),
+                 hbox({arrivals, logging, frame}),
+
+                 filler(),
+                 separator(),
+
+                 // 底部
+                 hbox({
+                     text(" 统计窗口：" + window_tip + "，每秒刷新") | center |
+                         dim,
+                     filler(),
+                     btn_back->Render() | center | size(HEIGHT, EQUAL, 3),
+                     filler(),
+                 })});
+        });
+    }
+};
@@ -9,7 +9,7 @@ void UserManageLayOut::init_page(
     auto list_container = Container::Vertical({});
 
     // 搜索组件
-    auto search_input = Input(&search_query, "输入 ID 或 用户名进行搜索...");
+    auto search_input = Input(&search_query, "输入 ID 或 用户名前缀进行搜索...");
 
     // 允许在按下回车时直接触发搜索
     auto search_input_logic =
@@ -17,7 +17,8 @@ void UserManageLayOut::init_page(
                    [this, &ctx, list_container, back_dashboard](Event event) {
                        if (event == Event::Return) {
 
-                           refresh_list(ctx, list_container, back_dashboard);
+                           search_from_first_page(ctx, list_container,
+                                                  back_dashboard);
                            return true; // 消费事件，不传入 Input，防止换行
                        }
                        return false;
@@ -27,10 +28,31 @@ void UserManageLayOut::init_page(
     auto btn_search = Button(
         "🔍 搜索",
         [this, &ctx, list_container, back_dashboard] {
-            refresh_list(ctx, list_container, back_dashboard);
+            search_from_first_page(ctx, list_container, back_dashboard);
         },
         ButtonOption::Animated(Color::Gold1));
 
+    // 翻页按钮
+    auto btn_prev_page = Button(
+        "◀ 上一页",
+        [this, &ctx, list_container, back_dashboard] {
+            if (page_cursors.size() <= 1)
+                return;
+            page_cursors.pop_back();
+            refresh_list(ctx, list_container, back_dashboard);
+        },
+        ButtonOption::Ascii());
+
+    auto btn_next_page = Button(
+        "下一页 ▶",
+        [this, &ctx, list_container, back_dashboard] {
+            if (!has_next_page)
+                return;
+            page_cursors.push_back(next_cursor);
+            refresh_list(ctx, list_container, back_dashboard);
+        },
+        ButtonOption::Ascii());
+
     // 返回按钮
     auto btn_back = Button("返回控制台", back_dashboard,
                            ButtonOption::Animated(Color::RedLight));
@@ -57,7 +79,7 @@ void UserManageLayOut::init_page(
             // 修改属性
             current_user.is_admin = edit_is_admin;
 
-            // 如果输入了新密码，则进行加密并更新
+            // 如果输入了新密码，先校验格式（哈希由 update_user 完成）
             if (!edit_password.empty()) {
                 std::string error;
                 if (UserManager::is_valid_password_format(
@@ -65,14 +87,11 @@ void UserManageLayOut::init_page(
                     status_msg = error;
                     return;
                 }
-                current_user.password =
-                    SecurityUtils::hash_password(edit_password);
             }
 
-            //  保存
+            //  保存（密码留空则不修改）
             ctx.user_manager.update_user(current_user.id, current_user.username,
-                                         current_user.password,
-                                         current_user.is_admin);
+                                         edit_password, current_user.is_admin);
 
             status_msg = "";
             edit_password = ""; // 清空敏感信息
@@ -125,8 +144,10 @@ void UserManageLayOut::init_page(
     auto top_bar =
         Container::Horizontal({search_input_logic | flex, btn_search});
     auto scroller = SharedComponents::Scroller(list_container);
+    auto bottom_bar =
+        Container::Horizontal({btn_prev_page, btn_back, btn_next_page});
     auto final_logic_content =
-        Container::Vertical({top_bar, scroller | flex, btn_back});
+        Container::Vertical({top_bar, scroller | flex, bottom_bar});
 
     auto final_main_layout =
         SharedComponents::allow_scroll_action(final_logic_content);
@@ -169,9 +190,16 @@ void UserManageLayOut::init_page(
 
                   // 底部
                   hbox({
+                      btn_prev_page->Render() | center |
+                          (page_cursors.size() > 1 ? nothing : dim),
                       filler(),
                       btn_back->Render() | center | size(HEIGHT, EQUAL, 3),
                       filler(),
+                      text("第 " + std::to_string(page_cursors.size()) +
+                           " 页 ") |
+                          center | dim,
+                      btn_next_page->Render() | center |
+                          (has_next_page ? nothing : dim),
                   })});
 
         // 统一弹窗辅助函数
@@ -230,8 +258,12 @@ void UserManageLayOut::refresh_list(AppContext &ctx, Component list_container,
                                     std::function<void()> back_dashboard) {
     list_container->DetachAllChildren();
 
-    //  搜索到的数据
-    auto users = ctx.user_manager.search_users_list(search_query);
+    //  搜索到的当前页数据
+    auto page =
+        ctx.user_manager.search_users_page(search_query, page_cursors.back());
+    next_cursor = page.next_cursor;
+    has_next_page = page.has_more;
+    const auto &users = page.users;
 
     if (users.empty()) {
         list_container->Add(Renderer([] {
@@ -3,6 +3,7 @@
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/screen_interactive.hpp"
 #include <ftxui/dom/elements.hpp>
+#include <vector>
 
 using namespace ftxui;
 
@@ -29,6 +30,13 @@ class UserManageLayOut {
     // 错误/提示信息
     std::string status_msg;
 
+    // 分页状态：每一页的起始游标（末尾为当前页），用于返回上一页
+    std::vector<int> page_cursors = {0};
+
+    // 下一页的起始游标及是否存在下一页
+    int next_cursor = 0;
+    bool has_next_page = false;
+
   public:
     UserManageLayOut(AppContext &ctx, std::function<void()> back_dashboard,
                      std::function<void()> refresh_user_manage_page) {
@@ -38,10 +46,17 @@ class UserManageLayOut {
     void init_page(AppContext &ctx, std::function<void()> back_dashboard,
                    std::function<void()> refresh_user_manage_page);
 
-    // 刷新列表逻辑
+    // 刷新列表逻辑（重新加载当前页）
     void refresh_list(AppContext &ctx, Component list_container,
                       std::function<void()> back_dashboard);
 
+    // 以新的搜索条件从第一页开始加载
+    void search_from_first_page(AppContext &ctx, Component list_container,
+                                std::function<void()> back_dashboard) {
+        page_cursors = {0};
+        refresh_list(ctx, list_container, back_dashboard);
+    }
+
     Component get_component() { return component; }
 
     void refresh(AppContext &ctx, std::function<void()> back_dashboard,
@@ -53,6 +68,9 @@ class UserManageLayOut {
         selected_user_id = -1;
         selected_username_display = "";
         show_popup = 0;
+        page_cursors = {0};
+        next_cursor = 0;
+        has_next_page = false;
 
         init_page(ctx, back_dashboard, refresh_user_manage_page);
     }
@@ -0,0 +1,198 @@
+#pragma once
+#include "Database.h"
+#include "Logger.h"
+#include "Utils.h"
+#include "ftxui/dom/elements.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <optional>
+#include <string>
+
+using namespace ftxui;
+
+// 界面响应统计：记录每帧构建元素树的耗时、上一帧以来处理事件的耗时、
+// UI 线程上同步执行的 SQL 语句数，以及输入延迟（从处理输入事件开始到
+// 反映该输入的一帧构建完成；终端不提供按键到达的时刻，以开始处理为起点）
+// 浮层显示最近一帧的数据与输入延迟的走势；录制模式把每帧数据追加写入
+// CSV 文件，供离线分析
+// 只在 UI 线程使用
+class FrameProfiler {
+  public:
+    static constexpr size_t HISTORY = 48; // 走势图保留的输入延迟个数
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    // 一帧的统计（事件类数据为上一帧结束以来的累计）
+    struct FrameStats {
+        uint64_t frame = 0;     // 帧序号
+        double render_ms = 0;   // 构建元素树的耗时
+        double event_ms = 0;    // 处理事件的总耗时
+        uint32_t events = 0;    // 处理的事件数
+        uint64_t db_calls = 0;  // UI 线程上执行的 SQL 语句数
+        double latency_ms = -1; // 输入延迟，本帧没有输入时为 -1
+    };
+
+    clock::time_point origin = clock::now();
+    clock::time_point frame_start;
+    clock::time_point event_start;
+
+    // 上一帧以来第一个输入事件的开始时刻
+    std::optional<clock::time_point> first_input;
+
+    FrameStats pending; // 正在累计的一帧
+    FrameStats last;    // 最近完成的一帧
+    uint64_t frame_count = 0;
+    uint64_t db_mark = Database::thread_statement_count();
+
+    std::deque<double> latencies; // 最近的输入延迟（毫秒）
+
+    bool overlay_visible = false;
+    std::ofstream record_file;
+    std::string record_path;
+
+    static double to_ms(const clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+
+    void write_row(const clock::time_point now) {
+        record_file << pending.frame << ',' << to_ms(now - origin) << ','
+                    << pending.render_ms << ',' << pending.event_ms << ','
+                    << pending.events << ',' << pending.db_calls << ',';
+        if (pending.latency_ms >= 0)
+            record_file << pending.latency_ms;
+        record_file << '\n';
+    }
+
+    // 用方块字符绘制走势（按窗口内的最大值缩放，至少按一帧 16.7 毫秒）
+    std::string sparkline(double &peak) const {
+        static const char *levels[] = {"▁", "▂", "▃", "▄",
+                                       "▅", "▆", "▇", "█"};
+        peak = 0;
+        for (double value : latencies)
+            peak = std::max(peak, value);
+        double scale = std::max(peak, 1000.0 / 60);
+
+        std::string line;
+        for (double value : latencies) {
+            int level = static_cast<int>(value / scale * 7 + 0.5);
+            line += levels[std::clamp(level, 0, 7)];
+        }
+        return line;
+    }
+
+  public:
+    FrameProfiler() = default;
+    FrameProfiler(const FrameProfiler &) = delete;
+    FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+    ~FrameProfiler() { stop_recording(); }
+
+    // 开始处理一个事件；is_input 为假（如重绘请求）时不计入输入延迟
+    void begin_event(const bool is_input) {
+        event_start = clock::now();
+        if (is_input && !first_input)
+            first_input = event_start;
+    }
+
+    void end_event() {
+        pending.event_ms += to_ms(clock::now() - event_start);
+        pending.events++;
+    }
+
+    void begin_frame() { frame_start = clock::now(); }
+
+    // 结束一帧：结算本帧的数据，录制时写入一行
+    void end_frame() {
+        auto now = clock::now();
+        pending.frame = ++frame_count;
+        pending.render_ms = to_ms(now - frame_start);
+
+        uint64_t statements = Database::thread_statement_count();
+        pending.db_calls = statements - db_mark;
+        db_mark = statements;
+
+        if (first_input) {
+            pending.latency_ms = to_ms(now - *first_input);
+            latencies.push_back(pending.latency_ms);
+            if (latencies.size() > HISTORY)
+                latencies.pop_front();
+            first_input.reset();
+        }
+
+        if (record_file.is_open())
+            write_row(now);
+
+        last = pending;
+        pending = FrameStats{};
+    }
+
+    bool is_overlay_visible() const { return overlay_visible; }
+
+    void toggle_overlay() { overlay_visible = !overlay_visible; }
+
+    bool is_recording() const { return record_file.is_open(); }
+
+    // 开始录制（追加到 path，新文件先写表头）
+    bool start_recording(const std::string &path) {
+        stop_recording();
+        record_file.open(path, std::ios::app);
+        if (!record_file.is_open()) {
+            LOG_ERROR("无法写入帧统计文件: " + path);
+            return false;
+        }
+        if (record_file.tellp() == 0)
+            record_file << "frame,time_ms,render_ms,event_ms,events,db_calls,"
+                           "input_latency_ms\n";
+        record_path = path;
+        LOG_INFO("开始录制帧统计: " + path);
+        return true;
+    }
+
+    void stop_recording() {
+        if (!record_file.is_open())
+            return;
+        record_file.close();
+        LOG_INFO("帧统计已保存到 " + record_path);
+    }
+
+    // 浮层元素（显示最近完成的一帧）
+    Element render_overlay() const {
+        using Utils::format_fixed;
+
+        auto row = [](std::string label, std::string value) {
+            return hbox({text(label) | dim | size(WIDTH, EQUAL, 10),
+                         text(value) | bold});
+        };
+
+        double peak = 0;
+        std::string trend = sparkline(peak);
+
+        Elements rows = {
+            row("构建耗时", format_fixed(last.render_ms, 2) + " ms"),
+            row("事件耗时", format_fixed(last.event_ms, 2) + " ms (" +
+                                std::to_string(last.events) + " 个)"),
+            row("SQL 语句", std::to_string(last.db_calls) + " 条") |
+                color(last.db_calls > 0 ? static_cast<Color>(Color::Yellow)
+                                        : static_cast<Color>(Color::Default)),
+            row("输入延迟", last.latency_ms >= 0
+                                ? format_fixed(last.latency_ms, 2) + " ms"
+                                : "-"),
+            separator(),
+            text(trend.empty() ? "等待输入..." : trend) | color(Color::Cyan),
+            text("最大 " + format_fixed(peak, 1) + " ms") | dim,
+        };
+        if (is_recording())
+            rows.push_back(text("● 录制中 " + record_path) |
+                           color(Color::Red));
+
+        return window(text(" 帧 #" + std::to_string(last.frame) +
+                           "  F2 关闭 / F3 录制 "),
+                      vbox(rows)) |
+               size(WIDTH, GREATER_THAN, 30) | bgcolor(Color::Grey11) |
+               clear_under;
+    }
+};
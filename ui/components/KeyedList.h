@@ -0,0 +1,93 @@
+#pragma once
+#include "ftxui/component/component.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <optional>
+#include <vector>
+
+using namespace ftxui;
+
+// 按键协调的列表：每行组件与一个稳定的键（商品 ID、订单 ID 等）绑定
+// 数据刷新时按新的键序列对比新旧两组行，只为新出现的键创建组件、
+// 移除消失的键，已存在的行组件直接复用（行内容应在渲染时按键读取最新数据），
+// 焦点跟随原来获焦的键，滚动位置随焦点保持
+template <typename Key> class KeyedList {
+  private:
+    // 当前获焦的行下标
+    int selected = 0;
+
+    Component container = Container::Vertical({}, &selected);
+
+    // 当前的键序列（即行的显示顺序）
+    std::vector<Key> keys;
+
+    // 键 -> 行组件
+    std::map<Key, Component> rows;
+
+  public:
+    KeyedList() = default;
+
+    // 容器捕获了 selected 的地址，禁止拷贝
+    KeyedList(const KeyedList &) = delete;
+    KeyedList &operator=(const KeyedList &) = delete;
+
+    Component get_component() { return container; }
+
+    bool empty() const { return keys.empty(); }
+
+    const std::vector<Key> &get_keys() const { return keys; }
+
+    /**
+     * @brief 按新的键序列协调行组件
+     *
+     * @param new_keys 新的键序列（按显示顺序）
+     * @param create 为新出现的键创建行组件
+     * @return size_t 新建的行数
+     */
+    size_t reconcile(const std::vector<Key> &new_keys,
+                     const std::function<Component(const Key &)> &create) {
+        // 记下当前获焦的键
+        std::optional<Key> focused_key;
+        if (selected >= 0 && selected < static_cast<int>(keys.size()))
+            focused_key = keys[selected];
+
+        std::map<Key, Component> next_rows;
+        size_t created = 0;
+        for (const auto &key : new_keys) {
+            auto it = rows.find(key);
+            if (it != rows.end()) {
+                next_rows.emplace(key, it->second);
+            } else {
+                next_rows.emplace(key, create(key));
+                created++;
+            }
+        }
+
+        // 键序列与行组件都未变化时无需调整容器
+        bool unchanged = created == 0 && new_keys == keys;
+        rows = std::move(next_rows);
+        if (!unchanged) {
+            // 只调整子组件的顺序，复用的行不会重新创建
+            container->DetachAllChildren();
+            for (const auto &key : new_keys)
+                container->Add(rows.at(key));
+        }
+        keys = new_keys;
+
+        // 获焦的键仍存在时焦点跟随它，否则停留在原位置附近
+        auto it = focused_key.has_value()
+                      ? std::find(keys.begin(), keys.end(), *focused_key)
+                      : keys.end();
+        if (it != keys.end())
+            selected = static_cast<int>(it - keys.begin());
+        else
+            selected = std::clamp(
+                selected, 0, std::max(0, static_cast<int>(keys.size()) - 1));
+
+        return created;
+    }
+
+    // 使某个键的行组件失效，下次协调时重新创建
+    void invalidate(const Key &key) { rows.erase(key); }
+};
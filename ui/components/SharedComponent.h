@@ -1,4 +1,5 @@
 #pragma once
+#include "AsyncPageModel.h"
 #include "Utils.h"
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/component_options.hpp"
@@ -43,10 +44,8 @@ inline Component create_input_with_placeholder(std::string *content,
     return Input(content, option);
 }
 
-inline Element get_clock_element() {
-
-    std::string time_str = Utils::get_current_time();
-
+// 时钟元素，时间字符串由调用方按秒缓存后传入
+inline Element get_clock_element(const std::string &time_str) {
     return hbox({text("现在时间: ") | bold, text(time_str)}) |
            color(Color::Cyan);
 }
@@ -88,4 +87,14 @@ inline Element popup_with_button_element(Component button, Element background,
                                  clear_under});
 }
 
+// 列表为空时的占位元素：加载中 / 加载失败 / 真正为空
+inline Element list_placeholder_element(const LoadState state,
+                                        Element empty_element) {
+    if (state == LoadState::IDLE || state == LoadState::LOADING)
+        return text("正在加载...") | center | dim;
+    if (state == LoadState::FAILED)
+        return text("加载失败，请稍后重试") | center | color(Color::Red);
+    return empty_element;
+}
+
 }; // namespace SharedComponents
@@ -0,0 +1,157 @@
+#pragma once
+#include "ftxui/component/component.hpp"
+#include "ftxui/component/event.hpp"
+#include "ftxui/dom/elements.hpp"
+#include "ftxui/screen/terminal.hpp"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ftxui;
+
+// 虚拟列表：只创建固定数量的行组件（可见行数 + 少量预留），
+// 滚动时行组件循环复用，行内容由 “窗口首行下标 + 行槽位” 决定
+// 行组件本身不应持有数据状态，需要保留的状态由调用方按数据的键另行存储
+class VirtualList {
+  public:
+    static constexpr int OVERSCAN = 2;      // 视口之外额外创建的行数
+    static constexpr int MIN_POOL_SIZE = 4; // 行组件池的最小行数
+
+  private:
+    Component component;
+
+    int pool_size;
+
+    // 数据总数及窗口首行对应的数据下标
+    int item_count = 0;
+    int first_index = 0;
+
+    // 当前获焦的行槽位
+    int selected_slot = 0;
+
+    // 窗口移动后回调（调用方在此同步行槽位绑定的状态）
+    std::function<void()> on_window_changed;
+
+    // 行槽位是否对应有效数据
+    bool is_slot_used(const int slot) const {
+        return first_index + slot < item_count;
+    }
+
+    // 窗口移动 offset 行（越界时截断），返回是否移动
+    bool shift_window(const int offset) {
+        int max_first = std::max(0, item_count - pool_size);
+        int new_first = std::clamp(first_index + offset, 0, max_first);
+        if (new_first == first_index)
+            return false;
+
+        first_index = new_first;
+        if (on_window_changed)
+            on_window_changed();
+        return true;
+    }
+
+    int last_used_slot() const {
+        return std::min(pool_size, item_count - first_index) - 1;
+    }
+
+  public:
+    /**
+     * @brief 根据终端高度计算行组件池大小
+     *
+     * @param row_height 每行占用的终端行数
+     */
+    static int pool_size_for(const int row_height) {
+        int rows = Terminal::Size().dimy / std::max(row_height, 1);
+        return std::max(rows + OVERSCAN, MIN_POOL_SIZE);
+    }
+
+    /**
+     * @brief 构造虚拟列表
+     *
+     * @param pool_size 行组件池大小（通常由 pool_size_for 计算）
+     * @param make_row 创建某个行槽位的组件，行内容通过 index_of(slot) 取数据
+     * @param on_window_changed 窗口移动后的回调
+     */
+    VirtualList(const int pool_size,
+                const std::function<Component(int slot)> &make_row,
+                std::function<void()> on_window_changed = nullptr)
+        : pool_size(std::max(pool_size, 1)),
+          on_window_changed(std::move(on_window_changed)) {
+        Components rows;
+        for (int slot = 0; slot < this->pool_size; slot++) {
+            // 没有数据的行槽位不渲染也不可获焦
+            rows.push_back(Maybe(make_row(slot),
+                                 [this, slot] { return is_slot_used(slot); }));
+        }
+
+        auto rows_container = Container::Vertical(rows, &selected_slot);
+
+        // 焦点到达池的边缘时移动窗口，而不是移动焦点
+        auto logic = CatchEvent(rows_container, [this](Event event) {
+            if (item_count == 0)
+                return false;
+
+            if (event == Event::ArrowDown && selected_slot == last_used_slot())
+                return shift_window(1);
+            if (event == Event::ArrowUp && selected_slot == 0)
+                return shift_window(-1);
+            if (event == Event::PageDown)
+                return shift_window(this->pool_size - OVERSCAN);
+            if (event == Event::PageUp)
+                return shift_window(-(this->pool_size - OVERSCAN));
+            return false;
+        });
+
+        component = Renderer(logic, [rows] {
+            Elements elements;
+            for (auto &row : rows)
+                elements.push_back(row->Render());
+            return vbox(std::move(elements)) | yframe | flex;
+        });
+    }
+
+    // 行组件捕获了 this，禁止拷贝
+    VirtualList(const VirtualList &) = delete;
+    VirtualList &operator=(const VirtualList &) = delete;
+
+    Component get_component() { return component; }
+
+    // 重新设置数据总数，窗口回到首行
+    void reset(const int count) {
+        item_count = std::max(count, 0);
+        first_index = 0;
+        selected_slot = 0;
+        if (on_window_changed)
+            on_window_changed();
+    }
+
+    // 更新数据总数并保持当前窗口位置（越界时截断），用于原地刷新数据
+    void set_item_count(const int count) {
+        item_count = std::max(count, 0);
+        first_index =
+            std::clamp(first_index, 0, std::max(0, item_count - pool_size));
+        int last_slot = std::max(0, last_used_slot());
+        selected_slot = std::clamp(selected_slot, 0, last_slot);
+        if (on_window_changed)
+            on_window_changed();
+    }
+
+    // 行槽位对应的数据下标
+    int index_of(const int slot) const { return first_index + slot; }
+
+    int get_pool_size() const { return pool_size; }
+
+    int get_item_count() const { return item_count; }
+
+    // 位置提示，例如 “第 1-8 项 / 共 120 项”
+    std::string position_text() const {
+        if (item_count == 0)
+            return "";
+        int last = std::min(first_index + pool_size, item_count);
+        return "第 " + std::to_string(first_index + 1) + "-" +
+               std::to_string(last) + " 项 / 共 " +
+               std::to_string(item_count) + " 项";
+    }
+};
@@ -1,82 +1,18 @@
 #include "CartPage.h"
 #include "LocationUtils.h"
 #include "SharedComponent.h"
+#include "Trace.h"
 #include <algorithm>
 #include <cctype>
 
 void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
-                           std::function<void()> on_orders_info,
-                           std::function<void()> delete_item_success,
-                           std::function<void()> checkout_success) {
-
-    // 从数据库获得用户购物车列表
-    int user_id = (*(ctx.current_user)).id;
-    ctx.cart_manager.load_cart(user_id);
-    auto *cart_list_ptr =
-        ctx.cart_manager.get_cart_list_ptr().value_or(nullptr);
-
-    // 购物车列表为空，只渲染界面元素
-    if (cart_list_ptr->empty()) {
-
-        // 跳转购物商城页面按钮
-        auto btn_to_shopping = Button("购物商城", on_shopping,
-                                      ButtonOption::Animated(Color::Green));
-
-        // 跳转订单详情页面按钮
-        auto btn_to_orders = Button("订单详情", on_orders_info,
-                                    ButtonOption::Animated(Color::Cyan));
-
-        auto btn_container = Container::Horizontal({
-            btn_to_shopping,
-            btn_to_orders,
-        });
-
-        this->component = Renderer(btn_container, [=] {
-            return vbox(
-                {vbox({
-                     text(" ") | size(HEIGHT, EQUAL, 1),
-                     text(" 购 物 车 ") | bold | center,
-                     text(" —— 心 动 不 如 行 动 —— ") | dim | center |
-                         color(Color::GrayLight),
-                     text(" ") | size(HEIGHT, EQUAL, 1),
-                 }) | borderDouble |
-                     color(Color::YellowLight),
-
-                 text("您的购物车目前为空,  请去商品页看看吧！") | center,
-                 separator(), text("总计: 0 元") | color(Color::Yellow),
-                 hbox({
-                     filler(),
-                     btn_to_shopping->Render() | size(WIDTH, EQUAL, 15),
-                     filler(),
-                     btn_to_orders->Render() | size(WIDTH, EQUAL, 15),
-                     filler(),
-                 }) | size(HEIGHT, EQUAL, 3)});
-        });
-
-        return;
-    }
-
-    // 列表不为空，获取其引用
-    auto &cart_list = *cart_list_ptr;
-
-    // 初始化数据成员
-    delivery_selections = std::vector<int>(cart_list.size(), 0);
-    is_chosen = std::deque<bool>(cart_list.size(), false);
-    quantities = std::vector<int>(cart_list.size(), 0);
-    quantities_str = std::vector<std::string>(cart_list.size(), "0");
-
-    for (int i = 0; i < cart_list.size(); i++) {
-        quantities[i] = cart_list[i].count;
-        quantities_str[i] = std::to_string(cart_list[i].count);
-    }
+                           std::function<void()> on_orders_info) {
 
     // 购物车列表容器
-    auto main_container = Container::Vertical({});
-    // 滚动区域
-    auto scroller = SharedComponents::Scroller(main_container);
+    auto main_container = cart_list.get_component();
 
     // 构建购物车列表
-    rebuild_cart_list_ui(main_container, ctx, cart_list, delete_item_success);
+    reload(ctx);
 
     // --- 定义交互按钮组件 ---
 
@@ -92,8 +28,9 @@ void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
     auto btn_checkout = Button(
         "确认结账",
         [this] {
-            bool all_zero = std::all_of(is_chosen.begin(), is_chosen.end(),
-                                        [](bool x) { return x == false; });
+            bool all_zero =
+                std::none_of(row_states.begin(), row_states.end(),
+                             [](const auto &row) { return row.second.chosen; });
             // 判断用户是否选择了商品
             // 结账逻辑迁移到弹窗确认结束
             if (all_zero)
@@ -104,10 +41,10 @@ void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
         },
         ButtonOption::Animated(Color::Yellow));
 
-    // 按钮组合
+    // 按钮组合（购物车为空时不显示结账按钮）
     auto btn_container = Container::Horizontal({
         btn_to_shopping,
-        btn_checkout,
+        Maybe(btn_checkout, [this] { return !cart_list.empty(); }),
         btn_to_orders,
     });
 
@@ -131,42 +68,26 @@ void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
     auto payment_menu = Menu(&payment_choices, &payment_method, option);
 
     // [Popup 2] 提示支付成功弹窗组件
-    auto btn_hint_payment_success = Button("确定", [&ctx, &cart_list, this,
-                                                    on_shopping, on_orders_info,
-                                                    checkout_success] {
+    // 商品、购物车、订单与历史订单页面由结账产生的变更事件统一刷新
+    auto btn_hint_payment_success = Button("确定", [&ctx, this] {
+        TRACE_SCOPE("ui", "CartPage::payment_success");
         int user_id = (*(ctx.current_user)).id;
 
-        for (int i = 0; i < cart_list.size(); i++) {
-            if (is_chosen[i] == true) {
-
-                int product_id = cart_list[i].product_id;
-                int count = quantities[i];
-                int delivery_selected = delivery_selections[i];
-
-                // 主要是为了加递送选项
-                ctx.cart_manager.update_item(user_id, product_id, count,
-                                             delivery_selections[i]);
-
-                auto p_opt = ctx.product_manager.get_product(product_id);
-                if (p_opt.has_value()) {
-                    auto p = p_opt.value();
-
-                    ctx.product_manager.update_product(
-                        p.product_name, p.product_id, p.price, p.stock - count);
-                }
-            }
+        // 选中的商品及其数量、递送方式
+        std::vector<CartItem> selected;
+        for (const auto &[product_id, row] : row_states) {
+            if (row.chosen)
+                selected.emplace_back(user_id, product_id, row.quantity,
+                                      CartItemStatus::NOT_ORDERED,
+                                      row.delivery_selection);
         }
 
-        // 添加到订单数据库中
-        auto ordered_cart_lists = ctx.cart_manager.checkout(user_id);
-
-        ctx.order_manager.add_order(user_id, ordered_cart_lists, input_address);
-        // 添加快照到历史订单数据库
-        ctx.history_order_manager.add_history_order(
-            user_id, ctx.product_manager, ordered_cart_lists, input_address);
+        // 扣减库存、生成订单及历史订单快照
+        ctx.store.checkout(user_id, selected, input_address);
 
+        input_address = "";
+        status_text = "";
         show_popup = 0;
-        checkout_success();
     });
 
     // [Popup 3] 提示未选择弹窗组件
@@ -303,15 +224,13 @@ void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
         &show_popup);
 
     //  最终渲染
-    this->component = Renderer(logic_container, [=, &cart_list, &ctx] {
+    this->component = Renderer(logic_container, [=, &ctx] {
         // 计算总价
         double total_price = 0.0;
-        for (int i = 0; i < cart_list.size(); i++) {
-            if (is_chosen[i]) {
-                int product_id = cart_list[i].product_id;
-                total_price += ctx.product_manager.get_price_by_id(product_id) *
-                                   quantities[i] +
-                               DELIVERY_PRICES[delivery_selections[i]];
+        for (const auto &[product_id, row] : row_states) {
+            if (row.chosen) {
+                total_price += price_of(ctx.store, product_id) * row.quantity +
+                               DELIVERY_PRICES[row.delivery_selection];
             }
         }
 
@@ -325,15 +244,23 @@ void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
                   }) | borderDouble |
                       color(Color::YellowLight),
 
-                  main_container->Render() | vscroll_indicator | frame | flex,
+                  cart_list.empty()
+                      ? SharedComponents::list_placeholder_element(
+                            cart_model.get_state(),
+                            text("您的购物车目前为空,  请去商品页看看吧！") |
+                                center)
+                      : main_container->Render() | vscroll_indicator | frame |
+                            flex,
                   text("总计: " + Utils::format_price(total_price) + " 元") |
                       color(Color::Yellow),
                   hbox({
                       filler(),
                       btn_to_shopping->Render() | size(WIDTH, EQUAL, 15),
                       filler(),
-                      btn_checkout->Render() | size(WIDTH, EQUAL, 15),
-                      filler(),
+                      cart_list.empty()
+                          ? emptyElement()
+                          : btn_checkout->Render() | size(WIDTH, EQUAL, 15),
+                      cart_list.empty() ? emptyElement() : filler(),
                       btn_to_orders->Render() | size(WIDTH, EQUAL, 15),
                       filler(),
                   }) | size(HEIGHT, EQUAL, 3)});
@@ -347,215 +274,249 @@ void CartLayOut::init_page(AppContext &ctx, std::function<void()> on_shopping,
     });
 }
 
-void CartLayOut::rebuild_cart_list_ui(
-    Component main_container, AppContext &ctx, std::vector<CartItem> &cart_list,
-    std::function<void()> delete_item_success) {
-    main_container->DetachAllChildren();
+void CartLayOut::reload(AppContext &ctx) {
+    int user_id = (*(ctx.current_user)).id;
+
+    cart_model.load(
+        ctx.executor, ctx.post_to_ui,
+        // 工作线程：只读取数据库，数据仓库中已有的商品不再重复读取
+        [&ctx, user_id, known = ctx.store.known_products()] {
+            return ctx.store.fetch_cart(user_id, known);
+        },
+        // UI 线程：写入数据仓库并协调列表
+        [this, &ctx](CartLoad &load) {
+            ctx.store.apply_cart(load);
+
+            std::vector<int> product_ids;
+            for (const auto &item : *ctx.store.cart()) {
+                int product_id = item.product_id;
+
+                // 商品已下架或不存在时不显示
+                if (!ctx.store.find_product(product_id))
+                    continue;
+
+                // 已有的行原地保留用户的勾选与输入（行组件绑定了其地址），
+                // 数据库中的数量变化时才同步
+                auto [it, inserted] = row_states.try_emplace(product_id);
+                CartRowState &row = it->second;
+                if (inserted || row.loaded_count != item.count) {
+                    row.quantity = item.count;
+                    row.quantity_str = std::to_string(item.count);
+                    row.loaded_count = item.count;
+                }
+                product_ids.push_back(product_id);
+            }
+
+            // 移除已不在购物车中的行状态
+            for (auto it = row_states.begin(); it != row_states.end();) {
+                if (std::find(product_ids.begin(), product_ids.end(),
+                              it->first) == product_ids.end())
+                    it = row_states.erase(it);
+                else
+                    ++it;
+            }
+
+            cart_list.reconcile(product_ids,
+                                [this, &ctx](const int &product_id) {
+                                    return make_cart_row(ctx, product_id);
+                                });
+        });
+}
+
+Component CartLayOut::make_cart_row(AppContext &ctx, const int product_id) {
+    const Product *product = ctx.store.find_product(product_id);
+    std::string product_name = product ? product->product_name : "未知商品";
+    // 行状态在 map 中的地址稳定，供组件直接绑定
+    CartRowState &row = row_states[product_id];
 
-    for (int i = 0; i < cart_list.size(); i++) {
+    // 自定义勾选框样式
+    CheckboxOption check_opt;
+    check_opt.transform = [](const EntryState &s) {
+        // 选中：亮绿色；未选中：暗灰色
+        Color c = s.state ? Color::GreenLight : Color::White;
 
-        // 当前商品信息
-        int product_id = cart_list[i].product_id;
+        // 聚焦：青色（高亮）
+        if (s.focused)
+            c = Color::Cyan;
 
-        auto product_opt = ctx.product_manager.get_product(product_id);
-        if (!product_opt.has_value()) {
-            break;
-        }
-        Product product_info =
-            ctx.product_manager.get_product(product_id).value();
-        std::string product_name = product_info.product_name + "";
-
-        // 自定义勾选框样式
-        CheckboxOption check_opt;
-        check_opt.transform = [](const EntryState &s) {
-            // 选中：亮绿色；未选中：暗灰色
-            Color c = s.state ? Color::GreenLight : Color::White;
-
-            // 聚焦：青色（高亮）
-            if (s.focused)
-                c = Color::Cyan;
-
-            // 选中显示对勾，未选中显示空字符
-            std::string symbol = s.state ? "✔" : " ";
-
-            // 构建“大方块”
-            return text(symbol) | bold | center | size(WIDTH, EQUAL, 3) |
-                   size(HEIGHT, EQUAL, 1) | border | color(c);
-        };
-
-        // 勾选框组件，商品名放在后面组装
-        auto select_checkbox = Checkbox("", &(is_chosen[i]), check_opt);
-
-        // 商品数量输入框
-        auto input_qty = Input(&quantities_str[i]);
-
-        // 为输入框添加逻辑：当用户输入时，更新 quantities[i] (int)
-        auto input_qty_logic =
-            CatchEvent(input_qty, [this, i, input_qty](Event event) {
-                // 让 Input 组件先处理字符输入
-                bool handled = input_qty->OnEvent(event);
-
-                // 数据同步逻辑: String -> Int
-                try {
-                    if (quantities_str[i].empty()) {
-                        quantities[i] = 0;
-                    } else {
-                        // 尝试转换，如果输入了非数字（如 abc），stoi
-                        // 会抛出异常
-                        int val = std::stoi(quantities_str[i]);
-                        // 限制负数
-                        if (val < 0) {
-                            val = 0;
-                            quantities_str[i] = "1";
-                        }
-
-                        quantities[i] = val;
+        // 选中显示对勾，未选中显示空字符
+        std::string symbol = s.state ? "✔" : " ";
+
+        // 构建“大方块”
+        return text(symbol) | bold | center | size(WIDTH, EQUAL, 3) |
+               size(HEIGHT, EQUAL, 1) | border | color(c);
+    };
+
+    // 勾选框组件，商品名放在后面组装
+    auto select_checkbox = Checkbox("", &row.chosen, check_opt);
+
+    // 商品数量输入框
+    auto input_qty = Input(&row.quantity_str);
+
+    // 为输入框添加逻辑：当用户输入时，更新 row.quantity (int)
+    auto input_qty_logic =
+        CatchEvent(input_qty, [this, &row, input_qty](Event event) {
+            // 让 Input 组件先处理字符输入
+            bool handled = input_qty->OnEvent(event);
+
+            // 数据同步逻辑: String -> Int
+            try {
+                if (row.quantity_str.empty()) {
+                    row.quantity = 0;
+                } else {
+                    // 尝试转换，如果输入了非数字（如 abc），stoi
+                    // 会抛出异常
+                    int val = std::stoi(row.quantity_str);
+                    // 限制负数
+                    if (val < 0) {
+                        val = 0;
+                        row.quantity_str = "1";
                     }
-                } catch (...) {
-                    show_popup = 5; // 数量格式错误提示弹窗
-                    quantities[i] = 1;
-                    quantities_str[i] = "1";
-                }
-                return handled;
-            });
-
-        // 选择购物车商品购买数量的按钮
-        // "+" 按钮逻辑：同时更新 int 和 string
-        auto btn_inc = Button(
-            "+",
-            [this, i] {
-                quantities[i]++;
-                quantities_str[i] =
-                    std::to_string(quantities[i]); // 同步 string
-            },
-            ButtonOption::Ascii());
-
-        // "-" 按钮逻辑：同时更新 int 和 string
-        auto btn_dec = Button(
-            "-",
-            [this, i] {
-                if (quantities[i] > 1) {
-                    quantities[i]--;
-                    quantities_str[i] =
-                        std::to_string(quantities[i]); // 同步 string
+
+                    row.quantity = val;
                 }
-            },
-            ButtonOption::Ascii());
-
-        // 递送菜单的样式
-
-        MenuOption menu_option = MenuOption::Horizontal();
-        menu_option.entries_option.transform = [&](const EntryState &state) {
-            return text(state.label) | (state.active ? color(Color::Cyan) | bold
-                                                     : color(Color::GrayDark));
-        };
-
-        // 递送菜单组件
-        auto delivery_menu =
-            Menu(&delivery_choices, &delivery_selections[i], menu_option);
-
-        // 删除按钮
-        auto btn_delete = Button(
-            " × 删除 ",
-            [this, &ctx, i, &cart_list, delete_item_success] {
-                CartItem &item = cart_list[i];
-                ctx.cart_manager.delete_item(item.id, item.product_id);
-                delete_item_success();
-            },
-            ButtonOption::Ascii());
-
-        // 布局逻辑
-        auto card_logic_layout = Container::Horizontal(
-            {select_checkbox,
-             Container::Vertical(
-                 {Container::Horizontal({btn_dec, input_qty_logic, btn_inc}),
-                  delivery_menu}),
-             btn_delete});
-
-        auto card_renderer = Renderer(card_logic_layout, [=, &cart_list, &ctx] {
-            CartItem &p = (cart_list)[i];
-            int qty = (quantities)[i];
-            double unit_price =
-                ctx.product_manager.get_price_by_id(p.product_id);
-            double total_item_price =
-                unit_price * qty + DELIVERY_PRICES[delivery_selections[i]];
-
-            // 焦点状态
-
-            // 整个卡片获焦
-            bool is_focused = card_logic_layout->Focused();
-            // Input 获焦时的状态
-            bool input_focused = input_qty->Focused();
-
-            // 获取时是否被勾选
-            bool selected = is_chosen[i];
-
-            // 颜色策略
-            Color border_color = is_focused
-                                     ? static_cast<Color>(Color::Cyan)
-                                     : static_cast<Color>(Color::GrayDark);
-            auto bg_color =
-                is_focused
-                    ? static_cast<Color>(Color::Grey23)
-                    : static_cast<Color>(Color::Default); // 聚焦时背景稍微变亮
-            Color qty_c = qty > 0 ? Color::GreenLight : Color::GrayLight;
-
-            // 左侧的勾选区域
-            auto left_part =
-                vbox({
-                    filler(),
-                    text("选择框") | center | color(Color::Green),
-                    select_checkbox->Render() | center,
-                    filler(),
-                }) |
-                size(WIDTH, EQUAL, 6) |
-                bgcolor(selected ? static_cast<Color>(Color::Green4)
-                                 : static_cast<Color>(Color::Default));
-
-            // 右侧：详细信息
-            auto right_part =
-                vbox(
-                    {// 第一行：商品名 + 价格
-                     hbox({text(product_name) | bold |
-                               size(WIDTH, GREATER_THAN, 15) |
-                               color(Color::Blue),
-                           filler(),
-                           text(Utils::format_price(total_item_price) + " 元") |
-                               color(Color::Gold1) | bold}),
-                     separator() | color(Color::GrayDark), // 弱化的分割线
-
-                     // 第二行：操作区
-                     hbox({// 数量控制
-                           hbox({text("数量: ") | vcenter,
-                                 btn_dec->Render() | vcenter,
-                                 input_qty->Render() | color(qty_c) | center |
-                                     size(WIDTH, EQUAL, 6),
-                                 btn_inc->Render() | vcenter}) |
-                               borderRounded |
-                               color(Color::GrayLight), // 给数量加个小圆框
-
-                           filler(),
-
-                           // 递送方式
-                           vbox({text("配送:") | size(HEIGHT, EQUAL, 1) |
-                                     color(Color::GrayLight),
-                                 delivery_menu->Render()}),
-
-                           filler(),
-
-                           // 删除按钮 (红色)
-                           btn_delete->Render() | color(Color::RedLight)})}) |
-                flex; // padding
-
-            // 组合卡片
-            return hbox({left_part, separator(), right_part | flex}) |
-                   borderRounded | color(border_color) | bgcolor(bg_color);
+            } catch (...) {
+                show_popup = 5; // 数量格式错误提示弹窗
+                row.quantity = 1;
+                row.quantity_str = "1";
+            }
+            return handled;
         });
 
-        // 为了能够滚轮能在卡片及按钮间滚动
-        auto card_renderer_with_event = CatchEvent(card_renderer, [&](Event e) {
-            return false; // 事件未被处理，继续传递给内部组件
-        });
-        main_container->Add(card_renderer_with_event);
-    }
+    // 选择购物车商品购买数量的按钮
+    // "+" 按钮逻辑：同时更新 int 和 string
+    auto btn_inc = Button(
+        "+",
+        [&row] {
+            row.quantity++;
+            row.quantity_str =
+                std::to_string(row.quantity); // 同步 string
+        },
+        ButtonOption::Ascii());
+
+    // "-" 按钮逻辑：同时更新 int 和 string
+    auto btn_dec = Button(
+        "-",
+        [&row] {
+            if (row.quantity > 1) {
+                row.quantity--;
+                row.quantity_str =
+                    std::to_string(row.quantity); // 同步 string
+            }
+        },
+        ButtonOption::Ascii());
+
+    // 递送菜单的样式
+
+    MenuOption menu_option = MenuOption::Horizontal();
+    menu_option.entries_option.transform = [&](const EntryState &state) {
+        return text(state.label) | (state.active ? color(Color::Cyan) | bold
+                                                 : color(Color::GrayDark));
+    };
+
+    // 递送菜单组件
+    auto delivery_menu =
+        Menu(&delivery_choices, &row.delivery_selection, menu_option);
+
+    // 删除按钮
+    auto btn_delete = Button(
+        " × 删除 ",
+        [&ctx, product_id] {
+            TRACE_SCOPE("ui", "CartPage::delete_item");
+            ctx.store.remove_from_cart((*(ctx.current_user)).id,
+                                       product_id);
+        },
+        ButtonOption::Ascii());
+
+    // 布局逻辑
+    auto card_logic_layout = Container::Horizontal(
+        {select_checkbox,
+         Container::Vertical(
+             {Container::Horizontal({btn_dec, input_qty_logic, btn_inc}),
+              delivery_menu}),
+         btn_delete});
+
+    auto card_renderer = Renderer(card_logic_layout, [=, &row, &ctx] {
+        int qty = row.quantity;
+        double unit_price = price_of(ctx.store, product_id);
+        double total_item_price =
+            unit_price * qty + DELIVERY_PRICES[row.delivery_selection];
+
+        // 焦点状态
+
+        // 整个卡片获焦
+        bool is_focused = card_logic_layout->Focused();
+        // Input 获焦时的状态
+        bool input_focused = input_qty->Focused();
+
+        // 获取时是否被勾选
+        bool selected = row.chosen;
+
+        // 颜色策略
+        Color border_color = is_focused
+                                 ? static_cast<Color>(Color::Cyan)
+                                 : static_cast<Color>(Color::GrayDark);
+        auto bg_color =
+            is_focused
+                ? static_cast<Color>(Color::Grey23)
+                : static_cast<Color>(Color::Default); // 聚焦时背景稍微变亮
+        Color qty_c = qty > 0 ? Color::GreenLight : Color::GrayLight;
+
+        // 左侧的勾选区域
+        auto left_part =
+            vbox({
+                filler(),
+                text("选择框") | center | color(Color::Green),
+                select_checkbox->Render() | center,
+                filler(),
+            }) |
+            size(WIDTH, EQUAL, 6) |
+            bgcolor(selected ? static_cast<Color>(Color::Green4)
+                             : static_cast<Color>(Color::Default));
+
+        // 右侧：详细信息
+        auto right_part =
+            vbox(
+                {// 第一行：商品名 + 价格
+                 hbox({text(product_name) | bold |
+                           size(WIDTH, GREATER_THAN, 15) |
+                           color(Color::Blue),
+                       filler(),
+                       text(Utils::format_price(total_item_price) + " 元") |
+                           color(Color::Gold1) | bold}),
+                 separator() | color(Color::GrayDark), // 弱化的分割线
+
+                 // 第二行：操作区
+                 hbox({// 数量控制
+                       hbox({text("数量: ") | vcenter,
+                             btn_dec->Render() | vcenter,
+                             input_qty->Render() | color(qty_c) | center |
+                                 size(WIDTH, EQUAL, 6),
+                             btn_inc->Render() | vcenter}) |
+                           borderRounded |
+                           color(Color::GrayLight), // 给数量加个小圆框
+
+                       filler(),
+
+                       // 递送方式
+                       vbox({text("配送:") | size(HEIGHT, EQUAL, 1) |
+                                 color(Color::GrayLight),
+                             delivery_menu->Render()}),
+
+                       filler(),
+
+                       // 删除按钮 (红色)
+                       btn_delete->Render() | color(Color::RedLight)})}) |
+            flex; // padding
+
+        // 组合卡片
+        return hbox({left_part, separator(), right_part | flex}) |
+               borderRounded | color(border_color) | bgcolor(bg_color);
+    });
+
+    // 为了能够滚轮能在卡片及按钮间滚动
+    auto card_renderer_with_event = CatchEvent(card_renderer, [&](Event e) {
+        return false; // 事件未被处理，继续传递给内部组件
+    });
+    return card_renderer_with_event;
 }
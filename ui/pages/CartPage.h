@@ -1,9 +1,11 @@
 #include "AppContext.h"
-#include <deque>
+#include "AsyncPageModel.h"
+#include "KeyedList.h"
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <functional>
+#include <map>
 #include <memory.h>
 
 using namespace ftxui;
@@ -12,17 +14,29 @@ class CartLayOut {
   private:
     Component component;
 
-    // 选择送达时间(默认特快送达)
-    std::vector<int> delivery_selections;
+    // 购物车中一行商品的界面状态
+    struct CartRowState {
+        bool chosen = false;            // 是否选中
+        int quantity = 0;               // 购买数量
+        std::string quantity_str = "0"; // 数量输入框的文本内容
+        int delivery_selection = 0;     // 选择的递送方式
+        int loaded_count = 0;           // 上次从数据库读到的数量
+    };
+
+    // 商品 ID -> 行状态，列表刷新后仍保留用户的勾选与输入
+    std::map<int, CartRowState> row_states;
 
-    // 商品购买数量
-    std::vector<int> quantities;
+    // 购物车列表（按商品 ID 协调行组件）
+    KeyedList<int> cart_list;
 
-    // 存储数量输入框的文本内容 (UI显示/输入用)
-    std::vector<std::string> quantities_str;
+    // 购物车的后台加载（结果写入 ctx.store）
+    AsyncPageModel<CartLoad> cart_model;
 
-    // 是否选中商品, 1 代表选中而 0 代表未选中
-    std::deque<bool> is_chosen;
+    // 从数据仓库获取商品单价，未找到返回 0
+    static double price_of(const DataStore &store, const int product_id) {
+        const Product *p = store.find_product(product_id);
+        return p ? p->price : 0.0;
+    }
 
     // 存储用户的收货地址
     std::string input_address;
@@ -51,41 +65,20 @@ class CartLayOut {
 
     // 包含渲染页面的主逻辑
     void init_page(AppContext &ctx, std::function<void()> on_shopping,
-                   std::function<void()> on_orders_info,
-                   std::function<void()> delete_item_success,
-                   std::function<void()> checkout_success);
+                   std::function<void()> on_orders_info);
 
   public:
     // 构造器：创建商城页面组件，并通过接受购买函数跳转商城页面
     CartLayOut(AppContext &ctx, std::function<void()> on_shopping,
-               std::function<void()> on_orders_info,
-               std::function<void()> delete_item_success,
-               std::function<void()> checkout_success) {
-        init_page(ctx, on_shopping, on_orders_info, delete_item_success,
-                  checkout_success);
+               std::function<void()> on_orders_info) {
+        init_page(ctx, on_shopping, on_orders_info);
     }
 
     Component get_component() { return component; }
 
-    // 重建 UI 列表
-    void rebuild_cart_list_ui(Component main_container, AppContext &ctx,
-                              std::vector<CartItem> &cart_list,
-                              std::function<void()> delete_item_success);
-
-    void refresh(AppContext &ctx, std::function<void()> on_shopping,
-                 std::function<void()> on_orders_info,
-                 std::function<void()> delete_item_success,
-                 std::function<void()> checkout_success) {
-
-        // 先清空容器，并重置 vector 类成员
-        component->DetachAllChildren();
-        delivery_selections.clear();
-        quantities.clear();
-        is_chosen.clear();
-        input_address = "";
-        status_text = "";
-
-        init_page(ctx, on_shopping, on_orders_info, delete_item_success,
-                  checkout_success);
-    }
+    // 创建单个商品卡片
+    Component make_cart_row(AppContext &ctx, const int product_id);
+
+    // 在后台重新加载购物车，返回后只增删变化的商品卡片，保留勾选、数量与焦点
+    void reload(AppContext &ctx);
 };
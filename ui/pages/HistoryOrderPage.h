@@ -1,6 +1,8 @@
 #pragma once
 
 #include "AppContext.h"
+#include "AsyncPageModel.h"
+#include "KeyedList.h"
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
@@ -23,31 +25,28 @@ class HistoryOrderLayOut {
 
     const std::vector<int> delivery_required_time = {5, 3, 1};
 
+    // 历史订单列表（按订单 ID 协调行组件）
+    KeyedList<long long> order_list;
+
+    // 历史订单的后台加载（结果写入 ctx.store）
+    AsyncPageModel<HistoryTable> history_model;
+
   public:
     // 构造器：创建历史订单页面组件
     HistoryOrderLayOut(AppContext &ctx, std::function<void()> on_orders_info,
-                       std::function<void()> on_shopping,
-                       std::function<void()> refresh_history_order_page) {
+                       std::function<void()> on_shopping) {
 
-        init_page(ctx, on_orders_info, on_shopping, refresh_history_order_page);
+        init_page(ctx, on_orders_info, on_shopping);
     }
 
     Component get_component() { return component; }
 
     void init_page(AppContext &ctx, std::function<void()> on_orders_info,
-                   std::function<void()> on_shopping,
-                   std::function<void()> refresh_history_order_page);
+                   std::function<void()> on_shopping);
 
-    void rebuild_history_order_list_ui(
-        AppContext &ctx, Component main_container,
-        std::map<long long, HistoryFullOrder> *histroy_orders_map_ptr);
+    // 创建单个历史订单卡片（内容在渲染时按订单 ID 读取）
+    Component make_history_order_row(AppContext &ctx, const long long order_id);
 
-    void refresh(AppContext &ctx, std::function<void()> on_orders_info,
-                 std::function<void()> on_shopping,
-                 std::function<void()> refresh_history_order_page) {
-        show_popup = 0;
-        component->DetachAllChildren();
-
-        init_page(ctx, on_orders_info, on_shopping, refresh_history_order_page);
-    }
+    // 在后台重新加载历史订单，返回后只增删变化的订单卡片，保留焦点与滚动位置
+    void reload(AppContext &ctx);
 };
@@ -1,5 +1,6 @@
 #include "LoginPage.h"
 #include "SharedComponent.h"
+#include "Trace.h"
 
 LoginLayOut::LoginLayOut(AppContext &ctx, std::function<void()> onLoginSuccess,
                          std::function<void()> on_register) {
@@ -13,6 +14,7 @@ LoginLayOut::LoginLayOut(AppContext &ctx, std::function<void()> onLoginSuccess,
 
     // 登录按钮
     Component btn_login = Button("登录", [&ctx, this, onLoginSuccess] {
+        TRACE_SCOPE("ui", "LoginPage::login");
         if (ctx.user_manager.check_login(*username, *password) ==
             Result::SUCCESS) {
             *message = "";
@@ -1,69 +1,13 @@
 #include "OrderPage.h"
 #include "LocationUtils.h"
 #include "SharedComponent.h"
+#include "Trace.h"
 #include "Utils.h"
 #include <optional>
 
 void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
                             std::function<void()> on_shopping,
-                            std::function<void()> on_history_orders_info,
-                            std::function<void()> on_orders_update,
-                            std::function<void()> on_orders_delete) {
-
-    // 加载数据
-    int user_id = (*(ctx.current_user)).id;
-    ctx.order_manager.load_full_orders(user_id, ctx.product_manager);
-
-    auto *orders_map_ptr =
-        ctx.order_manager.get_orders_map_ptr().value_or(nullptr);
-
-    // 没有订单渲染界面
-    if (orders_map_ptr->empty()) {
-
-        // 底部导航按钮
-        auto btn_to_shopping = Button("购物商城", on_shopping,
-                                      ButtonOption::Animated(Color::Green));
-        auto btn_to_cart = Button("返回购物车", on_checkout,
-                                  ButtonOption::Animated(Color::Cyan));
-        auto btn_to_history = Button("历史订单", on_history_orders_info,
-                                     ButtonOption::Animated(Color::Yellow));
-
-        auto btn_container = Container::Horizontal(
-            {btn_to_cart, btn_to_shopping, btn_to_history});
-
-        this->component = Renderer(btn_container, [=] {
-            return vbox(
-                {// 标题栏
-                 vbox({
-                     text(" ") | size(HEIGHT, EQUAL, 1),
-                     text(" 当 前 订 单 ") | bold | center,
-                     text(" —— 正 在 快 马 加 鞭 为 您 送 达 —— ") | dim |
-                         center | color(Color::GrayLight),
-                     text(" ") | size(HEIGHT, EQUAL, 1),
-                 }) | borderDouble |
-                     color(Color::GreenLight),
-
-                 separatorHeavy(),
-
-                 vbox({text(""), text("目前没有正在进行的订单") | center,
-                       text("去商城逛逛吧！") | center}) |
-                     color(Color::GrayLight),
-
-                 separator(),
-
-                 hbox({
-                     filler(),
-                     btn_to_cart->Render() | size(WIDTH, EQUAL, 15),
-                     filler(),
-                     btn_to_shopping->Render() | size(WIDTH, EQUAL, 15),
-                     filler(),
-                     btn_to_history->Render() | size(WIDTH, EQUAL, 15),
-                     filler(),
-                 }) | size(HEIGHT, EQUAL, 3)});
-        });
-
-        return;
-    }
+                            std::function<void()> on_history_orders_info) {
 
     // --- 底部导航按钮 ---
     auto btn_to_shopping =
@@ -110,17 +54,15 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
         }).detach();
     });
 
-    auto btn_addr_confirm = Button("确认修改", [this, &ctx, on_orders_update] {
+    auto btn_addr_confirm = Button("确认修改", [this, &ctx] {
+        TRACE_SCOPE("ui", "OrderPage::update_address");
         if (new_address.empty() || new_address.length() > 50) {
             status_text = "地址为空或超过50个字符限制";
             return;
         }
-        // 调用 OrderManager 更新地址
-        ctx.order_manager.update_order_info(temp_selected_order_id, new_address,
-                                            -1); // -1 表示不改配送
-        // 同样调用 HistoryManager 同步更新
-        ctx.history_order_manager.update_history_order_info(
-            temp_selected_order_id, new_address, -1);
+        // 更新订单地址，历史订单同步更新
+        ctx.store.update_order_info(temp_selected_order_id, new_address,
+                                    -1); // -1 表示不改配送
 
         status_text = "修改成功";
         show_popup = 3;
@@ -128,10 +70,8 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     auto btn_addr_back = Button("取消", [this] { show_popup = 0; });
 
     // [Popup 3] 修改地址成功组件
-    auto btn_address_success_ok = Button("确定", [this, on_orders_update] {
-        show_popup = 0;
-        on_orders_update(); // 关闭弹窗时彻底刷新页面
-    });
+    // 订单列表由修改产生的变更事件（ORDER_CHANGED）刷新
+    auto btn_address_success_ok = Button("确定", [this] { show_popup = 0; });
 
     // [Popup 4] 配送服务选择组件
     MenuOption menu_opt;
@@ -143,12 +83,10 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
         Menu(&delivery_choices, &temp_selected_delivery_idx, menu_opt);
 
     auto btn_delivery_confirm = Button("确认修改", [this, &ctx] {
-        // 订单更新配送
-        ctx.order_manager.update_order_info(temp_selected_order_id, "",
-                                            temp_selected_delivery_idx);
-        // 历史订单更新配送
-        ctx.history_order_manager.update_history_order_info(
-            temp_selected_order_id, "", temp_selected_delivery_idx);
+        TRACE_SCOPE("ui", "OrderPage::update_delivery");
+        // 更新订单配送方式，历史订单同步更新
+        ctx.store.update_order_info(temp_selected_order_id, "",
+                                    temp_selected_delivery_idx);
 
         status_text = "配送方式已更新";
         show_popup = 5;
@@ -156,22 +94,16 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     auto btn_delivery_back = Button("取消", [this] { show_popup = 0; });
 
     // [Popup 5] 修改送达选项成功组件
-    auto btn_delivery_success_ok = Button("确定", [this, on_orders_update] {
-        show_popup = 0;
-        on_orders_update(); // 关闭弹窗时彻底刷新页面
-    });
+    auto btn_delivery_success_ok = Button("确定", [this] { show_popup = 0; });
 
     // [Popup 6] 取消订单确认组件
-    auto btn_cancel_yes = Button("确定取消", [this, &ctx, on_orders_delete] {
-        // 更新订单状态
-        ctx.order_manager.cancel_order(temp_selected_order_id,
-                                       ctx.product_manager);
-        // 更新历史订单状态
-        ctx.history_order_manager.cancel_history_order(temp_selected_order_id,
-                                                       ctx.product_manager);
+    // 取消订单会恢复库存，商品、订单与历史订单页面由变更事件统一刷新
+    auto btn_cancel_yes = Button("确定取消", [this, &ctx] {
+        TRACE_SCOPE("ui", "OrderPage::cancel_order");
+        // 更新订单与历史订单状态
+        ctx.store.cancel_order(temp_selected_order_id);
 
         show_popup = 0;
-        on_orders_delete(); // 刷新页面
     });
     auto btn_cancel_no = Button("再想想", [this] { show_popup = 0; });
 
@@ -258,13 +190,12 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
         btn_delivery_success_ok, popup_update_delivery_renderer_success_layout);
 
     // 主容器
-    auto main_container = Container::Vertical({});
+    auto main_container = order_list.get_component();
     // 支持滚动
     auto scroller = SharedComponents::Scroller(main_container);
 
-    // 重建订单列表
-    rebuild_order_list_ui(ctx, main_container, orders_map_ptr, on_orders_update,
-                          on_orders_delete);
+    // 加载订单列表
+    reload(ctx);
 
     auto main_logic_content = Container::Vertical({scroller, btn_container});
 
@@ -298,7 +229,16 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
                   }) | borderDouble |
                       color(Color::YellowLight),
 
-                  scroller->Render() | flex, separatorHeavy(),
+                  order_list.empty()
+                      ? SharedComponents::list_placeholder_element(
+                            order_model.get_state(),
+                            vbox({text(""),
+                                  text("目前没有正在进行的订单") | center,
+                                  text("去商城逛逛吧！") | center}) |
+                                color(Color::GrayLight)) |
+                            flex
+                      : scroller->Render() | flex,
+                  separatorHeavy(),
 
                   hbox({
                       filler(),
@@ -320,160 +260,167 @@ void OrderLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     });
 }
 
-// 重建 UI 列表
-void OrderLayOut::rebuild_order_list_ui(
-    AppContext &ctx, Component main_container,
-    std::map<long long, FullOrder> *orders_map_ptr,
-    std::function<void()> on_orders_update,
-    std::function<void()> on_orders_delete) {
-    main_container->DetachAllChildren();
-
-    for (auto it = orders_map_ptr->rbegin(); it != orders_map_ptr->rend();
-         ++it) {
-        long long order_id = it->first;
-        FullOrder &full_order = it->second;
-
-        // 过滤：只显示未完成的订单
-        if (full_order.status != FullOrderStatus::NOT_COMPLETED) {
-            continue;
-        }
+void OrderLayOut::reload(AppContext &ctx) {
+    int user_id = (*(ctx.current_user)).id;
 
-        // 修改按钮组件
-        auto btn_modify = Button(
-            " ✎ 修改订单 ",
-            [this, order_id, &ctx] {
-                auto *map_ptr =
-                    ctx.order_manager.get_orders_map_ptr().value_or(nullptr);
-                if (map_ptr && map_ptr->count(order_id)) {
-                    FullOrder &current_order = map_ptr->at(order_id);
-
-                    // 安全地复制数据
-                    new_address = current_order.address + "";
-
-                    temp_selected_order_id = order_id;
-                    int current_sel =
-                        current_order.items.empty()
-                            ? 0
-                            : current_order.items[0].delivery_selection;
-                    temp_selected_delivery_idx = current_sel;
-
-                    show_popup = 1; // 打开选择弹窗
-                }
-            },
-            ButtonOption::Ascii());
-
-        // 删除按钮组件
-        auto btn_cancel_order = Button(
-            " × 取消订单 ",
-            [this, order_id] {
-                temp_selected_order_id = order_id;
-                show_popup = 6; // 打开取消确认弹窗
-            },
-            ButtonOption::Ascii());
-
-        // 每个订单卡片的组件逻辑
-        auto card_controls =
-            Container::Horizontal({btn_modify, btn_cancel_order});
-
-        auto item_renderer = Renderer(card_controls, [&ctx, this, order_id,
-                                                      btn_modify,
-                                                      btn_cancel_order] {
-            // 重新获取数据指针
-            auto *map_ptr =
-                ctx.order_manager.get_orders_map_ptr().value_or(nullptr);
-
-            // 如果数据源没了，或者订单ID找不到了，就渲染个空的或错误提示
-            if (!map_ptr || map_ptr->find(order_id) == map_ptr->end()) {
-                return text("数据已更新，请刷新") | color(Color::Red);
+    order_model.load(
+        ctx.executor, ctx.post_to_ui,
+        // 工作线程：只读取数据库，预先读取数据仓库中没有的商品，渲染时不再查询
+        [&ctx, user_id, known = ctx.store.known_products()] {
+            return ctx.store.fetch_orders(user_id, known);
+        },
+        // UI 线程：写入数据仓库并协调列表
+        [this, &ctx](OrderLoad &load) {
+            ctx.store.apply_orders(load);
+
+            // 只显示未完成的订单，新订单在前
+            const OrderTable &orders = *ctx.store.orders();
+            std::vector<long long> order_ids;
+            for (auto it = orders.rbegin(); it != orders.rend(); ++it) {
+                if (it->second.status == FullOrderStatus::NOT_COMPLETED)
+                    order_ids.push_back(it->first);
             }
 
-            // 获取当前有效的引用
-            FullOrder &full_order = map_ptr->at(order_id);
-
-            // 计算数据
-            double total_price = full_order.total_price;
-            int del_idx = (!full_order.items.empty())
-                              ? full_order.items[0].delivery_selection
-                              : 0;
-            if (del_idx < 0)
-                del_idx = 0;
-
-            std::string del_name = delivery_choices[del_idx];
-            del_name = del_name.substr(0, del_name.find('('));
-
-            time_t arrival_t = Utils::add_days_to_time(
-                full_order.order_time, delivery_required_time[del_idx]);
-
-            auto format_arrival_t = Utils::specific_hour_to_string(arrival_t);
-
-            Elements rows;
-            // 信息头
-            rows.push_back(
-                hbox({text(" 订单号: " + std::to_string(order_id)) | bold,
-                      text("    "), text("下单时间: "),
-                      text(Utils::time_to_string(full_order.order_time)) |
-                          color(Color::Green),
-                      filler(), text("预计抵达时间: "),
-                      text(format_arrival_t) | color(Color::Green)}));
-            rows.push_back(separator());
-
-            // 订单卡片
-            for (const auto &item : full_order.items) {
-                auto prod = ctx.product_manager.get_product(item.product_id);
-                std::string p_name =
-                    prod.has_value() ? prod->product_name + "" : "未知商品";
-                double p_price = prod.has_value() ? prod->price : 0.0;
-
-                rows.push_back(hbox(
-                    {text(" 商品名: "),
-                     text(p_name) | color(Color::Blue) |
-                         size(WIDTH, GREATER_THAN, 10) |
-                         color(Color::BlueLight),
-                     filler(),
-                     text("数量: x " + std::to_string(item.count) + " "),
-                     filler(),
-                     text("￥" + Utils::format_price(p_price * item.count)) |
-                         color(Color::BlueLight)}));
+            order_list.reconcile(order_ids,
+                                 [this, &ctx](const long long &order_id) {
+                                     return make_order_row(ctx, order_id);
+                                 });
+        });
+}
+
+Component OrderLayOut::make_order_row(AppContext &ctx,
+                                      const long long order_id) {
+    // 修改按钮组件
+    auto btn_modify = Button(
+        " ✎ 修改订单 ",
+        [this, order_id, &ctx] {
+            const OrderTable &orders = *ctx.store.orders();
+            if (orders.count(order_id)) {
+                const FullOrder &current_order = orders.at(order_id);
+
+                // 安全地复制数据
+                new_address = current_order.address + "";
+
+                temp_selected_order_id = order_id;
+                int current_sel =
+                    current_order.items.empty()
+                        ? 0
+                        : current_order.items[0].delivery_selection;
+                temp_selected_delivery_idx = current_sel;
+
+                show_popup = 1; // 打开选择弹窗
             }
-            rows.push_back(separator());
+        },
+        ButtonOption::Ascii());
+
+    // 删除按钮组件
+    auto btn_cancel_order = Button(
+        " × 取消订单 ",
+        [this, order_id] {
+            temp_selected_order_id = order_id;
+            show_popup = 6; // 打开取消确认弹窗
+        },
+        ButtonOption::Ascii());
+
+    // 每个订单卡片的组件逻辑
+    auto card_controls =
+        Container::Horizontal({btn_modify, btn_cancel_order});
+
+    auto item_renderer = Renderer(card_controls, [&ctx, this, order_id,
+                                                  btn_modify,
+                                                  btn_cancel_order] {
+        // 持有当前快照，渲染期间数据不会被替换
+        auto orders = ctx.store.orders().data;
+
+        // 如果订单ID找不到了，就渲染个错误提示
+        if (orders->find(order_id) == orders->end()) {
+            return text("数据已更新，请刷新") | color(Color::Red);
+        }
+
+        const FullOrder &full_order = orders->at(order_id);
+
+        // 计算数据
+        double total_price = full_order.total_price;
+        int del_idx = (!full_order.items.empty())
+                          ? full_order.items[0].delivery_selection
+                          : 0;
+        if (del_idx < 0)
+            del_idx = 0;
+
+        std::string del_name = delivery_choices[del_idx];
+        del_name = del_name.substr(0, del_name.find('('));
+
+        time_t arrival_t = Utils::add_days_to_time(
+            full_order.order_time, delivery_required_time[del_idx]);
+
+        auto format_arrival_t = Utils::specific_hour_to_string(arrival_t);
+
+        Elements rows;
+        // 信息头
+        rows.push_back(
+            hbox({text(" 订单号: " + std::to_string(order_id)) | bold,
+                  text("    "), text("下单时间: "),
+                  text(Utils::time_to_string(full_order.order_time)) |
+                      color(Color::Green),
+                  filler(), text("预计抵达时间: "),
+                  text(format_arrival_t) | color(Color::Green)}));
+        rows.push_back(separator());
+
+        // 订单卡片
+        for (const auto &item : full_order.items) {
+            const Product *prod = ctx.store.find_product(item.product_id);
+            std::string p_name = prod ? prod->product_name + "" : "未知商品";
+            double p_price = prod ? prod->price : 0.0;
 
-            // 地址和运费
             rows.push_back(hbox(
-                {text(" 配送方式: "), text(del_name) | color(Color::Cyan),
-                 filler(), text("运费: "),
-                 text("￥" + Utils::format_price(DELIVERY_PRICES[del_idx])) |
-                     color(Color::Blue)}));
-            rows.push_back(
-                hbox({text(" 送达地址: "),
-                      text(std::string(full_order.address)) |
-                          color(Color::Cyan) | size(WIDTH, GREATER_THAN, 20)}));
-
-            // 底部总价格
-            rows.push_back(separator());
-            rows.push_back(
-                hbox({filler(), text("合计: ") | bold,
-                      text(Utils::format_price(total_price) + " 元") |
-                          color(Color::Yellow) | bold}));
-
-            // 按钮区域
-            rows.push_back(
-                hbox({filler(), btn_modify->Render() | color(Color::Yellow),
-                      text("       "),
-                      btn_cancel_order->Render() | color(Color::RedLight),
-                      filler()}));
-
-            // 样式包装
-
-            bool is_focused = btn_modify->Focused() || btn_cancel_order;
-
-            Color border_color = is_focused ? Color::Cyan : Color::GrayLight;
-            Color bg_color = is_focused ? static_cast<Color>(Color::Grey23)
-                                        : static_cast<Color>(Color::Default);
-
-            return vbox(rows) | borderRounded | color(border_color) |
-                   bgcolor(bg_color);
-        });
+                {text(" 商品名: "),
+                 text(p_name) | color(Color::Blue) |
+                     size(WIDTH, GREATER_THAN, 10) |
+                     color(Color::BlueLight),
+                 filler(),
+                 text("数量: x " + std::to_string(item.count) + " "),
+                 filler(),
+                 text("￥" + Utils::format_price(p_price * item.count)) |
+                     color(Color::BlueLight)}));
+        }
+        rows.push_back(separator());
+
+        // 地址和运费
+        rows.push_back(hbox(
+            {text(" 配送方式: "), text(del_name) | color(Color::Cyan),
+             filler(), text("运费: "),
+             text("￥" + Utils::format_price(DELIVERY_PRICES[del_idx])) |
+                 color(Color::Blue)}));
+        rows.push_back(
+            hbox({text(" 送达地址: "),
+                  text(std::string(full_order.address)) |
+                      color(Color::Cyan) | size(WIDTH, GREATER_THAN, 20)}));
+
+        // 底部总价格
+        rows.push_back(separator());
+        rows.push_back(
+            hbox({filler(), text("合计: ") | bold,
+                  text(Utils::format_price(total_price) + " 元") |
+                      color(Color::Yellow) | bold}));
+
+        // 按钮区域
+        rows.push_back(
+            hbox({filler(), btn_modify->Render() | color(Color::Yellow),
+                  text("       "),
+                  btn_cancel_order->Render() | color(Color::RedLight),
+                  filler()}));
+
+        // 样式包装
+
+        bool is_focused = btn_modify->Focused() || btn_cancel_order;
+
+        Color border_color = is_focused ? Color::Cyan : Color::GrayLight;
+        Color bg_color = is_focused ? static_cast<Color>(Color::Grey23)
+                                    : static_cast<Color>(Color::Default);
+
+        return vbox(rows) | borderRounded | color(border_color) |
+               bgcolor(bg_color);
+    });
 
-        main_container->Add(item_renderer);
-    }
+    return item_renderer;
 }
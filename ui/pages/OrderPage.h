@@ -1,4 +1,6 @@
 #include "AppContext.h"
+#include "AsyncPageModel.h"
+#include "KeyedList.h"
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
@@ -36,44 +38,30 @@ class OrderLayOut {
 
     const std::vector<int> delivery_required_time = {5, 3, 1};
 
+    // 当前订单列表（按订单 ID 协调行组件）
+    KeyedList<long long> order_list;
+
+    // 订单的后台加载（结果写入 ctx.store）
+    AsyncPageModel<OrderLoad> order_model;
+
   public:
     // 构造器：创建商城页面组件，并通过接受购买函数跳转商城页面
     OrderLayOut(AppContext &ctx, std::function<void()> on_checkout,
                 std::function<void()> on_shopping,
-                std::function<void()> on_history_orders_info,
-                std::function<void()> on_orders_update,
-                std::function<void()> on_orders_delete) {
+                std::function<void()> on_history_orders_info) {
 
-        init_page(ctx, on_checkout, on_shopping, on_history_orders_info,
-                  on_orders_update, on_orders_delete);
+        init_page(ctx, on_checkout, on_shopping, on_history_orders_info);
     }
 
     Component get_component() { return component; }
 
     void init_page(AppContext &ctx, std::function<void()> on_checkout,
                    std::function<void()> on_shopping,
-                   std::function<void()> on_history_orders_info,
-                   std::function<void()> on_orders_update,
-                   std::function<void()> on_orders_delete);
-
-    // 清空列表
-    void rebuild_order_list_ui(AppContext &ctx, Component main_container,
-                               std::map<long long, FullOrder> *orders_map_ptr,
-                               std::function<void()> on_orders_update,
-                               std::function<void()> on_orders_delete);
-
-    void refresh(AppContext &ctx, std::function<void()> on_checkout,
-                 std::function<void()> on_shopping,
-                 std::function<void()> on_history_orders_info,
-                 std::function<void()> on_orders_update,
-                 std::function<void()> on_orders_delete) {
-        component->DetachAllChildren();
-        new_address = "";
-        status_text = "";
-        temp_selected_order_id = -1;
-        temp_selected_delivery_idx = 0;
-
-        init_page(ctx, on_checkout, on_shopping, on_history_orders_info,
-                  on_orders_update, on_orders_delete);
-    }
+                   std::function<void()> on_history_orders_info);
+
+    // 创建单个订单卡片（内容在渲染时按订单 ID 读取）
+    Component make_order_row(AppContext &ctx, const long long order_id);
+
+    // 在后台重新加载订单，返回后只增删变化的订单卡片，保留焦点与滚动位置
+    void reload(AppContext &ctx);
 };
@@ -1,5 +1,6 @@
 #include "RegisterPage.h"
 #include "SharedComponent.h"
+#include "Trace.h"
 
 RegisterLayOut::RegisterLayOut(AppContext &ctx,
                                std::function<void()> on_register_success,
@@ -20,6 +21,7 @@ RegisterLayOut::RegisterLayOut(AppContext &ctx,
     });
 
     Component btn_register = Button("注册", [&ctx, this, on_register_success] {
+        TRACE_SCOPE("ui", "RegisterPage::register");
         if (ctx.user_manager.check_register(*username, *password,
                                             *again_password,
                                             *message) == Result::SUCCESS) {
@@ -1,39 +1,34 @@
 #include "ShopPage.h"
 #include "SharedComponent.h"
+#include "Trace.h"
 #include <algorithm>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
-void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
-                           std::function<void()> add_cart) {
+void ShopLayOut::init_page(AppContext &ctx,
+                           std::function<void()> on_checkout) {
 
-    // 初始加载：搜索空字符串获取所有未删除商品
-    current_products = ctx.product_manager.search_product("");
-
-    // 存储购物数量容器初始化
-    quantities = std::vector<int>(current_products.size(), 0);
-    quantities_str = std::vector<std::string>(current_products.size(), "0");
+    // 商品列表：只创建能填满终端的行组件，滚动时复用
+    int pool_size = VirtualList::pool_size_for(PRODUCT_ROW_HEIGHT);
+    slot_quantities_str = std::vector<std::string>(pool_size, "0");
+    product_list = std::make_shared<VirtualList>(
+        pool_size, [this](int slot) { return make_product_row(slot); },
+        [this] { sync_slot_quantities(); });
+    auto list_component = product_list->get_component();
 
-    // 定义容器
-    auto main_container = Container::Vertical({});              // 存放商品行
-    auto scroller = SharedComponents::Scroller(main_container); // 滚动区域
+    // 初始加载：搜索空字符串获取所有未删除商品
+    load_products(ctx, false);
 
     // 搜索输入框
     auto search_input = Input(&search_query, "请输入商品名进行搜索...");
 
     // 允许在按下回车时直接触发搜索
     auto search_input_logic =
-        CatchEvent(search_input, [&ctx, this, main_container](Event event) {
+        CatchEvent(search_input, [&ctx, this](Event event) {
             if (event == Event::Return) {
-                // 调用后端搜索接口
-                current_products =
-                    ctx.product_manager.search_product(search_query);
-                // 重置购买数量状态，防止索引错位
-                quantities = std::vector<int>(current_products.size(), 0);
-                // 清空数量输入框内容
-                quantities_str =
-                    std::vector<std::string>(current_products.size(), "0");
-                rebuild_product_list_ui(main_container);
+                // 调用后端搜索接口，返回后重置列表及购买数量
+                load_products(ctx, false);
                 return true; // 消费事件，不传入 Input，防止换行
             }
             return false;
@@ -42,16 +37,9 @@ void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     // 搜索按钮 (触发列表刷新)
     auto btn_search = Button(
         "🔍 搜索",
-        [this, &ctx, main_container] {
-            // 调用后端搜索接口
-            current_products = ctx.product_manager.search_product(search_query);
-            // 重置购买数量状态，防止索引错位
-            quantities = std::vector<int>(current_products.size(), 0);
-            // 清空数量输入框内容
-            quantities_str =
-                std::vector<std::string>(current_products.size(), "0");
-            // 重建 UI 列表
-            rebuild_product_list_ui(main_container);
+        [this, &ctx] {
+            // 调用后端搜索接口，返回后重置列表及购买数量
+            load_products(ctx, false);
         },
         ButtonOption::Animated(Color::Gold1));
 
@@ -62,38 +50,34 @@ void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     // 添加到购物车 按钮
     auto btn_add = Button(
         "加入购物车",
-        [&ctx, this, add_cart] {
-            if (all_of(quantities.begin(), quantities.end(),
-                       [](int x) { return x == 0; })) {
+        [&ctx, this] {
+            TRACE_SCOPE("ui", "ShopPage::add_to_cart");
+            if (quantities.empty()) {
                 show_popup = 1;
                 return;
             } else {
 
-                for (int i = 0; i < current_products.size(); i++) {
-
-                    int qty = (quantities)[i];
-
-                    if (qty > 0) {
-                        if (current_products[i].stock - qty <= 0) {
+                for (const auto &p : current_products) {
+                    auto it = quantities.find(p.product_id);
+                    if (it == quantities.end())
+                        continue;
 
-                            quantities[i] = 0;
-                            quantities_str[i] = "0";
+                    int qty = it->second;
 
-                            show_popup = 2;
-                            return;
-                        }
-
-                        Product &p = (current_products)[i];
-
-                        // 添加到购物车数据库中
-                        ctx.cart_manager.add_item((*ctx.current_user).id,
-                                                  p.product_id, qty);
-                        quantities[i] = 0;
-                        quantities_str[i] = "0";
+                    // 已加入的商品先清零，库存不足时之前的商品仍然有效
+                    quantities.erase(it);
+                    if (p.stock - qty <= 0) {
+                        sync_slot_quantities();
+                        show_popup = 2;
+                        return;
                     }
+
+                    // 添加到购物车数据库中
+                    ctx.store.add_to_cart((*ctx.current_user).id,
+                                          p.product_id, qty);
                 }
-                // 刷新购物车页面
-                add_cart();
+                // 购物车页面由变更事件（CART_CHANGED）触发刷新
+                sync_slot_quantities();
             }
         },
         ButtonOption::Animated(Color::Green));
@@ -103,9 +87,6 @@ void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     auto hint_popup_btn2 = Button("确定", [this] { show_popup = 0; });
     auto hint_popup_btn3 = Button("确定", [this] { show_popup = 0; });
 
-    // 首次构建列表内容
-    rebuild_product_list_ui(main_container);
-
     // 组装布局
     // 底部按钮栏
     auto btn_container =
@@ -115,7 +96,7 @@ void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     auto page_logic = Container::Vertical({
         Container::Horizontal(
             {search_input_logic | flex, btn_search}), // 顶部搜索栏
-        scroller | flex,                              // 中间列表
+        list_component | flex,                        // 中间列表
         btn_container                                 // 底部按钮
     });
 
@@ -149,10 +130,18 @@ void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
 
              // 列表区
              current_products.empty()
-                 ? (vbox({filler(), text("未找到匹配的商品") | center,
+                 ? (vbox({filler(),
+                          SharedComponents::list_placeholder_element(
+                              product_model.get_state(),
+                              text("未找到匹配的商品") | center),
                           filler()}) |
                     flex)
-                 : (scroller->Render() | flex),
+                 : (vbox({list_component->Render() | flex,
+                          text(product_model.is_loading()
+                                   ? "正在加载..."
+                                   : product_list->position_text()) |
+                              dim | align_right}) |
+                    flex),
 
              separator(),
 
@@ -177,128 +166,197 @@ void ShopLayOut::init_page(AppContext &ctx, std::function<void()> on_checkout,
     });
 }
 
-void ShopLayOut::rebuild_product_list_ui(Component main_container) {
-    main_container->DetachAllChildren(); // 清空旧列表
-
-    for (size_t i = 0; i < current_products.size(); ++i) {
-        //  定义数量输入框
-        // 1. 绑定到 quantities_str[i]
-        // 2. 使用 CatchEvent 监听输入，将字符串解析回 int
-        auto input_qty = Input(&quantities_str[i]);
-
-        // 为输入框添加逻辑：当用户输入时，更新 quantities[i] (int)
-        auto input_qty_logic =
-            CatchEvent(input_qty, [this, i, input_qty](Event event) {
-                // 让 Input 组件先处理字符输入
-                bool handled = input_qty->OnEvent(event);
-
-                // 数据同步逻辑: String -> Int
-                try {
-                    if (quantities_str[i].empty()) {
-                        quantities[i] = 0;
-                    } else {
-                        // 尝试转换，如果输入了非数字（如 abc），stoi 会抛出异常
-                        int val = std::stoi(quantities_str[i]);
-                        // 限制负数
-                        if (val < 0) {
-                            val = 0;
-                            quantities_str[i] = "0";
-                        }
-
-                        quantities[i] = val;
+void ShopLayOut::reset_product_list() {
+    quantities.clear();
+    product_list->reset(static_cast<int>(current_products.size()));
+}
+
+void ShopLayOut::reload(AppContext &ctx) { load_products(ctx, true); }
+
+void ShopLayOut::load_products(AppContext &ctx, const bool keep_window) {
+    product_model.load(
+        ctx.executor, ctx.post_to_ui,
+        // 工作线程：按发起时的搜索词查询
+        [&ctx, query = search_query] {
+            return ctx.store.fetch_products(query);
+        },
+        // UI 线程：数据仓库采用新的目录快照，列表持有同一快照
+        [this, &ctx, keep_window](ProductSearchResult &products) {
+            ctx.store.apply_products(products);
+            current_products = std::move(products);
+
+            if (!keep_window) {
+                reset_product_list();
+                return;
+            }
+
+            // 丢弃已不在列表中的商品的购买数量
+            std::unordered_set<int> product_ids;
+            for (const auto &p : current_products)
+                product_ids.insert(p.product_id);
+            for (auto it = quantities.begin(); it != quantities.end();) {
+                if (!product_ids.count(it->first))
+                    it = quantities.erase(it);
+                else
+                    ++it;
+            }
+
+            // 行组件原地复用，只更新数据总数
+            product_list->set_item_count(
+                static_cast<int>(current_products.size()));
+        });
+}
+
+void ShopLayOut::sync_slot_quantities() {
+    for (int slot = 0; slot < static_cast<int>(slot_quantities_str.size());
+         slot++) {
+        slot_quantities_str[slot] = std::to_string(get_slot_quantity(slot));
+    }
+}
+
+int ShopLayOut::get_slot_quantity(const int slot) const {
+    size_t i = product_list->index_of(slot);
+    if (i >= current_products.size())
+        return 0;
+
+    auto it = quantities.find(current_products[i].product_id);
+    return it != quantities.end() ? it->second : 0;
+}
+
+void ShopLayOut::set_slot_quantity(const int slot, const int qty) {
+    size_t i = product_list->index_of(slot);
+    if (i >= current_products.size())
+        return;
+
+    int product_id = current_products[i].product_id;
+    if (qty > 0)
+        quantities[product_id] = qty;
+    else
+        quantities.erase(product_id);
+}
+
+Component ShopLayOut::make_product_row(const int slot) {
+    //  定义数量输入框
+    // 1. 绑定到行槽位的文本 slot_quantities_str[slot]
+    // 2. 使用 CatchEvent 监听输入，将字符串解析回 int 并按商品 ID 保存
+    auto input_qty = Input(&slot_quantities_str[slot]);
+
+    // 为输入框添加逻辑：当用户输入时，更新该商品的购买数量
+    auto input_qty_logic =
+        CatchEvent(input_qty, [this, slot, input_qty](Event event) {
+            // 让 Input 组件先处理字符输入
+            bool handled = input_qty->OnEvent(event);
+            std::string &qty_str = slot_quantities_str[slot];
+
+            // 数据同步逻辑: String -> Int
+            try {
+                if (qty_str.empty()) {
+                    set_slot_quantity(slot, 0);
+                } else {
+                    // 尝试转换，如果输入了非数字（如 abc），stoi 会抛出异常
+                    int val = std::stoi(qty_str);
+                    // 限制负数
+                    if (val < 0) {
+                        val = 0;
+                        qty_str = "0";
                     }
-                } catch (...) {
-                    show_popup = 3; // 数量格式错误提示弹窗
-                    quantities[i] = 0;
-                    quantities_str[i] = "0";
-                }
-                return handled;
-            });
-
-        // "+" 按钮逻辑：同时更新 int 和 string
-        auto btn_inc = Button(
-            "+",
-            [this, i] {
-                quantities[i]++;
-                quantities_str[i] =
-                    std::to_string(quantities[i]); // 同步 string
-            },
-            ButtonOption::Ascii());
-
-        // "-" 按钮逻辑：同时更新 int 和 string
-        auto btn_dec = Button(
-            "-",
-            [this, i] {
-                if (quantities[i] > 0) {
-                    quantities[i]--;
-                    quantities_str[i] =
-                        std::to_string(quantities[i]); // 同步 string
+
+                    set_slot_quantity(slot, val);
                 }
-            },
-            ButtonOption::Ascii());
-
-        // 行布局
-        auto row_layout =
-            Container::Horizontal({btn_dec, input_qty_logic, btn_inc});
-        // 渲染每一行
-        auto row_renderer = Renderer(row_layout, [=] {
-            const auto &p = current_products[i]; // 获取当前商品
-            int qty = quantities[i];
-            bool is_focused = row_layout->Focused();
-
-            // 获焦及样式定义
-
-            // Input 获焦时的状态
-            bool input_focused = input_qty->Focused();
-
-            // 整个卡片获焦
-            Color border_c = is_focused ? Color::Cyan : Color::GrayDark;
-            Color bg_c =
-                is_focused ? Color::Grey23 : static_cast<Color>(Color::Default);
-            Color qty_c = qty > 0 ? Color::GreenLight : Color::GrayLight;
-
-            // 如果正在输入，高亮文字
-            if (input_focused)
-                qty_c = Color::White;
-
-            // 库存显示逻辑
-            Element stock_info;
-            if (p.stock <= 0)
-                stock_info = text("缺货") | color(Color::White);
-            else if (p.stock < 50)
-                stock_info = text("仅剩 " + std::to_string(p.stock) + " 件") |
-                             color(Color::RedLight);
-            else
-                stock_info = text("库存充足") | color(Color::YellowLight);
-
-            auto left =
-                vbox({filler(), text("商品") | color(Color::BlueLight),
-                      text(std::to_string(i + 1)) | dim | center, filler()}) |
-                size(WIDTH, EQUAL, 6);
-
-            auto right =
-                vbox({hbox({text(" " + std::string(p.product_name)) | bold |
-                                size(WIDTH, GREATER_THAN, 15) |
-                                color(Color::BlueLight),
-                            filler(), stock_info, filler(),
-                            text(Utils::format_price(p.price) + " 元") |
-                                color(Color::Gold1) | bold}),
-                      separator() | color(Color::GrayDark),
-                      hbox({
-                          text("购买数量: ") | color(Color::GrayLight),
-                          hbox({btn_dec->Render(),
-                                // 渲染输入框，限制宽度，居中
-                                input_qty->Render() | color(qty_c) | center |
-                                    size(WIDTH, EQUAL, 6),
-                                btn_inc->Render()}) |
-                              borderRounded,
-                      })}) |
-                flex;
-
-            return hbox({left, separator(), right}) | borderRounded |
-                   color(border_c) | bgcolor(bg_c);
+            } catch (...) {
+                show_popup = 3; // 数量格式错误提示弹窗
+                set_slot_quantity(slot, 0);
+                qty_str = "0";
+            }
+            return handled;
         });
 
-        main_container->Add(row_renderer);
-    }
+    // "+" 按钮逻辑：同时更新 int 和 string
+    auto btn_inc = Button(
+        "+",
+        [this, slot] {
+            int qty = get_slot_quantity(slot) + 1;
+            set_slot_quantity(slot, qty);
+            slot_quantities_str[slot] = std::to_string(qty); // 同步 string
+        },
+        ButtonOption::Ascii());
+
+    // "-" 按钮逻辑：同时更新 int 和 string
+    auto btn_dec = Button(
+        "-",
+        [this, slot] {
+            int qty = get_slot_quantity(slot);
+            if (qty > 0) {
+                qty--;
+                set_slot_quantity(slot, qty);
+                slot_quantities_str[slot] = std::to_string(qty); // 同步 string
+            }
+        },
+        ButtonOption::Ascii());
+
+    // 行布局
+    auto row_layout =
+        Container::Horizontal({btn_dec, input_qty_logic, btn_inc});
+    // 渲染每一行（内容由行槽位当前对应的商品决定）
+    return Renderer(row_layout, [=] {
+        size_t i = product_list->index_of(slot);
+        if (i >= current_products.size())
+            return emptyElement();
+
+        const auto &p = current_products[i]; // 获取当前商品
+        int qty = get_slot_quantity(slot);
+        bool is_focused = row_layout->Focused();
+
+        // 获焦及样式定义
+
+        // Input 获焦时的状态
+        bool input_focused = input_qty->Focused();
+
+        // 整个卡片获焦
+        Color border_c = is_focused ? Color::Cyan : Color::GrayDark;
+        Color bg_c =
+            is_focused ? Color::Grey23 : static_cast<Color>(Color::Default);
+        Color qty_c = qty > 0 ? Color::GreenLight : Color::GrayLight;
+
+        // 如果正在输入，高亮文字
+        if (input_focused)
+            qty_c = Color::White;
+
+        // 库存显示逻辑
+        Element stock_info;
+        if (p.stock <= 0)
+            stock_info = text("缺货") | color(Color::White);
+        else if (p.stock < 50)
+            stock_info = text("仅剩 " + std::to_string(p.stock) + " 件") |
+                         color(Color::RedLight);
+        else
+            stock_info = text("库存充足") | color(Color::YellowLight);
+
+        auto left =
+            vbox({filler(), text("商品") | color(Color::BlueLight),
+                  text(std::to_string(i + 1)) | dim | center, filler()}) |
+            size(WIDTH, EQUAL, 6);
+
+        auto right =
+            vbox({hbox({text(" " + std::string(p.product_name)) | bold |
+                            size(WIDTH, GREATER_THAN, 15) |
+                            color(Color::BlueLight),
+                        filler(), stock_info, filler(),
+                        text(Utils::format_price(p.price) + " 元") |
+                            color(Color::Gold1) | bold}),
+                  separator() | color(Color::GrayDark),
+                  hbox({
+                      text("购买数量: ") | color(Color::GrayLight),
+                      hbox({btn_dec->Render(),
+                            // 渲染输入框，限制宽度，居中
+                            input_qty->Render() | color(qty_c) | center |
+                                size(WIDTH, EQUAL, 6),
+                            btn_inc->Render()}) |
+                          borderRounded,
+                  })}) |
+            flex;
+
+        return hbox({left, separator(), right}) | borderRounded |
+               color(border_c) | bgcolor(bg_c);
+    });
 }
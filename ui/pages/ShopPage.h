@@ -1,27 +1,44 @@
 #include "AppContext.h"
+#include "AsyncPageModel.h"
+#include "VirtualList.h"
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <functional>
 #include <memory.h>
+#include <unordered_map>
 
 using namespace ftxui;
 
 class ShopLayOut {
   private:
-    // 存储用户购买商品数量
-    std::vector<int> quantities;
+    // 每个商品卡片占用的终端行数（用于计算行组件池大小）
+    static constexpr int PRODUCT_ROW_HEIGHT = 7;
 
-    // 存储数量输入框的文本内容
-    // (UI显示/输入用)
-    std::vector<std::string> quantities_str;
+    // 存储用户购买商品数量：商品 ID -> 数量
+    // 按商品 ID 存储，列表滚动复用行组件时不会丢失
+    std::unordered_map<int, int> quantities;
 
-    // 当前显示的商品列表
-    std::vector<Product> current_products;
+    // 行组件池中每个数量输入框的文本内容（按行槽位存储，UI显示/输入用），
+    // 窗口移动时从 quantities 同步
+    std::vector<std::string> slot_quantities_str;
+
+    // 当前显示的商品（引用目录快照，不拷贝商品）
+    ProductSearchResult current_products;
+
+    // 商品列表（只创建可见行的组件）
+    std::shared_ptr<VirtualList> product_list;
 
     // 搜索框的输入内容
     std::string search_query;
 
+    // 商品列表的后台加载
+    AsyncPageModel<ProductSearchResult> product_model;
+
+    // 辅助函数：在后台按当前搜索词加载商品，keep_window 为 false
+    // 时列表回到首行并清空购买数量（新的搜索），否则保持滚动位置（数据刷新）
+    void load_products(AppContext &ctx, const bool keep_window);
+
     Component component;
 
     // 弹窗 index
@@ -31,29 +48,30 @@ class ShopLayOut {
 
   public:
     // 构造体：创建商城页面组件，并通过接受购买结算函数跳转购物车页面
-    ShopLayOut(AppContext &ctx, std::function<void()> on_checkout,
-               std::function<void()> add_cart) {
-        init_page(ctx, on_checkout, add_cart);
+    ShopLayOut(AppContext &ctx, std::function<void()> on_checkout) {
+        init_page(ctx, on_checkout);
     }
 
     Component get_component() { return component; }
 
     // 渲染页面的主逻辑
-    void init_page(AppContext &ctx, std::function<void()> on_checkout,
-                   std::function<void()> add_cart);
-
-    // 辅助函数：根据当前类成员 current_products
-    // 重建 UI 列表
-    void rebuild_product_list_ui(Component list_container);
-
-    // 刷新页面
-    void refresh(AppContext &ctx, std::function<void()> on_checkout,
-                 std::function<void()> add_cart) {
-        // 清空容器，重置 vector 成员
-        component->DetachAllChildren();
-        quantities.clear();
-        quantities_str.clear();
-        show_popup = 0;
-        init_page(ctx, on_checkout, add_cart);
-    }
+    void init_page(AppContext &ctx, std::function<void()> on_checkout);
+
+    // 辅助函数：创建商品列表的某个行槽位组件
+    Component make_product_row(const int slot);
+
+    // 辅助函数：根据当前类成员 current_products 重置列表（清空购买数量）
+    void reset_product_list();
+
+    // 辅助函数：将行槽位的输入框文本与其当前对应商品的购买数量同步
+    void sync_slot_quantities();
+
+    // 辅助函数：获取某个行槽位对应商品的购买数量
+    int get_slot_quantity(const int slot) const;
+
+    // 辅助函数：设置某个行槽位对应商品的购买数量
+    void set_slot_quantity(const int slot, const int qty);
+
+    // 按当前搜索词在后台重新加载商品，保持滚动位置，并丢弃已下架商品的购买数量
+    void reload(AppContext &ctx);
 };
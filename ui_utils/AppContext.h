@@ -1,5 +1,7 @@
 #pragma once
 #include "CartManager.h"
+#include "DataStore.h"
+#include "Executor.h"
 #include "HistoryOrderManager.h"
 #include "OrderManager.h"
 #include "ProductManager.h"
@@ -13,6 +15,10 @@ struct AppContext {
     OrderManager order_manager;
     HistoryOrderManager history_order_manager;
 
+    // 数据仓库：页面共享的唯一一份商品、购物车与订单数据（须在各管理类之后声明）
+    DataStore store{product_manager, cart_manager, order_manager,
+                    history_order_manager};
+
     // 全局 UI 状态
     std::shared_ptr<User> current_user =
         nullptr; // 指向当前登入用户的指针，空则未登入
@@ -20,6 +26,14 @@ struct AppContext {
     // 回调函数，用来存放刷新屏幕的动作, 默认给个空实现
     std::function<void()> request_repaint = [] {};
 
+    // 把任务投递到 UI 线程执行（由 UI 设置为 screen.Post），默认直接执行
+    std::function<void(std::function<void()>)> post_to_ui =
+        [](std::function<void()> task) { task(); };
+
+    // 后台数据加载执行器（放在最后声明，析构时最先停止，
+    // 保证工作线程不会访问已销毁的管理类）
+    Executor executor;
+
     // 构造函数
     AppContext() = default;
 
@@ -0,0 +1,87 @@
+#pragma once
+#include "Executor.h"
+#include "Logger.h"
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+// 页面数据的加载状态
+enum class LoadState {
+    IDLE,    // 尚未加载
+    LOADING, // 正在后台加载
+    READY,   // 已加载
+    FAILED,  // 加载失败
+};
+
+// 异步页面模型：在后台线程读取数据，再把结果投递回 UI 线程应用
+// 每次 load 都会递增代数，晚于新请求返回的旧结果直接丢弃；
+// 模型（及所属页面）销毁后，尚在途中的结果也会被丢弃
+//
+// 线程约定：load、状态查询与 apply 都只在 UI 线程执行，
+// fetch 在工作线程执行，不能访问页面成员，只能使用按值捕获的参数
+template <typename T> class AsyncPageModel {
+  private:
+    // 只在 UI 线程读写，工作线程只持有其弱引用
+    struct Shared {
+        uint64_t generation = 0;
+        LoadState state = LoadState::IDLE;
+    };
+
+    std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+
+  public:
+    using PostFn = std::function<void(std::function<void()>)>;
+
+    AsyncPageModel() = default;
+    AsyncPageModel(const AsyncPageModel &) = delete;
+    AsyncPageModel &operator=(const AsyncPageModel &) = delete;
+
+    /**
+     * @brief 发起一次加载
+     *
+     * @param executor 执行 fetch 的后台执行器
+     * @param post 把任务投递回 UI 线程的函数
+     * @param fetch 在工作线程中读取数据
+     * @param apply 在 UI 线程中应用结果（仅当本次加载仍是最新一次时调用）
+     */
+    void load(Executor &executor, PostFn post, std::function<T()> fetch,
+              std::function<void(T &)> apply) {
+        uint64_t generation = ++shared->generation;
+        shared->state = LoadState::LOADING;
+
+        std::weak_ptr<Shared> weak = shared;
+        executor.submit([weak, generation, post = std::move(post),
+                         fetch = std::move(fetch),
+                         apply = std::move(apply)] {
+            auto result = std::make_shared<std::optional<T>>();
+            try {
+                *result = fetch();
+            } catch (const std::exception &e) {
+                LOG_ERROR("页面数据加载失败: " + std::string(e.what()));
+            }
+
+            post([weak, generation, result, apply] {
+                auto alive = weak.lock();
+                // 页面已销毁或已有更新的请求：丢弃过期结果
+                if (!alive || alive->generation != generation)
+                    return;
+
+                if (result->has_value()) {
+                    apply(**result);
+                    alive->state = LoadState::READY;
+                } else {
+                    alive->state = LoadState::FAILED;
+                }
+            });
+        });
+    }
+
+    LoadState get_state() const { return shared->state; }
+
+    bool is_loading() const { return shared->state == LoadState::LOADING; }
+
+    bool has_failed() const { return shared->state == LoadState::FAILED; }
+};
@@ -0,0 +1,265 @@
+#pragma once
+#include "AppContext.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// 监控面板的一次采样结果
+// 速率与分位数按最近 WINDOW 内的增量计算，其余为采样时刻的当前值
+struct PerfSnapshot {
+    bool has_window = false;      // 是否已有两次以上的采样（窗口指标有效）
+    double window_seconds = 0;    // 窗口实际覆盖的秒数
+    double db_qps = 0;            // SQL 语句每秒执行次数
+    double db_p50_ms = 0;         // SQL 语句耗时的中位数（毫秒）
+    double db_p99_ms = 0;         // SQL 语句耗时的 99 分位（毫秒）
+    uint64_t db_errors = 0;       // 窗口内失败的 SQL 语句数
+    CacheStats search_cache;      // 商品搜索缓存
+    CacheStats user_cache;        // 用户缓存
+    size_t catalog_bytes = 0;     // 商品目录快照估算占用的内存（字节）
+    double checkouts_per_min = 0; // 每分钟结账次数
+    double checkout_p99_ms = 0;   // 结账耗时的 99 分位（毫秒）
+    uint64_t checkouts_total = 0; // 累计结账次数
+    double ui_frame_p99_ms = 0;   // 界面一帧耗时的 99 分位（毫秒）
+    LoggerStats log;              // 日志写入统计
+    double log_lines_per_sec = 0; // 每秒写出的日志条数
+
+    // 待送达订单积压（尚未统计或查询失败时为空）
+    std::optional<ArrivalBacklog> arrivals;
+    std::chrono::steady_clock::time_point arrivals_at; // 积压的统计时刻
+};
+
+// 管理员监控面板的采样器
+// 采样线程按 INTERVAL 读取指标注册表、缓存与日志的计数（均为内存中的
+// 原子量，不访问数据库），算好后保存一份快照；界面渲染时只复制快照。
+// 待送达订单的积压需要查询数据库，仅在详情页可见时按 ARRIVALS_INTERVAL
+// 提交到后台执行器统计，不在采样线程或渲染路径上查询
+class PerfMonitor {
+  public:
+    static constexpr std::chrono::seconds INTERVAL{1};
+    static constexpr std::chrono::seconds WINDOW{10};
+    static constexpr std::chrono::seconds ARRIVALS_INTERVAL{15};
+
+  private:
+    // 一次采样时读取的累计值
+    struct Reading {
+        std::chrono::steady_clock::time_point at;
+        Metrics::HistogramSnapshot db;
+        uint64_t db_errors = 0;
+        Metrics::HistogramSnapshot checkout;
+        Metrics::HistogramSnapshot ui_frame;
+        uint64_t log_lines = 0;
+    };
+
+    // 积压统计的结果，后台任务只持有它的共享指针，
+    // 监控器销毁后仍在途中的任务不会访问已销毁的对象
+    struct ArrivalsSlot {
+        std::mutex mtx;
+        std::optional<ArrivalBacklog> value;
+        std::chrono::steady_clock::time_point at;
+        bool in_flight = false;
+    };
+
+    AppContext &ctx;
+
+    // 采样所读的指标（与记录处同名同标签，注册表返回同一个指标）
+    std::vector<Metrics::Histogram *> db_seconds;
+    std::vector<Metrics::Counter *> db_errors;
+    Metrics::Histogram *checkout_seconds = nullptr;
+    Metrics::Histogram *ui_frame_seconds = nullptr;
+
+    // 只在采样线程访问
+    std::deque<Reading> history;
+    std::chrono::steady_clock::time_point arrivals_requested;
+
+    std::shared_ptr<ArrivalsSlot> arrivals =
+        std::make_shared<ArrivalsSlot>();
+
+    mutable std::mutex snapshot_mtx;
+    PerfSnapshot latest;
+
+    std::atomic<bool> visible{false};         // 面板可见时才请求重绘
+    std::atomic<bool> arrivals_enabled{false}; // 详情页可见时才统计积压
+    std::atomic<bool> arrivals_refresh{false}; // 下次采样时立即统计积压
+
+    // 采样线程及其停止信号
+    std::thread sampler;
+    std::mutex sampler_mtx;
+    std::condition_variable sampler_cv;
+    bool running = false;
+
+    Reading read() const {
+        Reading reading;
+        reading.at = std::chrono::steady_clock::now();
+        for (const auto *histogram : db_seconds)
+            reading.db.merge(histogram->snapshot());
+        for (const auto *counter : db_errors)
+            reading.db_errors += counter->value();
+        reading.checkout = checkout_seconds->snapshot();
+        reading.ui_frame = ui_frame_seconds->snapshot();
+        reading.log_lines = Logger::get_instance().get_stats().lines;
+        return reading;
+    }
+
+    // 积压统计到期且详情页可见时，提交一次后台查询
+    void request_arrivals(const std::chrono::steady_clock::time_point now) {
+        if (!arrivals_enabled)
+            return;
+        bool due = arrivals_refresh.exchange(false) ||
+                   now - arrivals_requested >= ARRIVALS_INTERVAL;
+        if (!due)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(arrivals->mtx);
+            if (arrivals->in_flight)
+                return;
+            arrivals->in_flight = true;
+        }
+        arrivals_requested = now;
+
+        std::shared_ptr<ArrivalsSlot> slot = arrivals;
+        OrderManager &order_manager = ctx.order_manager;
+        ctx.executor.submit([slot, &order_manager] {
+            auto backlog = order_manager.count_pending_arrivals();
+            std::lock_guard<std::mutex> lock(slot->mtx);
+            if (backlog) {
+                slot->value = backlog;
+                slot->at = std::chrono::steady_clock::now();
+            }
+            slot->in_flight = false;
+        });
+    }
+
+    void sample() {
+        const auto &bounds = Metrics::latency_buckets();
+
+        history.push_back(read());
+        while (history.size() > 1 &&
+               history.back().at - history[1].at >= WINDOW)
+            history.pop_front();
+
+        const Reading &now = history.back();
+        const Reading &old = history.front();
+
+        PerfSnapshot snapshot;
+        double seconds = std::chrono::duration<double>(now.at - old.at).count();
+        if (history.size() > 1 && seconds > 0) {
+            auto db = now.db.since(old.db);
+            auto checkout = now.checkout.since(old.checkout);
+            auto ui_frame = now.ui_frame.since(old.ui_frame);
+
+            snapshot.has_window = true;
+            snapshot.window_seconds = seconds;
+            snapshot.db_qps = db.count / seconds;
+            snapshot.db_p50_ms = db.quantile(bounds, 0.5) * 1000;
+            snapshot.db_p99_ms = db.quantile(bounds, 0.99) * 1000;
+            snapshot.db_errors = now.db_errors - old.db_errors;
+            snapshot.checkouts_per_min = checkout.count * 60 / seconds;
+            snapshot.checkout_p99_ms = checkout.quantile(bounds, 0.99) * 1000;
+            snapshot.ui_frame_p99_ms = ui_frame.quantile(bounds, 0.99) * 1000;
+            snapshot.log_lines_per_sec =
+                (now.log_lines - old.log_lines) / seconds;
+        }
+
+        snapshot.checkouts_total = now.checkout.count;
+        snapshot.search_cache = ctx.product_manager.get_search_cache_stats();
+        snapshot.user_cache = ctx.user_manager.get_cache_stats();
+        snapshot.catalog_bytes = ctx.product_manager.get_catalog_bytes();
+        snapshot.log = Logger::get_instance().get_stats();
+
+        request_arrivals(now.at);
+        {
+            std::lock_guard<std::mutex> lock(arrivals->mtx);
+            snapshot.arrivals = arrivals->value;
+            snapshot.arrivals_at = arrivals->at;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mtx);
+            latest = std::move(snapshot);
+        }
+
+        if (visible)
+            ctx.request_repaint();
+    }
+
+  public:
+    explicit PerfMonitor(AppContext &context) : ctx(context) {
+        auto &registry = Metrics::Registry::get_instance();
+        for (const char *op : {"execute", "query", "statement"}) {
+            db_seconds.push_back(&registry.histogram(
+                "shopping_db_statement_seconds", "SQL 语句的执行耗时",
+                {{"op", op}}));
+            db_errors.push_back(&registry.counter(
+                "shopping_db_statement_errors_total", "执行失败的 SQL 语句数",
+                {{"op", op}}));
+        }
+        checkout_seconds = &registry.histogram(
+            "shopping_checkout_seconds", "结账（扣库存、生成订单）的耗时",
+            {{"source", "app"}});
+        ui_frame_seconds = &registry.histogram(
+            "shopping_ui_frame_seconds", "界面构建一帧元素树的耗时");
+    }
+
+    PerfMonitor(const PerfMonitor &) = delete;
+    PerfMonitor &operator=(const PerfMonitor &) = delete;
+
+    ~PerfMonitor() { stop(); }
+
+    // 面板（仪表盘或详情页）是否可见：不可见时照常采样，但不请求重绘
+    void set_visible(const bool value) { visible = value; }
+
+    // 详情页是否可见：可见时才定期统计待送达订单的积压（立即统计一次）
+    void set_arrivals_enabled(const bool value) {
+        if (value && !arrivals_enabled)
+            arrivals_refresh = true;
+        arrivals_enabled = value;
+    }
+
+    // 最近一次采样的快照（渲染时调用，只复制不计算）
+    PerfSnapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(snapshot_mtx);
+        return latest;
+    }
+
+    // 启动采样线程：立即采样一次，之后每隔 INTERVAL 采样
+    void start() {
+        {
+            std::lock_guard<std::mutex> lock(sampler_mtx);
+            if (running)
+                return;
+            running = true;
+        }
+
+        sampler = std::thread([this] {
+            std::unique_lock<std::mutex> lock(sampler_mtx);
+            while (running) {
+                lock.unlock();
+                sample();
+                lock.lock();
+                if (sampler_cv.wait_for(lock, INTERVAL,
+                                        [this] { return !running; }))
+                    break;
+            }
+        });
+    }
+
+    // 停止采样线程（立即唤醒，无需等待下一次采样）
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(sampler_mtx);
+            running = false;
+        }
+        sampler_cv.notify_all();
+        if (sampler.joinable())
+            sampler.join();
+    }
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// 可以被单独标记为需要重绘 / 重建的界面区域
+enum RenderRegion : unsigned int {
+    HEADER_CLOCK = 1u << 0,       // 导航栏时钟
+    SHOP_PAGE = 1u << 1,          // 商城页
+    CART_PAGE = 1u << 2,          // 购物车页
+    ORDER_PAGE = 1u << 3,         // 当前订单页
+    HISTORY_ORDER_PAGE = 1u << 4, // 历史订单页
+};
+
+// 脏区域调度器：记录哪些区域需要更新，并合并重绘请求
+// 时钟线程只在导航栏可见时按整秒标记时钟区域，空闲时不再触发任何重绘
+class RenderScheduler {
+  private:
+    // 已标记为脏的区域（RenderRegion 的位掩码）
+    std::atomic<unsigned int> dirty_mask{0};
+
+    // 是否已有尚未处理的重绘请求，用于合并多次标记
+    std::atomic<bool> repaint_pending{false};
+
+    // 导航栏（时钟）当前是否可见
+    std::atomic<bool> header_visible{false};
+
+    // 实际发起重绘的动作（例如向 ScreenInteractive 投递事件）
+    std::function<void()> post_repaint = [] {};
+
+    // 时钟线程及其停止信号
+    std::thread clock_thread;
+    std::mutex clock_mtx;
+    std::condition_variable clock_cv;
+    bool clock_running = false;
+
+  public:
+    RenderScheduler() = default;
+    RenderScheduler(const RenderScheduler &) = delete;
+    RenderScheduler &operator=(const RenderScheduler &) = delete;
+
+    ~RenderScheduler() { stop_clock(); }
+
+    // 设置发起重绘的动作（需在 start_clock 之前调用）
+    void set_post_repaint(std::function<void()> post) {
+        post_repaint = std::move(post);
+    }
+
+    // 标记区域为脏，并请求一次重绘（已有未处理的请求时不重复投递）
+    void invalidate(const unsigned int regions) {
+        dirty_mask.fetch_or(regions);
+        if (!repaint_pending.exchange(true))
+            post_repaint();
+    }
+
+    // 帧开始时调用：允许之后的标记再次投递重绘请求
+    void begin_frame() { repaint_pending = false; }
+
+    // 检查区域是否为脏并清除标记
+    bool consume(const unsigned int region) {
+        return (dirty_mask.fetch_and(~region) & region) != 0;
+    }
+
+    // 只检查不清除
+    bool is_dirty(const unsigned int region) const {
+        return (dirty_mask.load() & region) != 0;
+    }
+
+    void set_header_visible(const bool visible) { header_visible = visible; }
+
+    // 启动时钟线程：每到整秒时，若导航栏可见则标记时钟区域
+    void start_clock() {
+        {
+            std::lock_guard<std::mutex> lock(clock_mtx);
+            if (clock_running)
+                return;
+            clock_running = true;
+        }
+
+        clock_thread = std::thread([this] {
+            using clock = std::chrono::system_clock;
+            std::unique_lock<std::mutex> lock(clock_mtx);
+            while (clock_running) {
+                // 对齐到下一个整秒，使时钟显示与系统时间同步跳动
+                auto next_second = std::chrono::time_point_cast<
+                                       std::chrono::seconds>(clock::now()) +
+                                   std::chrono::seconds(1);
+                if (clock_cv.wait_until(lock, next_second,
+                                        [this] { return !clock_running; }))
+                    break;
+
+                if (header_visible)
+                    invalidate(HEADER_CLOCK);
+            }
+        });
+    }
+
+    // 停止时钟线程（立即唤醒，无需等待下一秒）
+    void stop_clock() {
+        {
+            std::lock_guard<std::mutex> lock(clock_mtx);
+            clock_running = false;
+        }
+        clock_cv.notify_all();
+        if (clock_thread.joinable())
+            clock_thread.join();
+    }
+};
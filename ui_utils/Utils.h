@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include <cstddef>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
@@ -15,6 +16,22 @@ inline std::string format_price(double price) {
     return ss.str();
 }
 
+// 按固定小数位数格式化（监控面板的速率、耗时等）
+inline std::string format_fixed(double value, int digits = 1) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(digits) << value;
+    return ss.str();
+}
+
+// 以 B / KB / MB 为单位格式化字节数
+inline std::string format_bytes(size_t bytes) {
+    if (bytes < 1024)
+        return std::to_string(bytes) + " B";
+    if (bytes < 1024 * 1024)
+        return format_fixed(bytes / 1024.0) + " KB";
+    return format_fixed(bytes / (1024.0 * 1024.0)) + " MB";
+}
+
 inline std::string get_current_time() {
     auto now = std::chrono::system_clock::now();
     auto in_time_t = std::chrono::system_clock::to_time_t(now);